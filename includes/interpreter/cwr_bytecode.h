@@ -0,0 +1,152 @@
+#ifndef CWR_BYTECODE_H
+#define CWR_BYTECODE_H
+
+#include <stdint.h>
+#include <cwr_instance.h>
+#include <cwr_walker.h>
+#include <cwr_interpreter_error.h>
+
+// Operands are 16 bit, so a function can't use more registers
+#define CWR_BYTECODE_MAX_REGISTERS UINT16_MAX
+
+typedef enum cwr_instruction_type
+{
+    // a = b, arrays are shared without taking a reference like variables in the tree walker
+    cwr_instruction_move_type,
+    // a = new array from the string literal at expression 'index'
+    cwr_instruction_load_string_type,
+    // a = b op c with the kernel picked from the values like 'cwr_tagged_value_apply'. Each one is followed by
+    // its integer and float kernels, which the compiler picks from the node and which fall back to it for other values
+    cwr_instruction_add_type,
+    cwr_instruction_add_integer_type,
+    cwr_instruction_add_float_type,
+    cwr_instruction_subtract_type,
+    cwr_instruction_subtract_integer_type,
+    cwr_instruction_subtract_float_type,
+    cwr_instruction_multiply_type,
+    cwr_instruction_multiply_integer_type,
+    cwr_instruction_multiply_float_type,
+    cwr_instruction_divide_type,
+    cwr_instruction_divide_integer_type,
+    cwr_instruction_divide_float_type,
+    cwr_instruction_equals_type,
+    cwr_instruction_equals_integer_type,
+    cwr_instruction_equals_float_type,
+    cwr_instruction_not_equals_type,
+    cwr_instruction_not_equals_integer_type,
+    cwr_instruction_not_equals_float_type,
+    cwr_instruction_greater_type,
+    cwr_instruction_greater_integer_type,
+    cwr_instruction_greater_float_type,
+    cwr_instruction_less_type,
+    cwr_instruction_less_integer_type,
+    cwr_instruction_less_float_type,
+    cwr_instruction_greater_equals_type,
+    cwr_instruction_greater_equals_integer_type,
+    cwr_instruction_greater_equals_float_type,
+    cwr_instruction_less_equals_type,
+    cwr_instruction_less_equals_integer_type,
+    cwr_instruction_less_equals_float_type,
+    // a = 0 typed by b and c, operators without arithmetic meaning
+    cwr_instruction_zero_type,
+    // a = op b, c is the kernel of the node
+    cwr_instruction_negate_type,
+    cwr_instruction_not_type,
+    cwr_instruction_reference_type,
+    cwr_instruction_dereference_type,
+    // a = element c of array b
+    cwr_instruction_element_type,
+    cwr_instruction_jump_type,
+    // Jumps to 'index' when a is zero
+    cwr_instruction_jump_false_type,
+    // Jumps to 'index' of the next instruction unless 'b op c', the pair is one fused compare and branch.
+    // Followed by integer and float kernels like the arithmetic instructions
+    cwr_instruction_jump_not_equals_type,
+    cwr_instruction_jump_not_equals_integer_type,
+    cwr_instruction_jump_not_equals_float_type,
+    cwr_instruction_jump_not_not_equals_type,
+    cwr_instruction_jump_not_not_equals_integer_type,
+    cwr_instruction_jump_not_not_equals_float_type,
+    cwr_instruction_jump_not_greater_type,
+    cwr_instruction_jump_not_greater_integer_type,
+    cwr_instruction_jump_not_greater_float_type,
+    cwr_instruction_jump_not_less_type,
+    cwr_instruction_jump_not_less_integer_type,
+    cwr_instruction_jump_not_less_float_type,
+    cwr_instruction_jump_not_greater_equals_type,
+    cwr_instruction_jump_not_greater_equals_integer_type,
+    cwr_instruction_jump_not_greater_equals_float_type,
+    cwr_instruction_jump_not_less_equals_type,
+    cwr_instruction_jump_not_less_equals_integer_type,
+    cwr_instruction_jump_not_less_equals_float_type,
+    // Slot a = b, takes a reference to b and drops the previous value of a
+    cwr_instruction_store_type,
+    // Value referenced by pointer a = b
+    cwr_instruction_store_dereference_type,
+    // Frees a when it is an array nothing refers to
+    cwr_instruction_release_type,
+    // Calls 'index' call site with arguments from a, the result is left in a
+    cwr_instruction_call_type,
+    // Same as call, but a script callee takes the frame of the caller and returns to its caller
+    cwr_instruction_tail_call_type,
+    cwr_instruction_return_type,
+    cwr_instruction_return_none_type,
+    // Raises unknown expression error
+    cwr_instruction_fail_type
+} cwr_instruction_type;
+
+typedef struct cwr_instruction
+{
+    uint16_t type;
+    // Destination or the only operand
+    uint16_t a;
+
+    union
+    {
+        struct
+        {
+            uint16_t b;
+            uint16_t c;
+        };
+
+        // Jump target, call site or expression
+        uint32_t index;
+    };
+} cwr_instruction;
+
+typedef struct cwr_bytecode_call
+{
+    size_t function;
+    uint16_t count;
+    cwr_location location;
+} cwr_bytecode_call;
+
+// Registers of a frame are the slots of the function, then its constants, then temporaries.
+// Arguments are evaluated into the first temporaries of the caller, which become the first slots of the callee
+typedef struct cwr_bytecode_function
+{
+    cwr_instruction *instructions;
+    // Reported by runtime errors, one for each instruction
+    cwr_location *locations;
+    size_t size;
+    size_t capacity;
+    cwr_bytecode_call *calls;
+    size_t calls_size;
+    size_t calls_capacity;
+    // Copied after the slots on every call
+    cwr_tagged_value *constants;
+    size_t constants_size;
+    size_t constants_capacity;
+    size_t arguments_count;
+    size_t frame_size;
+    size_t registers;
+    // Some slot holds arrays, so the frame has references to drop
+    bool with_references;
+} cwr_bytecode_function;
+
+// Compiles the parsed body of 'instance', the walker is only used for the duration of the call
+cwr_bytecode_function *cwr_bytecode_compile(cwr_walker *walker, const cwr_expression_pool *pool, cwr_function_instance instance, cwr_location location, cwr_interpreter_error *error);
+
+void cwr_bytecode_function_destroy(cwr_bytecode_function *function);
+
+#endif // CWR_BYTECODE_H
\ No newline at end of file
@@ -9,12 +9,13 @@
 typedef struct cwr_func_call_context
 {
     cwr_program_context context;
-    cwr_value **arguments;
+    cwr_tagged_value *arguments;
     size_t count;
     cwr_location location;
 } cwr_func_call_context;
 
-typedef cwr_value *(*cwr_function_instance_bind)(cwr_func_call_context context);
+// Arguments are borrowed from the caller, who releases them after the call, so bound functions must not keep them
+typedef cwr_tagged_value (*cwr_function_instance_bind)(cwr_func_call_context context);
 
 typedef enum cwr_instance_type
 {
@@ -33,6 +34,9 @@ typedef struct cwr_function_instance
     cwr_function_instance_type type;
     cwr_argument *arguments;
     size_t count;
+    size_t frame_size;
+    // Body is parsed on the first call
+    bool is_lazy;
 
     union
     {
@@ -43,8 +47,9 @@ typedef struct cwr_function_instance
 
 typedef struct cwr_variable_instance
 {
-    cwr_expression_type_value type;
-    cwr_value *value;
+    const cwr_expression_type_value *type;
+    // Holds a reference when it is an array or a pointer, zeroed until declared
+    cwr_tagged_value value;
 } cwr_variable_instance;
 
 typedef struct cwr_instance
@@ -81,32 +86,20 @@ static bool cwr_instance_can_access(cwr_instance instance, cwr_func_body_express
     return true;
 }
 
-static void cwr_func_call_context_destroy(cwr_func_call_context context)
+static void cwr_variable_instance_destroy(cwr_slab *slab, cwr_instance instance)
 {
-    cwr_value **arguments = context.arguments;
-
-    if (context.count > 0)
+    if (cwr_tagged_value_is_reference(&instance.variable.value))
     {
-        for (size_t i = 0; i < context.count; i++)
-        {
-            cwr_value_runtime_destroy(arguments[i]);
-        }
-
-        free(arguments);
+        cwr_value_instance_destroy(slab, instance.variable.value.value);
     }
 }
 
-static void cwr_variable_instance_destroy(cwr_instance instance)
-{
-    cwr_value_instance_destroy(instance.variable.value);
-}
-
-static void cwr_instance_destroy(cwr_instance instance)
+static void cwr_instance_destroy(cwr_slab *slab, cwr_instance instance)
 {
     switch (instance.type)
     {
     case cwr_instance_variable_type:
-        cwr_variable_instance_destroy(instance);
+        cwr_variable_instance_destroy(slab, instance);
         break;
     case cwr_instance_function_type:
         break;
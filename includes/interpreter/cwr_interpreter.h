@@ -6,31 +6,72 @@
 #include <cwr_value.h>
 #include <cwr_parser.h>
 #include <cwr_interpreter_error.h>
+#include <cwr_machine.h>
 
 #define CWR_INTERPRETER_ENTRY_POINT_FUNC "main" 
+// Frames are on the heap, so this only bounds memory
+#define CWR_INTERPRETER_DEFAULT_MAX_DEPTH (1 << 18)
+// Bytes the tree walker keeps free below its nesting of calls and operands
+#define CWR_INTERPRETER_DEFAULT_NATIVE_STACK_RESERVE (64 * 1024)
 
 typedef struct cwr_interpreter cwr_interpreter;
 
+typedef enum cwr_interpreter_engine_type
+{
+    // Walks the parser result, nesting on the native stack
+    cwr_interpreter_engine_tree_type,
+    // Compiles functions to bytecode on their first call and runs them in 'cwr_machine'
+    cwr_interpreter_engine_bytecode_type
+} cwr_interpreter_engine_type;
+
+typedef struct cwr_interpreter_configuration
+{
+    cwr_interpreter_engine_type engine;
+    // Deeper calls fail with a stack overflow error
+    size_t max_depth;
+    // Native stack bytes the tree walker keeps free
+    size_t native_stack_reserve;
+} cwr_interpreter_configuration;
+
+static cwr_interpreter_configuration cwr_interpreter_configuration_default()
+{
+    return (cwr_interpreter_configuration){
+        .engine = cwr_interpreter_engine_bytecode_type,
+        .max_depth = CWR_INTERPRETER_DEFAULT_MAX_DEPTH,
+        .native_stack_reserve = CWR_INTERPRETER_DEFAULT_NATIVE_STACK_RESERVE};
+}
+
 typedef struct cwr_interpreter_result {
     cwr_parser_result source;
     cwr_program_context context;
+    // NULL when the tree walker runs the program
+    cwr_machine* machine;
 } cwr_interpreter_result;
 
-cwr_interpreter* cwr_intepreter_create(cwr_parser_result result);
+cwr_interpreter* cwr_intepreter_create(cwr_parser_result result, cwr_interpreter_configuration* configuration);
 
 cwr_interpreter_result cwr_intepreter_interpret(cwr_interpreter* interpreter, cwr_interpreter_error* error);
 
+// Returns a new value or NULL when the entry point returned nothing
 cwr_value* cwr_interpreter_evaluate_entry_point(cwr_interpreter_result result, cwr_interpreter_error* error);
 
-cwr_value* cwr_intepreter_evaluate_stat(cwr_program_context program_context, cwr_statement statement, cwr_func_body_expression* root, cwr_interpreter_error* error);
+// Parses the body of a function skipped by a lazy parser and keeps it in the instance
+void cwr_intepreter_load_function(cwr_program_context program_context, cwr_instance* function, cwr_interpreter_error* error);
+
+// True when a return ran in 'statement', the returned value is left in 'result'
+bool cwr_intepreter_evaluate_stat(cwr_program_context program_context, const cwr_statement* statement, size_t frame, cwr_tagged_value* result, cwr_interpreter_error* error);
 
-cwr_value* cwr_intepreter_evaluate_stat_func_call(cwr_program_context program_context, cwr_func_call_statement statement, cwr_func_body_expression* root, cwr_location location, cwr_interpreter_error* error);
+// Nodes are borrowed from the parser result and never copied or written, so one tree can back several interpreters.
+// Quickened binary nodes are kept in the quickening of the context
+cwr_tagged_value cwr_intepreter_evaluate_stat_func_call(cwr_program_context program_context, const cwr_func_call_statement* statement, size_t frame, cwr_location location, cwr_interpreter_error* error);
 
-cwr_value* cwr_intepreter_evaluate_func(cwr_function_instance instance, cwr_func_call_context context, cwr_interpreter_error* error);
+// Runs 'instance' in 'frame', the top one of the stack with the arguments in its first slots, and pops it
+cwr_tagged_value cwr_intepreter_evaluate_func(const cwr_function_instance* instance, cwr_func_call_context context, size_t frame, cwr_interpreter_error* error);
 
-cwr_value* cwr_intepreter_evaluate_expr(cwr_program_context program_context, cwr_expression expression, cwr_func_body_expression* root, cwr_interpreter_error* error);
+// Scalars are returned by value, arrays and pointers are shared with their owner or are temporaries to release
+cwr_tagged_value cwr_intepreter_evaluate_expr(cwr_program_context program_context, cwr_expression_index expression, size_t frame, cwr_interpreter_error* error);
 
-cwr_value* cwr_intepreter_evaluate_expr_body(cwr_program_context program_context, cwr_func_body_expression expression, cwr_func_body_expression* root, cwr_interpreter_error* error);
+bool cwr_intepreter_evaluate_expr_body(cwr_program_context program_context, const cwr_func_body_expression* expression, size_t frame, cwr_tagged_value* result, cwr_interpreter_error* error);
 
 void cwr_interpreter_result_destroy(cwr_interpreter_result result);
 
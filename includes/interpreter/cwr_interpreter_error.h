@@ -12,7 +12,11 @@ typedef enum cwr_interpreter_error_type
     cwr_interpreter_error_index_out_of_range_type,
     cwr_interpreter_error_division_by_zero_type,
     cwr_interpreter_error_unknown_statement_type,
-    cwr_interpreter_error_unknown_expression_type
+    cwr_interpreter_error_unknown_expression_type,
+    // Calls nested deeper than the depth the interpreter was configured with
+    cwr_interpreter_error_stack_overflow_type,
+    // Error in a function body parsed lazily on its first call
+    cwr_interpreter_error_parser_type
 } cwr_interpreter_error_type;
 
 typedef struct cwr_interpreter_error
@@ -38,4 +42,9 @@ static void cwr_interpreter_error_throw_out_of_memory(cwr_interpreter_error *err
     cwr_interpreter_error_throw(error, cwr_interpreter_error_out_of_memory_type, "Out of memory", location);
 }
 
+static void cwr_interpreter_error_throw_stack_overflow(cwr_interpreter_error *error, cwr_location location)
+{
+    cwr_interpreter_error_throw(error, cwr_interpreter_error_stack_overflow_type, "Stack overflow", location);
+}
+
 #endif // CWR_INTERPRETER_ERROR_H
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef CWR_MACHINE_H
+#define CWR_MACHINE_H
+
+#include <cwr_bytecode.h>
+#include <cwr_program_context.h>
+
+// Runs functions compiled by 'cwr_bytecode_compile', each one is compiled on its first call.
+// Frames live in one growable register file, so script calls don't recurse on the C stack
+typedef struct cwr_machine cwr_machine;
+
+// Calls nested deeper than 'max_depth' frames fail with a stack overflow error
+cwr_machine *cwr_machine_create(cwr_program_context context, size_t max_depth);
+
+// Calls user function 'function' without arguments, returns a new value or NULL when it returned nothing
+cwr_value *cwr_machine_run(cwr_machine *machine, cwr_instance *function, cwr_interpreter_error *error);
+
+void cwr_machine_destroy(cwr_machine *machine);
+
+#endif // CWR_MACHINE_H
\ No newline at end of file
@@ -4,7 +4,15 @@
 typedef struct cwr_program_context
 {
     struct cwr_scope *functions;
-    struct cwr_scope *variables;
+    // Frames of the functions the tree walker is running
+    struct cwr_stack *stack;
+    // Binary nodes the tree walker quickened, the pool itself is only read
+    struct cwr_quickening *quickening;
+    // Values and their elements, freed with the context
+    struct cwr_slab *slab;
+    const struct cwr_expression_pool *pool;
+    // Bodies skipped by a lazy parser, NULL when every body was parsed
+    struct cwr_parser_lazy *lazy;
 } cwr_program_context;
 
 cwr_program_context cwr_program_context_default();
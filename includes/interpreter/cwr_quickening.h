@@ -0,0 +1,55 @@
+#ifndef CWR_QUICKENING_H
+#define CWR_QUICKENING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef enum cwr_quickened_type
+{
+    // Not run yet
+    cwr_quickened_none_type,
+    // Ran, but its operands or kernel can not be quickened
+    cwr_quickened_generic_type,
+    // A local and a literal of the kernel type, the integer kernel takes 'integer_n'
+    cwr_quickened_slot_constant_type,
+    // Two locals
+    cwr_quickened_slots_type
+} cwr_quickened_type;
+
+// Binary node of the tree walker specialized after its first run, operator and kernel are the ones of the node
+typedef struct cwr_quickened_expression
+{
+    uint16_t type;
+    uint16_t operator;
+    uint16_t kernel;
+    int slots[2];
+
+    union
+    {
+        int integer_n;
+        float float_n;
+    };
+} cwr_quickened_expression;
+
+// Quickened nodes by expression index, kept beside the pool so the tree stays as the parser left it
+typedef struct cwr_quickening
+{
+    cwr_quickened_expression *expressions;
+    size_t size;
+} cwr_quickening;
+
+cwr_quickening *cwr_quickening_create();
+
+// False when out of memory, the node then just stays unquickened
+bool cwr_quickening_set(cwr_quickening *quickening, size_t index, cwr_quickened_expression expression);
+
+// NULL for nodes that never ran
+static inline const cwr_quickened_expression *cwr_quickening_get(const cwr_quickening *quickening, size_t index)
+{
+    return index < quickening->size && quickening->expressions[index].type != cwr_quickened_none_type ? &quickening->expressions[index] : NULL;
+}
+
+void cwr_quickening_destroy(cwr_quickening *quickening);
+
+#endif // CWR_QUICKENING_H
\ No newline at end of file
@@ -8,16 +8,18 @@
 
 typedef struct cwr_scope cwr_scope;
 
-cwr_scope *cwr_scope_create();
+// Values of variables are freed to 'slab'
+cwr_scope *cwr_scope_create(cwr_slab *slab);
 
 bool cwr_scope_add(cwr_scope *scope, cwr_instance instance);
 
-cwr_instance *cwr_scope_get(cwr_scope *scope, cwr_func_body_expression *root, size_t identifier);
+// Replaces the instance at 'position' and releases the value of the replaced variable, grows the scope when needed
+bool cwr_scope_set(cwr_scope *scope, size_t position, cwr_instance instance);
+
+cwr_instance *cwr_scope_at(cwr_scope *scope, size_t position);
 
 cwr_instance *cwr_scope_get_by_name(cwr_scope *scope, cwr_func_body_expression *root, char *name);
 
 void cwr_scope_destroy(cwr_scope *scope);
 
-void cwr_scope_root_destroy(cwr_scope *scope, cwr_func_body_expression *root);
-
 #endif // CWR_SCOPE_H
\ No newline at end of file
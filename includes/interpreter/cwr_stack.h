@@ -0,0 +1,49 @@
+#ifndef CWR_STACK_H
+#define CWR_STACK_H
+
+#include <stdint.h>
+#include <cwr_value.h>
+#include <cwr_slab.h>
+
+// Frames of the tree walker, each a run of slots where variables are at its base + their slot
+typedef struct cwr_stack
+{
+    // Zeroed slots are variables not declared yet
+    cwr_tagged_value *slots;
+    size_t size;
+    size_t capacity;
+    // Base of every frame, the top one last
+    size_t *frames;
+    size_t frames_size;
+    size_t frames_capacity;
+    // Array values held by slots are freed to it
+    cwr_slab *slab;
+    // Function a tail call left to run in the top frame, -1 when there is none
+    int tail_call;
+    // Most frames at once, checked before every call
+    size_t max_depth;
+    // Native stack bytes kept free
+    size_t native_reserve;
+    // Lowest native address the walker nests to, 0 when unchecked
+    uintptr_t native_limit;
+} cwr_stack;
+
+cwr_stack *cwr_stack_create(cwr_slab *slab);
+
+// Pushes a frame of 'size' empty slots and gives its base, slots move on push so they are kept by position
+bool cwr_stack_push(cwr_stack *stack, size_t size, size_t *frame);
+
+// Pops the top frame and drops the references held by its slots
+void cwr_stack_pop(cwr_stack *stack);
+
+// Pops the top frame into the one under it, which drops its own slots and takes the popped ones
+void cwr_stack_replace(cwr_stack *stack);
+
+static inline cwr_tagged_value *cwr_stack_at(cwr_stack *stack, size_t position)
+{
+    return &stack->slots[position];
+}
+
+void cwr_stack_destroy(cwr_stack *stack);
+
+#endif // CWR_STACK_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <cwr_node.h>
 #include <cwr_string.h>
+#include <cwr_slab.h>
 
 typedef struct cwr_value cwr_value;
 
@@ -35,25 +36,68 @@ typedef struct cwr_value
     };
 } cwr_value;
 
-static void cwr_value_instance_destroy(cwr_value *value);
-static void cwr_array_value_destroy(cwr_array_value array_value);
+// Scalars travel by value, only arrays and pointers need a 'cwr_value'
+typedef struct cwr_tagged_value
+{
+    cwr_value_type type;
+
+    union
+    {
+        float float_n;
+        int integer_n;
+        char character;
+        cwr_value *value;
+    };
+} cwr_tagged_value;
+
+static void cwr_value_instance_destroy(cwr_slab *slab, cwr_value *value);
+static void cwr_array_value_destroy(cwr_slab *slab, cwr_array_value array_value);
+
+// Bytes of the elements, slabs take them back by size
+static size_t cwr_array_value_size(cwr_array_value array_value)
+{
+    if (array_value.is_reference)
+    {
+        return array_value.capacity * sizeof(cwr_value *);
+    }
+
+    switch (array_value.type)
+    {
+    case cwr_value_character_type:
+        return array_value.capacity * sizeof(char);
+    case cwr_value_float_type:
+        return array_value.capacity * sizeof(float);
+    case cwr_value_integer_type:
+        return array_value.capacity * sizeof(int);
+    default:
+        return 0;
+    }
+}
 
-static cwr_array_value cwr_value_create_array_copy(cwr_array_value value)
+static cwr_array_value cwr_value_create_array_copy(cwr_slab *slab, cwr_array_value value)
 {
     switch (value.type)
     {
     case cwr_value_character_type:
+    {
+        char *characters = cwr_slab_allocate(slab, value.capacity * sizeof(char));
+        if (characters != NULL)
+        {
+            memcpy(characters, value.characters, value.capacity * sizeof(char));
+        }
+
         return (cwr_array_value){
             .type = cwr_value_character_type,
             .capacity = value.capacity,
-            .characters = cwr_string_duplicate(value.characters)};
+            .characters = characters};
+    }
     }
 }
 
-static cwr_value *cwr_value_create_copy(cwr_value *value)
+static cwr_value *cwr_value_create_copy(cwr_slab *slab, cwr_value *value)
 {
-    cwr_value *target = malloc(sizeof(cwr_value));
-    if (value == NULL)
+    cwr_value *target = cwr_slab_allocate(slab, sizeof(cwr_value));
+    if (target == NULL)
     {
         return NULL;
     }
@@ -63,9 +107,9 @@ static cwr_value *cwr_value_create_copy(cwr_value *value)
     return target;
 }
 
-static cwr_value *cwr_value_create_void()
+static cwr_value *cwr_value_create_void(cwr_slab *slab)
 {
-    cwr_value *value = malloc(sizeof(cwr_value));
+    cwr_value *value = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (value == NULL)
     {
         return NULL;
@@ -76,9 +120,9 @@ static cwr_value *cwr_value_create_void()
     return value;
 }
 
-static cwr_value *cwr_value_create_float(float number)
+static cwr_value *cwr_value_create_float(cwr_slab *slab, float number)
 {
-    cwr_value *value = malloc(sizeof(cwr_value));
+    cwr_value *value = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (value == NULL)
     {
         return NULL;
@@ -90,9 +134,9 @@ static cwr_value *cwr_value_create_float(float number)
     return value;
 }
 
-static cwr_value *cwr_value_create_integer(int number)
+static cwr_value *cwr_value_create_integer(cwr_slab *slab, int number)
 {
-    cwr_value *value = malloc(sizeof(cwr_value));
+    cwr_value *value = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (value == NULL)
     {
         return NULL;
@@ -104,9 +148,9 @@ static cwr_value *cwr_value_create_integer(int number)
     return value;
 }
 
-static cwr_value *cwr_value_create_character(char character)
+static cwr_value *cwr_value_create_character(cwr_slab *slab, char character)
 {
-    cwr_value *value = malloc(sizeof(cwr_value));
+    cwr_value *value = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (value == NULL)
     {
         return NULL;
@@ -118,9 +162,10 @@ static cwr_value *cwr_value_create_character(char character)
     return value;
 }
 
-static cwr_value *cwr_value_create_array(cwr_array_value array_value)
+// Takes 'array_value', its elements must come from the same slab
+static cwr_value *cwr_value_create_array(cwr_slab *slab, cwr_array_value array_value)
 {
-    cwr_value *value = malloc(sizeof(cwr_value));
+    cwr_value *value = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (value == NULL)
     {
         return NULL;
@@ -137,20 +182,20 @@ static void cwr_value_add_reference(cwr_value *value)
     value->references_count++;
 }
 
-static void cwr_value_remove_reference(cwr_value *value)
+static void cwr_value_remove_reference(cwr_slab *slab, cwr_value *value)
 {
     if (--value->references_count <= 0)
     {
-        cwr_value_instance_destroy(value);
+        cwr_value_instance_destroy(slab, value);
     }
 }
 
-static void cwr_value_set(cwr_value *target, cwr_value *value)
+static void cwr_value_set(cwr_slab *slab, cwr_value *target, cwr_value *value)
 {
     switch (target->type)
     {
     case cwr_value_array_type:
-        cwr_array_value_destroy(target->array);
+        cwr_array_value_destroy(slab, target->array);
         target->array = value->array;
         break;
     case cwr_value_character_type:
@@ -165,14 +210,14 @@ static void cwr_value_set(cwr_value *target, cwr_value *value)
     }
 }
 
-static cwr_value *cwr_array_value_dereference(cwr_array_value value)
+static cwr_value *cwr_array_value_dereference(cwr_slab *slab, cwr_array_value value)
 {
     if (value.is_reference)
     {
         return value.values[0];
     }
 
-    cwr_value *target = malloc(sizeof(cwr_value));
+    cwr_value *target = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (target == NULL)
     {
         return NULL;
@@ -196,14 +241,14 @@ static cwr_value *cwr_array_value_dereference(cwr_array_value value)
     return target;
 }
 
-static cwr_value *cwr_value_dereference(cwr_value *value)
+static cwr_value *cwr_value_dereference(cwr_slab *slab, cwr_value *value)
 {
-    return cwr_array_value_dereference(value->array);
+    return cwr_array_value_dereference(slab, value->array);
 }
 
-static cwr_value *cwr_value_reference(cwr_value *value)
+static cwr_value *cwr_value_reference(cwr_slab *slab, cwr_value *value)
 {
-    cwr_value *target = malloc(sizeof(cwr_value));
+    cwr_value *target = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (target == NULL)
     {
         return NULL;
@@ -215,11 +260,11 @@ static cwr_value *cwr_value_reference(cwr_value *value)
         .type = value->type,
         .capacity = 1,
         .is_reference = true,
-        .values = malloc(sizeof(cwr_value *))};
+        .values = cwr_slab_allocate(slab, sizeof(cwr_value *))};
 
     if (target->array.values == NULL)
     {
-        free(target);
+        cwr_slab_free(slab, target, sizeof(cwr_value));
         return NULL;
     }
 
@@ -227,9 +272,9 @@ static cwr_value *cwr_value_reference(cwr_value *value)
     return target;
 }
 
-static cwr_value *cwr_value_at(cwr_array_value array_value, size_t index)
+static cwr_value *cwr_value_at(cwr_slab *slab, cwr_array_value array_value, size_t index)
 {
-    cwr_value *target = malloc(sizeof(cwr_value));
+    cwr_value *target = cwr_slab_allocate(slab, sizeof(cwr_value));
     if (target == NULL)
     {
         return NULL;
@@ -281,54 +326,315 @@ static cwr_array_value cwr_value_as_array(cwr_value value)
     return value.array;
 }
 
-static void cwr_array_value_destroy(cwr_array_value array_value)
+static void cwr_array_value_destroy(cwr_slab *slab, cwr_array_value array_value)
 {
-    if (array_value.is_reference)
+    if (!array_value.is_reference && array_value.capacity <= 0)
     {
-        free(array_value.values);
         return;
     }
 
-    if (array_value.capacity <= 0)
+    cwr_slab_free(slab, array_value.values, cwr_array_value_size(array_value));
+}
+
+static void cwr_value_instance_destroy(cwr_slab *slab, cwr_value *value)
+{
+    switch (value->type)
+    {
+    case cwr_value_pointer_type:
+    case cwr_value_array_type:
+        cwr_array_value_destroy(slab, value->array);
+        break;
+    }
+
+    cwr_slab_free(slab, value, sizeof(cwr_value));
+}
+
+static void cwr_value_runtime_destroy(cwr_slab *slab, cwr_value *value)
+{
+    if (value->references_count > 0)
     {
         return;
     }
 
-    switch (array_value.type)
+    cwr_value_instance_destroy(slab, value);
+}
+
+static bool cwr_tagged_value_is_reference(const cwr_tagged_value *value)
+{
+    return value->type == cwr_value_array_type || value->type == cwr_value_pointer_type;
+}
+
+static cwr_tagged_value cwr_tagged_value_void()
+{
+    return (cwr_tagged_value){
+        .type = cwr_value_void_type};
+}
+
+static cwr_tagged_value cwr_tagged_value_float(float number)
+{
+    return (cwr_tagged_value){
+        .type = cwr_value_float_type,
+        .float_n = number};
+}
+
+static cwr_tagged_value cwr_tagged_value_integer(int number)
+{
+    return (cwr_tagged_value){
+        .type = cwr_value_integer_type,
+        .integer_n = number};
+}
+
+// The whole word is set, so reading a character as a number gives its code
+static cwr_tagged_value cwr_tagged_value_character(char character)
+{
+    return (cwr_tagged_value){
+        .type = cwr_value_character_type,
+        .integer_n = (unsigned char)character};
+}
+
+static cwr_tagged_value cwr_tagged_value_array(cwr_value_type type, cwr_value *value)
+{
+    return (cwr_tagged_value){
+        .type = type,
+        .value = value};
+}
+
+// Characters are numbers by their code, arrays and pointers are zero
+static float cwr_tagged_value_as_float(const cwr_tagged_value *value)
+{
+    switch (value->type)
     {
+    case cwr_value_float_type:
+        return value->float_n;
+    case cwr_value_integer_type:
     case cwr_value_character_type:
-        free(array_value.characters);
-        break;
+        return value->integer_n;
+    default:
+        return 0;
+    }
+}
+
+static int cwr_tagged_value_as_integer(const cwr_tagged_value *value)
+{
+    switch (value->type)
+    {
     case cwr_value_float_type:
-        free(array_value.floats);
-        break;
+        return value->float_n;
     case cwr_value_integer_type:
-        free(array_value.integers);
-        break;
+    case cwr_value_character_type:
+        return value->integer_n;
+    default:
+        return 0;
+    }
+}
+
+// Result of an operator without arithmetic meaning, float when either operand is
+static cwr_tagged_value cwr_tagged_value_number(const cwr_tagged_value *left, const cwr_tagged_value *right, float result)
+{
+    if (left->type == cwr_value_float_type || right->type == cwr_value_float_type)
+    {
+        return cwr_tagged_value_float(result);
+    }
+
+    return cwr_tagged_value_integer(result);
+}
+
+// Float kernels compare into an integer like the integer ones
+static cwr_tagged_value cwr_tagged_value_float_result(cwr_binary_operator_type type, float number)
+{
+    return cwr_binary_operator_is_comparison(type) ? cwr_tagged_value_integer((int)number) : cwr_tagged_value_float(number);
+}
+
+// Applies 'type' with the kernel the parser picked. Declared types can disagree with values ('int x = 1 + 2.5'
+// holds a float), those take the kernel of their value types. False only on division by zero
+static inline bool cwr_tagged_value_apply(cwr_binary_operator_type type, cwr_binary_kernel_type kernel, const cwr_tagged_value *left, const cwr_tagged_value *right, cwr_tagged_value *result)
+{
+    int integer;
+    float number;
+
+    if (kernel == cwr_binary_kernel_integer_type && left->type == cwr_value_integer_type && right->type == cwr_value_integer_type)
+    {
+        if (!cwr_binary_operator_apply_integer(type, left->integer_n, right->integer_n, &integer))
+        {
+            return false;
+        }
+
+        *result = cwr_tagged_value_integer(integer);
+        return true;
+    }
+
+    if (kernel == cwr_binary_kernel_float_type && left->type == cwr_value_float_type && right->type == cwr_value_float_type)
+    {
+        if (!cwr_binary_operator_apply_float(type, left->float_n, right->float_n, &number))
+        {
+            return false;
+        }
+
+        *result = cwr_tagged_value_float_result(type, number);
+        return true;
     }
+
+    if (left->type != cwr_value_float_type && right->type != cwr_value_float_type)
+    {
+        if (!cwr_binary_operator_apply_integer(type, cwr_tagged_value_as_integer(left), cwr_tagged_value_as_integer(right), &integer))
+        {
+            return false;
+        }
+
+        *result = cwr_tagged_value_integer(integer);
+        return true;
+    }
+
+    if (!cwr_binary_operator_apply_float(type, cwr_tagged_value_as_float(left), cwr_tagged_value_as_float(right), &number))
+    {
+        return false;
+    }
+
+    *result = cwr_tagged_value_float_result(type, number);
+    return true;
 }
 
-static void cwr_value_instance_destroy(cwr_value *value)
+// Result of 'type' taken as a condition, see 'cwr_tagged_value_apply'
+static inline bool cwr_tagged_value_compare(cwr_binary_operator_type type, cwr_binary_kernel_type kernel, const cwr_tagged_value *left, const cwr_tagged_value *right)
+{
+    cwr_tagged_value result;
+    if (!cwr_tagged_value_apply(type, kernel, left, right, &result))
+    {
+        return false;
+    }
+
+    return cwr_tagged_value_as_integer(&result) != 0;
+}
+
+// Minus and negation, anything that isn't a float is taken as an integer like in 'cwr_tagged_value_apply'
+static inline cwr_tagged_value cwr_tagged_value_apply_unary(cwr_binary_operator_type type, cwr_binary_kernel_type kernel, const cwr_tagged_value *value)
+{
+    if (kernel == cwr_binary_kernel_integer_type && value->type == cwr_value_integer_type)
+    {
+        return cwr_tagged_value_integer(cwr_unary_operator_apply_integer(type, value->integer_n));
+    }
+
+    if (value->type == cwr_value_float_type)
+    {
+        return cwr_tagged_value_float(cwr_unary_operator_apply_float(type, value->float_n));
+    }
+
+    return cwr_tagged_value_integer(cwr_unary_operator_apply_integer(type, cwr_tagged_value_as_integer(value)));
+}
+
+// Arrays are shared, scalars are copied and 'value' stays with its owner
+static cwr_tagged_value cwr_tagged_value_from(cwr_value *value)
 {
     switch (value->type)
     {
+    case cwr_value_array_type:
     case cwr_value_pointer_type:
+        return cwr_tagged_value_array(value->type, value);
+    case cwr_value_float_type:
+        return cwr_tagged_value_float(value->float_n);
+    case cwr_value_integer_type:
+        return cwr_tagged_value_integer(value->integer_n);
+    case cwr_value_character_type:
+        return cwr_tagged_value_character(value->character);
+    default:
+        return (cwr_tagged_value){
+            .type = value->type};
+    }
+}
+
+// New value for a scalar, the value itself for arrays
+static cwr_value *cwr_tagged_value_box(cwr_slab *slab, cwr_tagged_value value)
+{
+    switch (value.type)
+    {
     case cwr_value_array_type:
-        cwr_array_value_destroy(value->array);
-        break;
+    case cwr_value_pointer_type:
+        return value.value;
+    case cwr_value_float_type:
+        return cwr_value_create_float(slab, value.float_n);
+    case cwr_value_integer_type:
+        return cwr_value_create_integer(slab, value.integer_n);
+    case cwr_value_character_type:
+        return cwr_value_create_character(slab, value.character);
+    default:
+        return cwr_value_create_void(slab);
     }
+}
 
-    free(value);
+// Element 'index' of an array by value, the bounds are checked by the caller
+static cwr_tagged_value cwr_tagged_value_at(cwr_array_value array_value, size_t index)
+{
+    switch (array_value.type)
+    {
+    case cwr_value_character_type:
+        return cwr_tagged_value_character(array_value.characters[index]);
+    case cwr_value_float_type:
+        return cwr_tagged_value_float(array_value.floats[index]);
+    case cwr_value_integer_type:
+        return cwr_tagged_value_integer(array_value.integers[index]);
+    default:
+        return (cwr_tagged_value){
+            .type = array_value.type};
+    }
 }
 
-static void cwr_value_runtime_destroy(cwr_value *value)
+// Value a pointer refers to or the first element of an array, copied without a new 'cwr_value'
+static cwr_tagged_value cwr_tagged_value_dereference(cwr_value *value)
 {
-    if (value->references_count > 0)
+    if (value->array.is_reference)
+    {
+        return cwr_tagged_value_from(value->array.values[0]);
+    }
+
+    return cwr_tagged_value_at(value->array, 0);
+}
+
+// Writes scalar 'value' to what 'pointer' refers to, arrays are not written through
+static void cwr_tagged_value_store(cwr_value *pointer, cwr_tagged_value value)
+{
+    if (!pointer->array.is_reference)
     {
         return;
     }
 
-    cwr_value_instance_destroy(value);
+    cwr_value *target = pointer->array.values[0];
+    switch (target->type)
+    {
+    case cwr_value_character_type:
+        target->character = value.character;
+        break;
+    case cwr_value_integer_type:
+        target->integer_n = value.integer_n;
+        break;
+    case cwr_value_float_type:
+        target->float_n = value.float_n;
+        break;
+    }
+}
+
+static void cwr_tagged_value_add_reference(const cwr_tagged_value *value)
+{
+    if (cwr_tagged_value_is_reference(value))
+    {
+        cwr_value_add_reference(value->value);
+    }
+}
+
+static void cwr_tagged_value_remove_reference(cwr_slab *slab, const cwr_tagged_value *value)
+{
+    if (cwr_tagged_value_is_reference(value))
+    {
+        cwr_value_remove_reference(slab, value->value);
+    }
+}
+
+// Frees a temporary array nothing refers to, scalars own nothing
+static void cwr_tagged_value_release(cwr_slab *slab, const cwr_tagged_value *value)
+{
+    if (cwr_tagged_value_is_reference(value))
+    {
+        cwr_value_runtime_destroy(slab, value->value);
+    }
 }
 
 #endif // CWR_VALUE_H
\ No newline at end of file
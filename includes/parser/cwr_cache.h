@@ -0,0 +1,27 @@
+#ifndef CWR_CACHE_H
+#define CWR_CACHE_H
+
+#include <cwr_parser.h>
+
+// Bump on any image layout change, it is part of every key
+#define CWR_CACHE_VERSION 5
+#define CWR_CACHE_EXTENSION ".cwrc"
+
+// Directory of compiled programs, one file per key, written whole and renamed into place
+typedef struct cwr_cache cwr_cache;
+
+// Creates 'directory' when it does not exist yet
+cwr_cache *cwr_cache_create(const char *directory);
+
+// Other inputs changing the result, e.g. the optimizer configuration, are mixed in with 'cwr_hash_continue'
+size_t cwr_cache_key(const char *executor, const char *source, size_t length);
+
+// Maps the file of 'key' and relocates it in place, false on a miss or a file that fails validation
+bool cwr_cache_load(cwr_cache *cache, size_t key, cwr_parser_result *result);
+
+// Failed and lazily parsed results are not stored
+bool cwr_cache_store(cwr_cache *cache, size_t key, const cwr_parser_result *result);
+
+void cwr_cache_destroy(cwr_cache *cache);
+
+#endif // CWR_CACHE_H
\ No newline at end of file
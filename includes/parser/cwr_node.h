@@ -3,18 +3,23 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <cwr_parser_error.h>
 #include <cwr_token.h>
+#include <cwr_vector.h>
+#include <cwr_type.h>
 
 typedef struct cwr_statement cwr_statement;
 typedef struct cwr_expression cwr_expression;
 typedef struct cwr_binary_expression cwr_binary_expression;
 typedef struct cwr_func_body_expression cwr_func_body_expression;
-typedef struct cwr_expression_type_value cwr_expression_type_value;
 
-static void cwr_statement_destroy(cwr_statement statement);
-static void cwr_expression_destroy(cwr_expression expression);
+// Expressions live in 'cwr_expression_pool' and refer to each other by index
+typedef uint32_t cwr_expression_index;
+
+#define CWR_EXPRESSION_INDEX_NONE UINT32_MAX
+#define CWR_EXPRESSION_POOL_DEFAULT_SIZE 64
 
 typedef enum cwr_binary_operator_type
 {
@@ -34,6 +39,19 @@ typedef enum cwr_binary_operator_type
     cwr_binary_operator_less_equals_than_type,
 } cwr_binary_operator_type;
 
+// Operand types a binary or unary node was specialized for by the parser
+typedef enum cwr_binary_kernel_type
+{
+    // Arrays, pointers and anything else, the kernel is picked from the values
+    cwr_binary_kernel_generic_type,
+    // Integers or characters on both sides, computed as int
+    cwr_binary_kernel_integer_type,
+    // Floats on both sides
+    cwr_binary_kernel_float_type,
+    // Integer or character with a float, computed as float
+    cwr_binary_kernel_mixed_type
+} cwr_binary_kernel_type;
+
 typedef enum cwr_statement_type
 {
     cwr_statement_struct_decl_type,
@@ -50,34 +68,15 @@ typedef enum cwr_expression_type
 {
     cwr_expression_binary_type,
     cwr_expression_func_call_type,
-    cwr_expression_array_type,
     cwr_expression_array_element_type,
     cwr_expression_var_type,
     cwr_expression_character_type,
     cwr_expression_unary_type,
     cwr_expression_float_type,
-    cwr_expression_integer_type
+    cwr_expression_integer_type,
+    cwr_expression_string_type
 } cwr_expression_type;
 
-typedef enum cwr_value_type
-{
-    cwr_value_character_type,
-    cwr_value_float_type,
-    cwr_value_integer_type,
-    cwr_value_structure_type,
-    cwr_value_array_type,
-    cwr_value_pointer_type,
-    cwr_value_void_type
-} cwr_value_type;
-
-typedef struct cwr_expression_type_value
-{
-    cwr_value_type value_type;
-    int identifier;
-    char *name;
-    cwr_expression_type_value *target_type;
-} cwr_expression_type_value;
-
 typedef struct cwr_character_expression
 {
     char value;
@@ -93,11 +92,19 @@ typedef struct cwr_integer_expression
     int value;
 } cwr_integer_expression;
 
+typedef struct cwr_string_expression
+{
+    // Offset in pool strings, length includes terminator
+    uint32_t offset;
+    uint32_t length;
+} cwr_string_expression;
+
 typedef struct cwr_argument
 {
+    // Slot in the frame of the function, arguments take the first slots
     int identifier;
     char *name;
-    cwr_expression_type_value type;
+    const cwr_expression_type_value *type;
 } cwr_argument;
 
 typedef struct cwr_func_body_expression
@@ -107,17 +114,10 @@ typedef struct cwr_func_body_expression
     size_t count;
 } cwr_func_body_expression;
 
-typedef struct cwr_array_expression
-{
-    cwr_expression_type_value type;
-    cwr_expression *elements;
-    size_t count;
-} cwr_array_expression;
-
 typedef struct cwr_array_element_expression
 {
     // First value, second index
-    cwr_expression *children;
+    cwr_expression_index children[2];
 } cwr_array_element_expression;
 
 typedef struct cwr_func_decl_statement
@@ -128,44 +128,48 @@ typedef struct cwr_func_decl_statement
     size_t count;
     cwr_func_body_expression func_body;
     bool with_body;
-    cwr_expression_type_value return_type;
+    const cwr_expression_type_value *return_type;
+    // Count of slots needed by arguments and every local variable
+    size_t frame_size;
+    // Body was skipped in lazy mode, 'func_body' is empty until 'cwr_parser_parse_lazy_body'
+    bool is_lazy;
 } cwr_func_decl_statement;
 
 typedef struct cwr_var_expression
 {
+    // Slot in the frame of the enclosing function
     int identifier;
-    char *name;
 } cwr_var_expression;
 
 typedef struct cwr_func_call_statement
 {
     int identifier;
-    char *name;
-    cwr_expression_type_value return_type;
-    cwr_expression *arguments;
-    size_t count;
+    // Offset of the first argument in pool indices
+    uint32_t arguments;
+    uint32_t count;
 } cwr_func_call_statement;
 
+// Operator and kernel are 'cwr_binary_operator_type' and 'cwr_binary_kernel_type' kept narrow, so nodes stay small
 typedef struct cwr_binary_expression
 {
-    cwr_binary_operator_type type;
+    uint16_t type;
+    uint16_t kernel;
     // First left, second right
-    cwr_expression *children;
+    cwr_expression_index children[2];
 } cwr_binary_expression;
 
 typedef struct cwr_unary_expression
 {
-    cwr_binary_operator_type type;
+    uint16_t type;
+    uint16_t kernel;
     // Value
-    cwr_expression *child;
+    cwr_expression_index child;
 } cwr_unary_expression;
 
+// Value type, location and name are kept in pool side tables
 typedef struct cwr_expression
 {
     cwr_expression_type type;
-    cwr_expression_type_value value_type;
-    cwr_func_body_expression root;
-    cwr_location location;
 
     union
     {
@@ -176,23 +180,24 @@ typedef struct cwr_expression
         cwr_float_expression float_n;
         cwr_integer_expression integer_n;
         cwr_character_expression character;
-        cwr_array_expression array;
+        cwr_string_expression string;
         cwr_array_element_expression array_element;
     };
 } cwr_expression;
 
 typedef struct cwr_var_decl_statement
 {
+    // Slot in the frame of the enclosing function, reused by variables of finished blocks
     int identifier;
     char *name;
-    cwr_expression_type_value value_type;
-    cwr_expression value;
+    const cwr_expression_type_value *value_type;
+    cwr_expression_index value;
 } cwr_var_decl_statement;
 
 typedef struct cwr_assign_statement
 {
-    cwr_expression identifier;
-    cwr_expression value;
+    cwr_expression_index identifier;
+    cwr_expression_index value;
     bool is_dereference;
 } cwr_assign_statement;
 
@@ -200,7 +205,7 @@ typedef struct cwr_for_loop_statement
 {
     cwr_var_decl_statement variable;
     bool with_variable;
-    cwr_expression condition;
+    cwr_expression_index condition;
     bool with_condition;
     cwr_statement *statement;
     bool with_statement;
@@ -210,21 +215,22 @@ typedef struct cwr_for_loop_statement
 
 typedef struct cwr_if_statement
 {
-    cwr_expression condition;
+    cwr_expression_index condition;
     cwr_func_body_expression body;
 } cwr_if_statement;
 
 typedef struct cwr_return_statement
 {
-    cwr_expression value;
+    cwr_expression_index value;
     cwr_func_body_expression body;
     bool with_body;
+    // Returns a call as the last thing the function does, the optimizer can still inline that call away
+    bool is_tail_call;
 } cwr_return_statement;
 
 typedef struct cwr_statement
 {
     cwr_statement_type type;
-    cwr_func_body_expression root;
     cwr_location location;
     bool is_block;
 
@@ -240,352 +246,574 @@ typedef struct cwr_statement
     };
 } cwr_statement;
 
+typedef struct cwr_expression_name
+{
+    cwr_expression_index expression;
+    char *name;
+} cwr_expression_name;
+
+// Tables indexed by expression, then call arguments, names sorted by expression and string bytes
+typedef struct cwr_expression_pool
+{
+    cwr_expression *expressions;
+    // Side tables, same length as 'expressions'
+    const cwr_expression_type_value **types;
+    cwr_location *locations;
+    size_t count;
+    size_t capacity;
+    cwr_expression_index *indices;
+    size_t indices_count;
+    size_t indices_capacity;
+    cwr_expression_name *names;
+    size_t names_count;
+    size_t names_capacity;
+    char *strings;
+    size_t strings_count;
+    size_t strings_capacity;
+} cwr_expression_pool;
+
 typedef struct cwr_nodes_list
 {
     cwr_statement *statements;
     size_t count;
+    cwr_expression_pool *pool;
 } cwr_nodes_list;
 
-static bool cwr_expression_type_value_equals(cwr_expression_type_value type, cwr_expression_type_value target)
+static cwr_expression_pool *cwr_expression_pool_create()
 {
-    if (type.value_type == cwr_value_array_type)
+    cwr_expression_pool *pool = calloc(1, sizeof(cwr_expression_pool));
+    if (pool == NULL)
     {
-        if (target.value_type != cwr_value_array_type)
-        {
-            return false;
-        }
-
-        return cwr_expression_type_value_equals(*type.target_type, *target.target_type);
+        return NULL;
     }
 
-    if (type.value_type == cwr_value_pointer_type)
+    pool->expressions = malloc(CWR_EXPRESSION_POOL_DEFAULT_SIZE * sizeof(cwr_expression));
+    pool->types = malloc(CWR_EXPRESSION_POOL_DEFAULT_SIZE * sizeof(cwr_expression_type_value *));
+    pool->locations = malloc(CWR_EXPRESSION_POOL_DEFAULT_SIZE * sizeof(cwr_location));
+    if (pool->expressions == NULL || pool->types == NULL || pool->locations == NULL)
     {
-        if (target.value_type != cwr_value_array_type && target.value_type != cwr_value_pointer_type)
-        {
-            return false;
-        }
-
-        return cwr_expression_type_value_equals(*type.target_type, *target.target_type);
+        free(pool->expressions);
+        free(pool->types);
+        free(pool->locations);
+        free(pool);
+        return NULL;
     }
 
-    if (type.identifier != -1)
-    {
-        return type.identifier == target.identifier && type.value_type == target.value_type;
-    }
+    pool->capacity = CWR_EXPRESSION_POOL_DEFAULT_SIZE;
+    return pool;
+}
 
-    if (type.value_type == cwr_value_float_type && target.value_type == cwr_value_integer_type)
-    {
-        return true;
-    }
+static inline cwr_expression *cwr_expression_pool_get(const cwr_expression_pool *pool, cwr_expression_index index)
+{
+    return &pool->expressions[index];
+}
 
-    return type.value_type == target.value_type;
+static inline const cwr_expression_type_value *cwr_expression_pool_type(const cwr_expression_pool *pool, cwr_expression_index index)
+{
+    return pool->types[index];
 }
 
-static bool cwr_func_body_can_access(cwr_func_body_expression *target, cwr_func_body_expression *requester)
+static inline cwr_location cwr_expression_pool_location(const cwr_expression_pool *pool, cwr_expression_index index)
 {
-    if (target == NULL)
+    return pool->locations[index];
+}
+
+static inline const char *cwr_expression_pool_string(const cwr_expression_pool *pool, cwr_string_expression string)
+{
+    return &pool->strings[string.offset];
+}
+
+static inline cwr_expression_index cwr_expression_pool_argument(const cwr_expression_pool *pool, uint32_t offset, size_t position)
+{
+    return pool->indices[offset + position];
+}
+
+// Grows the parallel expression tables so 'count' more expressions fit
+static bool cwr_expression_pool_reserve(cwr_expression_pool *pool, size_t count)
+{
+    if (pool->count + count >= CWR_EXPRESSION_INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (pool->count + count <= pool->capacity)
     {
         return true;
     }
 
-    if (requester == NULL)
+    size_t capacity = pool->capacity == 0 ? CWR_EXPRESSION_POOL_DEFAULT_SIZE : pool->capacity;
+    while (capacity < pool->count + count)
     {
-        return false;
+        capacity *= 2;
     }
 
-    if (target != requester)
+    cwr_expression *expressions = realloc(pool->expressions, capacity * sizeof(cwr_expression));
+    if (expressions == NULL)
     {
-        return cwr_func_body_can_access(target, requester->root);
+        return false;
     }
 
-    return true;
-}
+    pool->expressions = expressions;
 
-static cwr_binary_operator_type cwr_binary_operator_type_from_token(cwr_token_type type)
-{
-    switch (type)
+    const cwr_expression_type_value **types = realloc(pool->types, capacity * sizeof(cwr_expression_type_value *));
+    if (types == NULL)
     {
-    case cwr_token_plus_type:
-        return cwr_binary_operator_plus_type;
-    case cwr_token_minus_type:
-        return cwr_binary_operator_minus_type;
-    case cwr_token_asterisk_type:
-        return cwr_binary_operator_multiplicative_type;
-    case cwr_token_slash_type:
-        return cwr_binary_operator_division_type;
-    case cwr_token_exclamation_mark_type:
-        return cwr_binary_operator_negation_type;
-    case cwr_token_equals_type:
-        return cwr_binary_operator_equals_type;
-    case cwr_token_ampersand_type:
-        return cwr_binary_operator_reference_type;
-    case cwr_token_greater_than_type:
-        return cwr_binary_operator_greater_than_type;
-    case cwr_token_less_than_type:
-        return cwr_binary_operator_less_than_type;
-    default:
-        return cwr_binary_operator_none_type;
+        return false;
     }
-}
 
-static bool cwr_statement_is_block(cwr_statement_type type)
-{
-    switch (type)
+    pool->types = types;
+
+    cwr_location *locations = realloc(pool->locations, capacity * sizeof(cwr_location));
+    if (locations == NULL)
     {
-    case cwr_statement_for_loop_type:
-    case cwr_statement_if_type:
-        return true;
-    default:
         return false;
     }
-}
 
-static cwr_expression_type_value cwr_expression_type_value_create_from_type(cwr_value_type value_type)
-{
-    return (cwr_expression_type_value){
-        .value_type = value_type};
+    pool->locations = locations;
+    pool->capacity = capacity;
+    return true;
 }
 
-static cwr_expression_type_value cwr_expression_type_value_create_array_from_type(cwr_value_type value_type)
+static cwr_expression_index cwr_expression_pool_add(cwr_expression_pool *pool, cwr_expression expression, const cwr_expression_type_value *type, cwr_location location)
 {
-    cwr_expression_type_value array_type = cwr_expression_type_value_create_from_type(value_type);
+    if (!cwr_expression_pool_reserve(pool, 1))
+    {
+        return CWR_EXPRESSION_INDEX_NONE;
+    }
 
-    return (cwr_expression_type_value){
-        .value_type = cwr_value_array_type,
-        .target_type = &array_type};
+    pool->expressions[pool->count] = expression;
+    pool->types[pool->count] = type;
+    pool->locations[pool->count] = location;
+    return (cwr_expression_index)pool->count++;
 }
 
-static cwr_expression_type_value cwr_expression_type_value_create_array(cwr_expression_type_value *type_value)
+// Returns offset of the copied list in 'indices', or CWR_EXPRESSION_INDEX_NONE
+static uint32_t cwr_expression_pool_add_indices(cwr_expression_pool *pool, const cwr_expression_index *indices, size_t count)
 {
-    return (cwr_expression_type_value){
-        .value_type = cwr_value_array_type,
-        .target_type = type_value};
-}
+    if (pool->indices_count + count >= CWR_EXPRESSION_INDEX_NONE)
+    {
+        return CWR_EXPRESSION_INDEX_NONE;
+    }
 
-static cwr_float_expression cwr_expression_create_float(float value)
-{
-    return (cwr_float_expression){
-        .value = value};
-}
+    if (!CWR_VECTOR_RESERVE(pool->indices, pool->indices_capacity, pool->indices_count, count))
+    {
+        return CWR_EXPRESSION_INDEX_NONE;
+    }
 
-static cwr_integer_expression cwr_expression_create_integer(int value)
-{
-    return (cwr_integer_expression){
-        .value = value};
+    uint32_t offset = (uint32_t)pool->indices_count;
+    if (count > 0)
+    {
+        memcpy(&pool->indices[offset], indices, count * sizeof(cwr_expression_index));
+    }
+
+    pool->indices_count += count;
+    return offset;
 }
 
-static void cwr_expression_type_value_destroy(cwr_expression_type_value type_value)
+// Returns offset of the copied bytes in 'strings', or CWR_EXPRESSION_INDEX_NONE
+static uint32_t cwr_expression_pool_add_string(cwr_expression_pool *pool, const char *value, size_t length)
 {
-    if (type_value.name != NULL)
+    if (pool->strings_count + length >= CWR_EXPRESSION_INDEX_NONE)
     {
-        free(type_value.name);
+        return CWR_EXPRESSION_INDEX_NONE;
     }
 
-    if (type_value.target_type)
+    if (!CWR_VECTOR_RESERVE(pool->strings, pool->strings_capacity, pool->strings_count, length))
     {
-        cwr_expression_type_value_destroy(*type_value.target_type);
-        free(type_value.target_type);
+        return CWR_EXPRESSION_INDEX_NONE;
     }
+
+    uint32_t offset = (uint32_t)pool->strings_count;
+    memcpy(&pool->strings[offset], value, length);
+
+    pool->strings_count += length;
+    return offset;
 }
 
-static void cwr_expression_destroy_body(cwr_func_body_expression expression)
+static bool cwr_expression_pool_add_name(cwr_expression_pool *pool, cwr_expression_index expression, char *name)
 {
-    for (size_t i = 0; i < expression.count; i++)
+    if (!CWR_VECTOR_RESERVE(pool->names, pool->names_capacity, pool->names_count, 1))
     {
-        cwr_statement_destroy(expression.statements[i]);
+        return false;
     }
 
-    free(expression.statements);
+    pool->names[pool->names_count++] = (cwr_expression_name){
+        .expression = expression,
+        .name = name};
+    return true;
 }
 
-static void cwr_statement_destroy_func_call(cwr_func_call_statement func_call)
+// Where the tables of an appended pool start in the pool it was appended to
+typedef struct cwr_expression_pool_offset
 {
-    free(func_call.name);
+    uint32_t expressions;
+    uint32_t indices;
+    uint32_t strings;
+} cwr_expression_pool_offset;
 
-    if (func_call.count > 0)
+// Copies every table of 'source' to the end of 'pool' and shifts the indices and offsets held by the copied expressions.
+// Statements referring to 'source' still have to be shifted by 'offset'
+static bool cwr_expression_pool_append(cwr_expression_pool *pool, const cwr_expression_pool *source, cwr_expression_pool_offset *offset)
+{
+    if (pool->indices_count + source->indices_count >= CWR_EXPRESSION_INDEX_NONE ||
+        pool->strings_count + source->strings_count >= CWR_EXPRESSION_INDEX_NONE)
     {
-        for (size_t i = 0; i < func_call.count; i++)
-        {
-            cwr_expression argument = func_call.arguments[i];
+        return false;
+    }
 
-            cwr_expression_destroy(argument);
-        }
+    if (!cwr_expression_pool_reserve(pool, source->count) ||
+        !CWR_VECTOR_RESERVE(pool->indices, pool->indices_capacity, pool->indices_count, source->indices_count) ||
+        !CWR_VECTOR_RESERVE(pool->names, pool->names_capacity, pool->names_count, source->names_count) ||
+        !CWR_VECTOR_RESERVE(pool->strings, pool->strings_capacity, pool->strings_count, source->strings_count))
+    {
+        return false;
     }
 
-    free(func_call.arguments);
-}
+    *offset = (cwr_expression_pool_offset){
+        .expressions = (uint32_t)pool->count,
+        .indices = (uint32_t)pool->indices_count,
+        .strings = (uint32_t)pool->strings_count};
+
+    for (size_t i = 0; i < source->count; i++)
+    {
+        cwr_expression expression = source->expressions[i];
 
-static void cwr_expression_destroy(cwr_expression expression)
-{
-    switch (expression.type)
-    {
-    case cwr_expression_binary_type:
-        cwr_expression_destroy(expression.binary.children[0]);
-        cwr_expression_destroy(expression.binary.children[1]);
-        free(expression.binary.children);
-        break;
-    case cwr_expression_unary_type:
-        cwr_expression_destroy(expression.unary.child[0]);
-        free(expression.unary.child);
-        break;
-    case cwr_expression_var_type:
-        free(expression.var.name);
-        break;
-    case cwr_expression_array_type:
-        cwr_expression_type_value_destroy(expression.value_type);
-        for (size_t i = 0; i < expression.array.count; i++)
+        switch (expression.type)
         {
-            cwr_expression_destroy(expression.array.elements[i]);
+        case cwr_expression_binary_type:
+            expression.binary.children[0] += offset->expressions;
+            expression.binary.children[1] += offset->expressions;
+            break;
+        case cwr_expression_array_element_type:
+            expression.array_element.children[0] += offset->expressions;
+            expression.array_element.children[1] += offset->expressions;
+            break;
+        case cwr_expression_unary_type:
+            expression.unary.child += offset->expressions;
+            break;
+        case cwr_expression_func_call_type:
+            expression.func_call.arguments += offset->indices;
+            break;
+        case cwr_expression_string_type:
+            expression.string.offset += offset->strings;
+            break;
+        default:
+            // Leaves refer to nothing
+            break;
         }
 
-        free(expression.array.elements);
-        break;
-    case cwr_expression_array_element_type:
-        cwr_expression_destroy(expression.array_element.children[0]);
-        cwr_expression_destroy(expression.array_element.children[1]);
-        free(expression.array_element.children);
-        break;
-    case cwr_expression_func_call_type:
-        cwr_statement_destroy_func_call(expression.func_call);
-        break;
+        pool->expressions[pool->count + i] = expression;
     }
-}
 
-static void cwr_func_body_expression_destroy(cwr_func_body_expression expression)
-{
-    if (expression.count > 0)
+    memcpy(&pool->types[pool->count], source->types, source->count * sizeof(cwr_expression_type_value *));
+    memcpy(&pool->locations[pool->count], source->locations, source->count * sizeof(cwr_location));
+    pool->count += source->count;
+
+    for (size_t i = 0; i < source->indices_count; i++)
     {
-        for (size_t i = 0; i < expression.count; i++)
-        {
-            cwr_statement statement = expression.statements[i];
+        pool->indices[pool->indices_count++] = source->indices[i] + offset->expressions;
+    }
 
-            cwr_statement_destroy(statement);
-        }
+    // Every appended expression is after the existing ones, so names stay sorted
+    for (size_t i = 0; i < source->names_count; i++)
+    {
+        pool->names[pool->names_count++] = (cwr_expression_name){
+            .expression = source->names[i].expression + offset->expressions,
+            .name = source->names[i].name};
+    }
 
-        free(expression.statements);
+    if (source->strings_count > 0)
+    {
+        memcpy(&pool->strings[pool->strings_count], source->strings, source->strings_count);
     }
+
+    pool->strings_count += source->strings_count;
+    return true;
 }
 
-static void cwr_var_decl_destroy(cwr_var_decl_statement var_decl)
+// Releases unused growth once the pool is complete, later additions grow it again
+static void cwr_expression_pool_trim(cwr_expression_pool *pool)
 {
-    free(var_decl.name);
-    cwr_expression_type_value_destroy(var_decl.value_type);
-    cwr_expression_destroy(var_decl.value);
+    size_t expressions_size = pool->capacity;
+    size_t types_size = pool->capacity;
+    size_t locations_size = pool->capacity;
+    CWR_VECTOR_TRIM(pool->expressions, expressions_size, pool->count);
+    CWR_VECTOR_TRIM(pool->types, types_size, pool->count);
+    CWR_VECTOR_TRIM(pool->locations, locations_size, pool->count);
+
+    // Parallel tables share one capacity, the smallest of them is the usable one
+    size_t capacity = expressions_size < types_size ? expressions_size : types_size;
+    pool->capacity = capacity < locations_size ? capacity : locations_size;
+
+    CWR_VECTOR_TRIM(pool->indices, pool->indices_capacity, pool->indices_count);
+    CWR_VECTOR_TRIM(pool->names, pool->names_capacity, pool->names_count);
+    CWR_VECTOR_TRIM(pool->strings, pool->strings_capacity, pool->strings_count);
 }
 
-static void cwr_func_decl_destroy(cwr_func_decl_statement func_decl)
+static char *cwr_expression_pool_name(const cwr_expression_pool *pool, cwr_expression_index expression)
 {
-    if (func_decl.count > 0)
+    size_t low = 0;
+    size_t high = pool->names_count;
+
+    while (low < high)
     {
-        for (size_t i = 0; i < func_decl.count; i++)
+        size_t middle = low + (high - low) / 2;
+        cwr_expression_index current = pool->names[middle].expression;
+
+        if (current == expression)
         {
-            cwr_argument argument = func_decl.arguments[i];
-            free(argument.name);
-            cwr_expression_type_value_destroy(argument.type);
+            return pool->names[middle].name;
         }
 
-        free(func_decl.arguments);
+        if (current < expression)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
     }
 
-    free(func_decl.name);
-    cwr_expression_type_value_destroy(func_decl.return_type);
+    return NULL;
+}
 
-    if (func_decl.with_body)
+static void cwr_expression_pool_destroy(cwr_expression_pool *pool)
+{
+    if (pool == NULL)
     {
-        cwr_expression_destroy_body(func_decl.func_body);
+        return;
     }
+
+    free(pool->expressions);
+    free(pool->types);
+    free(pool->locations);
+    free(pool->indices);
+    free(pool->names);
+    free(pool->strings);
+    free(pool);
 }
 
-static void cwr_statement_destroy_for_loop(cwr_for_loop_statement statement)
+static bool cwr_func_body_can_access(cwr_func_body_expression *target, cwr_func_body_expression *requester)
 {
-    if (statement.with_variable)
+    if (target == NULL)
     {
-        cwr_var_decl_destroy(statement.variable);
+        return true;
     }
 
-    if (statement.with_condition)
+    if (requester == NULL)
     {
-        cwr_expression_destroy(statement.condition);
+        return false;
     }
 
-    if (statement.with_statement)
+    if (target != requester)
     {
-        cwr_statement_destroy(*statement.statement);
-        free(statement.statement);
+        return cwr_func_body_can_access(target, requester->root);
     }
 
-    if (statement.with_body)
+    return true;
+}
+
+static cwr_binary_operator_type cwr_binary_operator_type_from_token(cwr_token_type type)
+{
+    switch (type)
     {
-        cwr_expression_destroy_body(statement.body);
+    case cwr_token_plus_type:
+        return cwr_binary_operator_plus_type;
+    case cwr_token_minus_type:
+        return cwr_binary_operator_minus_type;
+    case cwr_token_asterisk_type:
+        return cwr_binary_operator_multiplicative_type;
+    case cwr_token_slash_type:
+        return cwr_binary_operator_division_type;
+    case cwr_token_exclamation_mark_type:
+        return cwr_binary_operator_negation_type;
+    case cwr_token_equals_type:
+        return cwr_binary_operator_equals_type;
+    case cwr_token_ampersand_type:
+        return cwr_binary_operator_reference_type;
+    case cwr_token_greater_than_type:
+        return cwr_binary_operator_greater_than_type;
+    case cwr_token_less_than_type:
+        return cwr_binary_operator_less_than_type;
+    default:
+        return cwr_binary_operator_none_type;
     }
 }
 
-static void cwr_statement_destroy(cwr_statement statement)
+static bool cwr_value_type_is_integral(cwr_value_type type)
 {
-    switch (statement.type)
+    return type == cwr_value_integer_type || type == cwr_value_character_type;
+}
+
+// Kernel for operands of declared types 'left' and 'right', a unary operator passes its operand twice
+static cwr_binary_kernel_type cwr_binary_kernel_from_types(cwr_value_type left, cwr_value_type right)
+{
+    bool is_left_float = left == cwr_value_float_type;
+    bool is_right_float = right == cwr_value_float_type;
+    if ((!is_left_float && !cwr_value_type_is_integral(left)) || (!is_right_float && !cwr_value_type_is_integral(right)))
     {
-    case cwr_statement_func_decl_type:
-        free(statement.func_decl.name);
-        if (statement.func_decl.count > 0)
-        {
-            for (size_t i = 0; i < statement.func_decl.count; i++)
-            {
-                cwr_argument argument = statement.func_decl.arguments[i];
+        return cwr_binary_kernel_generic_type;
+    }
 
-                free(argument.name);
-                cwr_expression_type_value_destroy(argument.type);
-            }
+    if (is_left_float && is_right_float)
+    {
+        return cwr_binary_kernel_float_type;
+    }
 
-            free(statement.func_decl.arguments);
-        }
+    return is_left_float || is_right_float ? cwr_binary_kernel_mixed_type : cwr_binary_kernel_integer_type;
+}
+
+static bool cwr_binary_operator_is_comparison(cwr_binary_operator_type type)
+{
+    return type == cwr_binary_operator_not_equals_type || type == cwr_binary_operator_equals_type ||
+           type == cwr_binary_operator_greater_than_type || type == cwr_binary_operator_less_than_type ||
+           type == cwr_binary_operator_greater_equals_than_type || type == cwr_binary_operator_less_equals_than_type;
+}
 
-        if (statement.func_decl.with_body)
+// Integers wrap around instead of overflowing and division truncates, false only on division by zero.
+// Comparisons give 0 or 1, operators without arithmetic meaning give 0
+static bool cwr_binary_operator_apply_integer(cwr_binary_operator_type type, int left, int right, int *result)
+{
+    switch (type)
+    {
+    case cwr_binary_operator_plus_type:
+        *result = (int)((unsigned int)left + (unsigned int)right);
+        return true;
+    case cwr_binary_operator_minus_type:
+        *result = (int)((unsigned int)left - (unsigned int)right);
+        return true;
+    case cwr_binary_operator_multiplicative_type:
+        *result = (int)((unsigned int)left * (unsigned int)right);
+        return true;
+    case cwr_binary_operator_division_type:
+        if (right == 0)
         {
-            cwr_func_body_expression_destroy(statement.func_decl.func_body);
+            return false;
         }
 
-        break;
-    case cwr_statement_func_call_type:
-        cwr_statement_destroy_func_call(statement.func_call);
-        break;
-    case cwr_statement_for_loop_type:
-        cwr_statement_destroy_for_loop(statement.for_loop);
-        break;
-    case cwr_statement_return_type:
-        cwr_expression_destroy(statement.ret.value);
+        // The smallest int divided by -1 doesn't fit, it wraps like the other operators
+        *result = right == -1 ? (int)(0u - (unsigned int)left) : left / right;
+        return true;
+    case cwr_binary_operator_not_equals_type:
+        *result = left != right;
+        return true;
+    case cwr_binary_operator_equals_type:
+        *result = left == right;
+        return true;
+    case cwr_binary_operator_greater_than_type:
+        *result = left > right;
+        return true;
+    case cwr_binary_operator_less_than_type:
+        *result = left < right;
+        return true;
+    case cwr_binary_operator_greater_equals_than_type:
+        *result = left >= right;
+        return true;
+    case cwr_binary_operator_less_equals_than_type:
+        *result = left <= right;
+        return true;
+    default:
+        *result = 0;
+        return true;
+    }
+}
 
-        if (statement.ret.with_body)
+// Same as 'cwr_binary_operator_apply_integer' for floats
+static bool cwr_binary_operator_apply_float(cwr_binary_operator_type type, float left, float right, float *result)
+{
+    switch (type)
+    {
+    case cwr_binary_operator_plus_type:
+        *result = left + right;
+        return true;
+    case cwr_binary_operator_minus_type:
+        *result = left - right;
+        return true;
+    case cwr_binary_operator_multiplicative_type:
+        *result = left * right;
+        return true;
+    case cwr_binary_operator_division_type:
+        if (right == 0)
         {
-            cwr_expression_destroy_body(statement.ret.body);
+            return false;
         }
-        break;
-    case cwr_statement_var_decl_type:
-        cwr_var_decl_destroy(statement.var_decl);
-        break;
-    case cwr_statement_if_type:
-        cwr_expression_destroy(statement.if_stat.condition);
-        cwr_func_body_expression_destroy(statement.if_stat.body);
-        break;
-    case cwr_statement_assign_type:
-        cwr_expression_destroy(statement.assign.identifier);
-        cwr_expression_destroy(statement.assign.value);
-        break;
+
+        *result = left / right;
+        return true;
+    case cwr_binary_operator_not_equals_type:
+        *result = left != right;
+        return true;
+    case cwr_binary_operator_equals_type:
+        *result = left == right;
+        return true;
+    case cwr_binary_operator_greater_than_type:
+        *result = left > right;
+        return true;
+    case cwr_binary_operator_less_than_type:
+        *result = left < right;
+        return true;
+    case cwr_binary_operator_greater_equals_than_type:
+        *result = left >= right;
+        return true;
+    case cwr_binary_operator_less_equals_than_type:
+        *result = left <= right;
+        return true;
+    default:
+        *result = 0;
+        return true;
     }
 }
 
-static void cwr_nodes_list_destroy(cwr_nodes_list nodes_list)
+// Minus wraps like 'cwr_binary_operator_apply_integer', negation gives 0 or 1, other operators give back the value
+static int cwr_unary_operator_apply_integer(cwr_binary_operator_type type, int value)
 {
-    for (size_t i = 0; i < nodes_list.count; i++)
+    switch (type)
     {
-        cwr_statement statement = nodes_list.statements[i];
+    case cwr_binary_operator_minus_type:
+        return (int)(0u - (unsigned int)value);
+    case cwr_binary_operator_negation_type:
+        return !value;
+    default:
+        return value;
+    }
+}
 
-        cwr_statement_destroy(statement);
+static float cwr_unary_operator_apply_float(cwr_binary_operator_type type, float value)
+{
+    switch (type)
+    {
+    case cwr_binary_operator_minus_type:
+        return -value;
+    case cwr_binary_operator_negation_type:
+        return !value;
+    default:
+        return value;
     }
+}
 
-    if (nodes_list.statements != NULL)
+static bool cwr_statement_is_block(cwr_statement_type type)
+{
+    switch (type)
     {
-        free(nodes_list.statements);
+    case cwr_statement_for_loop_type:
+    case cwr_statement_if_type:
+        return true;
+    default:
+        return false;
     }
 }
 
+static cwr_float_expression cwr_expression_create_float(float value)
+{
+    return (cwr_float_expression){
+        .value = value};
+}
+
+static cwr_integer_expression cwr_expression_create_integer(int value)
+{
+    return (cwr_integer_expression){
+        .value = value};
+}
+
 #endif // CWR_NODE_H
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef CWR_OPTIMIZER_H
+#define CWR_OPTIMIZER_H
+
+#include <cwr_parser.h>
+
+// Most nodes in the return expression of an inlined function
+#define CWR_OPTIMIZER_INLINE_SIZE 16
+// How many times calls produced by inlining are inlined again
+#define CWR_OPTIMIZER_INLINE_DEPTH 4
+
+typedef struct cwr_optimizer_configuration
+{
+    bool is_inlining;
+    bool is_folding_constants;
+    bool is_eliminating_dead_code;
+} cwr_optimizer_configuration;
+
+static cwr_optimizer_configuration cwr_optimizer_configuration_default()
+{
+    return (cwr_optimizer_configuration){
+        .is_inlining = true,
+        .is_folding_constants = true,
+        .is_eliminating_dead_code = true};
+}
+
+// Rewrites a successful parser result in place, false when out of memory leaves it valid to interpret
+bool cwr_optimizer_optimize(cwr_parser_result *result, cwr_optimizer_configuration *configuration);
+
+// Replaces calls to small non-recursive 'return expr;' functions with their expression
+bool cwr_optimizer_inline_functions(cwr_parser_result *result);
+
+// Replaces operators over number literals with the literal the interpreter would produce
+bool cwr_optimizer_fold_constants(cwr_parser_result *result);
+
+// Drops branches on literal conditions, statements after 'return' and functions unreachable from the entry point
+bool cwr_optimizer_eliminate_dead_code(cwr_parser_result *result);
+
+#endif // CWR_OPTIMIZER_H
\ No newline at end of file
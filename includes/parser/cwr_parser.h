@@ -2,6 +2,13 @@
 #define CWR_PARSER_H
 
 #include <cwr_node.h>
+#include <cwr_arena.h>
+
+#define CWR_PARSER_FUNCTION_CACHE_SIZE 16
+#define CWR_PARSER_FUNCTION_KEY_SIZE 256
+#define CWR_PARSER_DEFAULT_THREADS 4
+// Fewest function bodies worth a thread of their own
+#define CWR_PARSER_THREAD_BODIES 32
 
 #define CWR_PARSER_FAILED_AND_RETURN(parser, type) \
     {                                              \
@@ -19,15 +26,43 @@
         }                                      \
     }
 
+#define CWR_PARSER_FAILED_AND_RETURN_INDEX(parser) \
+    {                                              \
+        if (parser->is_failed)                     \
+        {                                          \
+            return CWR_EXPRESSION_INDEX_NONE;      \
+        }                                          \
+    }
+
 typedef struct cwr_parser cwr_parser;
 
+// Function bodies skipped in lazy mode, parsed on first use by 'cwr_parser_parse_lazy_body'
+typedef struct cwr_parser_lazy cwr_parser_lazy;
+
+typedef struct cwr_parser_configuration
+{
+    // Function bodies are skipped while reading declarations and parsed afterwards on up to this many threads,
+    // 1 parses every body in place
+    size_t threads;
+    // Function bodies are skipped and only parsed when first used, so their errors are reported then.
+    // Tokens must outlive the result
+    bool is_lazy;
+} cwr_parser_configuration;
+
+static cwr_parser_configuration cwr_parser_configuration_default()
+{
+    return (cwr_parser_configuration){
+        .threads = CWR_PARSER_DEFAULT_THREADS,
+        .is_lazy = false};
+}
+
 typedef struct cwr_parser_variable
 {
     size_t identifier;
     char *name;
     cwr_func_body_expression *root;
-    cwr_expression_type_value type;
-    cwr_expression *static_value;
+    const cwr_expression_type_value *type;
+    cwr_expression_index static_value;
 } cwr_parser_variable;
 
 typedef struct cwr_parser_function
@@ -36,24 +71,34 @@ typedef struct cwr_parser_function
     char *name;
     cwr_argument *arguments;
     size_t count;
-    cwr_expression_type_value return_type;
+    const cwr_expression_type_value *return_type;
 } cwr_parser_function;
 
 typedef struct cwr_parser_result
 {
+    cwr_arena *arena;
     cwr_nodes_list nodes_list;
     cwr_parser_variable *global_variables;
     size_t global_variables_count;
     cwr_parser_function *functions;
     size_t functions_count;
+    // NULL unless a body was skipped in lazy mode
+    cwr_parser_lazy *lazy;
+    // Mapped cache file holding the statements and tables, NULL unless loaded by 'cwr_cache_load'
+    void *image;
+    size_t image_size;
     cwr_parser_error error;
     bool is_failed;
 } cwr_parser_result;
 
-cwr_parser *cwr_parser_create(cwr_tokens_list tokens_list);
+cwr_parser *cwr_parser_create(cwr_tokens_list tokens_list, cwr_parser_configuration *configuration);
 
 cwr_parser_result cwr_parser_parse(cwr_parser *parser);
 
+// Parses the body of the function with 'function' identifier when first asked, later calls return the same body.
+// Expressions go to the pool of the result, so it is not safe to call while another thread reads that pool
+bool cwr_parser_parse_lazy_body(cwr_parser_lazy *lazy, size_t function, cwr_func_body_expression *body, size_t *frame_size, cwr_parser_error *error);
+
 cwr_statement_type cwr_parser_get_statement(cwr_parser *parser);
 
 bool cwr_parser_add_statement(cwr_parser *parser, cwr_statement node);
@@ -74,9 +119,9 @@ cwr_statement cwr_parser_parse_only_statement(cwr_parser *parser);
 
 cwr_assign_statement cwr_parser_parse_assign(cwr_parser *parser);
 
-cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser, cwr_expression_type_value type);
+cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser, const cwr_expression_type_value *type);
 
-cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser, cwr_expression_type_value type);
+cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser, const cwr_expression_type_value *type);
 
 cwr_if_statement cwr_parser_parse_if(cwr_parser *parser);
 
@@ -84,25 +129,21 @@ cwr_for_loop_statement cwr_parser_parse_for_loop(cwr_parser *parser);
 
 cwr_func_call_statement cwr_parser_parse_function_call(cwr_parser *parser);
 
-cwr_return_statement cwr_parser_parse_return(cwr_parser *parser, cwr_expression_type_value type);
+cwr_return_statement cwr_parser_parse_return(cwr_parser *parser, const cwr_expression_type_value *type);
 
 void cwr_parser_parse_function_body_by_created(cwr_parser *parser, cwr_func_body_expression *body);
 
 cwr_func_body_expression cwr_parser_parse_function_body(cwr_parser *parser);
 
-cwr_expression_type_value cwr_parser_parse_type(cwr_parser *parser);
-
-cwr_expression cwr_parser_parse_binary(cwr_parser *parser);
-
-cwr_expression cwr_parser_parse_multiplicative(cwr_parser *parser);
+const cwr_expression_type_value *cwr_parser_parse_type(cwr_parser *parser);
 
-cwr_expression cwr_parser_parse_unary(cwr_parser *parser, bool only_value);
+cwr_expression_index cwr_parser_parse_binary(cwr_parser *parser);
 
-cwr_expression cwr_parser_parse_array_element(cwr_parser *parser);
+cwr_expression_index cwr_parser_parse_unary(cwr_parser *parser, bool only_value);
 
-cwr_expression cwr_parser_parse_value(cwr_parser *parser);
+cwr_expression_index cwr_parser_parse_value(cwr_parser *parser);
 
-bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression *argument, size_t count, cwr_parser_function *function);
+bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression_index *argument, size_t count, cwr_parser_function *function);
 
 bool cwr_parser_get_variable(cwr_parser *parser, char *name, cwr_parser_variable *variable);
 
@@ -0,0 +1,83 @@
+#ifndef CWR_TYPE_H
+#define CWR_TYPE_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define CWR_TYPE_TABLE_DEFAULT_SIZE 64
+
+typedef enum cwr_value_type
+{
+    cwr_value_character_type,
+    cwr_value_float_type,
+    cwr_value_integer_type,
+    cwr_value_structure_type,
+    cwr_value_array_type,
+    cwr_value_pointer_type,
+    cwr_value_void_type
+} cwr_value_type;
+
+typedef struct cwr_expression_type_value cwr_expression_type_value;
+
+// Interned by 'cwr_type_intern', so equal types are the same pointer for the whole process
+typedef struct cwr_expression_type_value
+{
+    cwr_value_type value_type;
+    // Literals use 0 and declarations -1, as both are kept apart by 'cwr_type_equals'
+    int identifier;
+    char *name;
+    const cwr_expression_type_value *target_type;
+} cwr_expression_type_value;
+
+// Returns the single instance of 'type', whose target is interned already, or NULL when out of memory
+const cwr_expression_type_value *cwr_type_intern(cwr_expression_type_value type);
+
+// Scalar type of literals
+const cwr_expression_type_value *cwr_type_from(cwr_value_type value_type);
+
+const cwr_expression_type_value *cwr_type_pointer(const cwr_expression_type_value *target);
+
+const cwr_expression_type_value *cwr_type_array(const cwr_expression_type_value *target);
+
+// Whether a value of 'target' type fits where 'type' is expected
+static bool cwr_type_equals(const cwr_expression_type_value *type, const cwr_expression_type_value *target)
+{
+    if (type == target)
+    {
+        return true;
+    }
+
+    if (type->value_type == cwr_value_array_type)
+    {
+        if (target->value_type != cwr_value_array_type)
+        {
+            return false;
+        }
+
+        return cwr_type_equals(type->target_type, target->target_type);
+    }
+
+    if (type->value_type == cwr_value_pointer_type)
+    {
+        if (target->value_type != cwr_value_array_type && target->value_type != cwr_value_pointer_type)
+        {
+            return false;
+        }
+
+        return cwr_type_equals(type->target_type, target->target_type);
+    }
+
+    if (type->identifier != -1)
+    {
+        return type->identifier == target->identifier && type->value_type == target->value_type;
+    }
+
+    if (type->value_type == cwr_value_float_type && target->value_type == cwr_value_integer_type)
+    {
+        return true;
+    }
+
+    return type->value_type == target->value_type;
+}
+
+#endif // CWR_TYPE_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef CWR_WALKER_H
+#define CWR_WALKER_H
+
+#include <cwr_node.h>
+
+// Returning false from a visitor stops the walk
+typedef bool (*cwr_walker_expression_visitor)(cwr_expression_pool *pool, cwr_expression_index index, void *context);
+
+// 'body' is the body holding 'statement', NULL for top level and for loop step statements
+typedef bool (*cwr_walker_statement_visitor)(cwr_statement *statement, cwr_func_body_expression *body, void *context);
+
+// Post-order walks over explicit heap stacks, so depth of the tree is bound by memory and not by the C stack.
+// A walker can be reused and visitors may start nested walks with the same walker
+typedef struct cwr_walker cwr_walker;
+
+cwr_walker *cwr_walker_create();
+
+// Visits children before their parent, left to right
+bool cwr_walker_walk_expression(cwr_walker *walker, cwr_expression_pool *pool, cwr_expression_index root, cwr_walker_expression_visitor visitor, void *context);
+
+// Visits statements of nested bodies before the statement owning them
+bool cwr_walker_walk_statements(cwr_walker *walker, cwr_statement *statements, size_t count, cwr_func_body_expression *body, cwr_walker_statement_visitor visitor, void *context);
+
+// Walks every expression tree used directly by 'statement', nested bodies are not entered
+bool cwr_walker_walk_statement_expressions(cwr_walker *walker, cwr_expression_pool *pool, cwr_statement *statement, cwr_walker_expression_visitor visitor, void *context);
+
+void cwr_walker_destroy(cwr_walker *walker);
+
+#endif // CWR_WALKER_H
\ No newline at end of file
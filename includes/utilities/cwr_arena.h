@@ -0,0 +1,25 @@
+#ifndef CWR_ARENA_H
+#define CWR_ARENA_H
+
+#include <stdlib.h>
+
+#define CWR_ARENA_BLOCK_SIZE 65536
+
+typedef struct cwr_arena cwr_arena;
+
+cwr_arena *cwr_arena_create();
+
+void *cwr_arena_allocate(cwr_arena *arena, size_t size);
+
+void *cwr_arena_copy(cwr_arena *arena, const void *source, size_t size);
+
+char *cwr_arena_duplicate(cwr_arena *arena, const char *source);
+
+size_t cwr_arena_size(cwr_arena *arena);
+
+// Takes every block of 'source' and destroys it, allocations from it stay valid for the lifetime of 'arena'
+void cwr_arena_merge(cwr_arena *arena, cwr_arena *source);
+
+void cwr_arena_destroy(cwr_arena *arena);
+
+#endif // CWR_ARENA_H
\ No newline at end of file
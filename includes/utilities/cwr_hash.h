@@ -0,0 +1,28 @@
+#ifndef CWR_HASH_H
+#define CWR_HASH_H
+
+#include <stdlib.h>
+
+#define CWR_HASH_OFFSET_BASIS ((size_t)14695981039346656037ULL)
+#define CWR_HASH_PRIME ((size_t)1099511628211ULL)
+
+// FNV-1a, continues from 'hash' so keys can be hashed in parts
+static inline size_t cwr_hash_continue(size_t hash, const void *source, size_t length)
+{
+    const unsigned char *bytes = source;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= CWR_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+static inline size_t cwr_hash_bytes(const void *source, size_t length)
+{
+    return cwr_hash_continue(CWR_HASH_OFFSET_BASIS, source, length);
+}
+
+#endif // CWR_HASH_H
\ No newline at end of file
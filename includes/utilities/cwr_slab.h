@@ -0,0 +1,30 @@
+#ifndef CWR_SLAB_H
+#define CWR_SLAB_H
+
+#include <stdlib.h>
+
+#define CWR_SLAB_BLOCK_SIZE 65536
+// Sizes are rounded up to a multiple of this, one free list for each class
+#define CWR_SLAB_CLASS_SIZE 16
+
+// Defined as 0 everything goes to malloc, so address sanitizers see every value
+#ifndef CWR_SLAB_CLASSES
+#define CWR_SLAB_CLASSES 16
+#endif
+
+// Small allocations with a free list for each size class, carved from blocks that are only freed with the slab.
+// Larger sizes go to malloc. Not thread safe, one for each interpreter
+typedef struct cwr_slab cwr_slab;
+
+cwr_slab *cwr_slab_create();
+
+void *cwr_slab_allocate(cwr_slab *slab, size_t size);
+
+// 'size' must be the one 'pointer' was allocated with
+void cwr_slab_free(cwr_slab *slab, void *pointer, size_t size);
+
+size_t cwr_slab_size(cwr_slab *slab);
+
+void cwr_slab_destroy(cwr_slab *slab);
+
+#endif // CWR_SLAB_H
\ No newline at end of file
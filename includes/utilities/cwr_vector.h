@@ -0,0 +1,60 @@
+#ifndef CWR_VECTOR_H
+#define CWR_VECTOR_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define CWR_VECTOR_DEFAULT_SIZE 8
+
+// Grows 'buffer' geometrically so 'count' more elements fit after 'capacity' used ones
+#define CWR_VECTOR_RESERVE(buffer, size, capacity, count) \
+    cwr_vector_reserve((void **)&(buffer), &(size), (capacity), (count), sizeof(*(buffer)))
+
+// Shrinks 'buffer' to exactly 'capacity' elements once nothing more will be added
+#define CWR_VECTOR_TRIM(buffer, size, capacity) \
+    cwr_vector_trim((void **)&(buffer), &(size), (capacity), sizeof(*(buffer)))
+
+// 'size' is the allocated element count, 'capacity' the used one, as in 'cwr_scope'
+static inline bool cwr_vector_reserve(void **buffer, size_t *size, size_t capacity, size_t count, size_t element_size)
+{
+    if (capacity + count <= *size)
+    {
+        return true;
+    }
+
+    size_t target = *size == 0 ? CWR_VECTOR_DEFAULT_SIZE : *size;
+    while (target < capacity + count)
+    {
+        target *= 2;
+    }
+
+    void *result = realloc(*buffer, target * element_size);
+    if (result == NULL)
+    {
+        return false;
+    }
+
+    *buffer = result;
+    *size = target;
+    return true;
+}
+
+static inline void cwr_vector_trim(void **buffer, size_t *size, size_t capacity, size_t element_size)
+{
+    if (capacity == 0 || capacity >= *size)
+    {
+        return;
+    }
+
+    // Keeping the larger buffer is fine when shrinking fails
+    void *result = realloc(*buffer, capacity * element_size);
+    if (result == NULL)
+    {
+        return;
+    }
+
+    *buffer = result;
+    *size = capacity;
+}
+
+#endif // CWR_VECTOR_H
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <cwr_arena.h>
+
+#define CWR_ARENA_ALIGNMENT _Alignof(max_align_t)
+
+typedef struct cwr_arena_block cwr_arena_block;
+
+typedef struct cwr_arena_block
+{
+    cwr_arena_block *previous;
+    size_t size;
+    size_t used;
+    char data[];
+} cwr_arena_block;
+
+typedef struct cwr_arena
+{
+    cwr_arena_block *block;
+    size_t allocated;
+} cwr_arena;
+
+static cwr_arena_block *cwr_arena_add_block(cwr_arena *arena, size_t size)
+{
+    if (size < CWR_ARENA_BLOCK_SIZE)
+    {
+        size = CWR_ARENA_BLOCK_SIZE;
+    }
+
+    cwr_arena_block *block = malloc(sizeof(cwr_arena_block) + size);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+
+    block->previous = arena->block;
+    block->size = size;
+    block->used = 0;
+
+    arena->block = block;
+    arena->allocated += size;
+    return block;
+}
+
+cwr_arena *cwr_arena_create()
+{
+    cwr_arena *arena = malloc(sizeof(cwr_arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->block = NULL;
+    arena->allocated = 0;
+    return arena;
+}
+
+void *cwr_arena_allocate(cwr_arena *arena, size_t size)
+{
+    cwr_arena_block *block = arena->block;
+
+    if (block != NULL)
+    {
+        uintptr_t address = (uintptr_t)(block->data + block->used);
+        size_t padding = (CWR_ARENA_ALIGNMENT - address % CWR_ARENA_ALIGNMENT) % CWR_ARENA_ALIGNMENT;
+
+        if (block->used + padding + size <= block->size)
+        {
+            void *result = block->data + block->used + padding;
+
+            block->used += padding + size;
+            return result;
+        }
+    }
+
+    block = cwr_arena_add_block(arena, size + CWR_ARENA_ALIGNMENT);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+
+    uintptr_t address = (uintptr_t)block->data;
+    size_t padding = (CWR_ARENA_ALIGNMENT - address % CWR_ARENA_ALIGNMENT) % CWR_ARENA_ALIGNMENT;
+
+    block->used = padding + size;
+    return block->data + padding;
+}
+
+void *cwr_arena_copy(cwr_arena *arena, const void *source, size_t size)
+{
+    void *target = cwr_arena_allocate(arena, size);
+    if (target == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(target, source, size);
+    return target;
+}
+
+char *cwr_arena_duplicate(cwr_arena *arena, const char *source)
+{
+    return cwr_arena_copy(arena, source, strlen(source) + 1);
+}
+
+size_t cwr_arena_size(cwr_arena *arena)
+{
+    return arena->allocated;
+}
+
+void cwr_arena_merge(cwr_arena *arena, cwr_arena *source)
+{
+    cwr_arena_block *oldest = source->block;
+    if (oldest != NULL)
+    {
+        while (oldest->previous != NULL)
+        {
+            oldest = oldest->previous;
+        }
+
+        // Blocks of 'source' go under the current one, so its free space is still used first
+        if (arena->block == NULL)
+        {
+            arena->block = source->block;
+        }
+        else
+        {
+            oldest->previous = arena->block->previous;
+            arena->block->previous = source->block;
+        }
+
+        arena->allocated += source->allocated;
+    }
+
+    free(source);
+}
+
+void cwr_arena_destroy(cwr_arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    cwr_arena_block *block = arena->block;
+    while (block != NULL)
+    {
+        cwr_arena_block *previous = block->previous;
+
+        free(block);
+        block = previous;
+    }
+
+    free(arena);
+}
\ No newline at end of file
@@ -0,0 +1,853 @@
+#include <stdlib.h>
+#include <string.h>
+#include <cwr_bytecode.h>
+#include <cwr_hash.h>
+
+#define CWR_BYTECODE_ANY_REGISTER SIZE_MAX
+#define CWR_BYTECODE_CONSTANTS_DEFAULT_SIZE 16
+
+typedef struct cwr_bytecode_compiler
+{
+    const cwr_expression_pool *pool;
+    cwr_bytecode_function *function;
+    bool *references;
+    // Open addressed, holds constant positions plus one, 0 when free
+    size_t *constants;
+    size_t constants_size;
+    size_t top;
+    size_t *exits;
+    size_t exits_size;
+    size_t exits_capacity;
+    size_t exits_base;
+    bool is_in_return_body;
+    // Expressions being compiled, so their depth is bound by memory and not by the C stack
+    struct cwr_bytecode_task *tasks;
+    size_t tasks_size;
+    size_t tasks_capacity;
+    cwr_interpreter_error *error;
+} cwr_bytecode_compiler;
+
+typedef struct cwr_bytecode_task
+{
+    cwr_expression_index index;
+    // Set once the task compiles a call, from the expression or from a statement
+    bool is_call;
+    cwr_func_call_statement call;
+    cwr_instruction_type instruction;
+    cwr_location location;
+    size_t target;
+    size_t top;
+    // First argument register of a call, register of the left operand otherwise
+    size_t base;
+    // Children compiled so far
+    size_t stage;
+} cwr_bytecode_task;
+
+static void cwr_bytecode_compile_body(cwr_bytecode_compiler *compiler, cwr_func_body_expression body);
+
+static bool cwr_bytecode_is_reference(const cwr_expression_type_value *type)
+{
+    return type->value_type == cwr_value_array_type || type->value_type == cwr_value_pointer_type;
+}
+
+static void cwr_bytecode_throw_out_of_memory(cwr_bytecode_compiler *compiler, cwr_location location)
+{
+    if (!compiler->error->is_failed)
+    {
+        cwr_interpreter_error_throw_out_of_memory(compiler->error, location);
+    }
+}
+
+static size_t cwr_bytecode_emit(cwr_bytecode_compiler *compiler, cwr_instruction instruction, cwr_location location)
+{
+    cwr_bytecode_function *function = compiler->function;
+    if (compiler->error->is_failed)
+    {
+        return 0;
+    }
+
+    if (function->capacity == function->size)
+    {
+        size_t size = function->size == 0 ? CWR_VECTOR_DEFAULT_SIZE : function->size * 2;
+
+        cwr_instruction *instructions = realloc(function->instructions, size * sizeof(cwr_instruction));
+        if (instructions == NULL)
+        {
+            cwr_bytecode_throw_out_of_memory(compiler, location);
+            return 0;
+        }
+
+        function->instructions = instructions;
+
+        cwr_location *locations = realloc(function->locations, size * sizeof(cwr_location));
+        if (locations == NULL)
+        {
+            cwr_bytecode_throw_out_of_memory(compiler, location);
+            return 0;
+        }
+
+        function->locations = locations;
+        function->size = size;
+    }
+
+    function->instructions[function->capacity] = instruction;
+    function->locations[function->capacity] = location;
+    return function->capacity++;
+}
+
+static void cwr_bytecode_patch(cwr_bytecode_compiler *compiler, size_t position)
+{
+    if (!compiler->error->is_failed)
+    {
+        compiler->function->instructions[position].index = (uint32_t)compiler->function->capacity;
+    }
+}
+
+static size_t cwr_bytecode_reserve(cwr_bytecode_compiler *compiler, size_t top, size_t count, cwr_location location)
+{
+    compiler->top = top + count;
+    if (compiler->top > compiler->function->registers)
+    {
+        compiler->function->registers = compiler->top;
+    }
+
+    if (compiler->top > CWR_BYTECODE_MAX_REGISTERS && !compiler->error->is_failed)
+    {
+        cwr_interpreter_error_throw(compiler->error, cwr_interpreter_error_out_of_memory_type, "Function needs too many registers", location);
+    }
+
+    return top;
+}
+
+static size_t cwr_bytecode_target(cwr_bytecode_compiler *compiler, size_t target, size_t top, cwr_location location)
+{
+    if (target != CWR_BYTECODE_ANY_REGISTER)
+    {
+        compiler->top = top;
+        return target;
+    }
+
+    return cwr_bytecode_reserve(compiler, top, 1, location);
+}
+
+static size_t cwr_bytecode_place(cwr_bytecode_compiler *compiler, size_t source, size_t target, cwr_location location)
+{
+    if (target == CWR_BYTECODE_ANY_REGISTER || target == source)
+    {
+        return source;
+    }
+
+    cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_move_type,
+        .a = (uint16_t)target,
+        .b = (uint16_t)source}, location);
+    return target;
+}
+
+static size_t cwr_bytecode_hash_constant(cwr_tagged_value value)
+{
+    size_t hash = cwr_hash_bytes(&value.type, sizeof(value.type));
+    return cwr_hash_continue(hash, &value.integer_n, sizeof(value.integer_n));
+}
+
+static bool cwr_bytecode_grow_constants(cwr_bytecode_compiler *compiler)
+{
+    size_t size = compiler->constants_size == 0 ? CWR_BYTECODE_CONSTANTS_DEFAULT_SIZE : compiler->constants_size * 2;
+
+    size_t *constants = calloc(size, sizeof(size_t));
+    if (constants == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < compiler->function->constants_capacity; i++)
+    {
+        size_t position = cwr_bytecode_hash_constant(compiler->function->constants[i]) & (size - 1);
+        while (constants[position] != 0)
+        {
+            position = (position + 1) & (size - 1);
+        }
+
+        constants[position] = i + 1;
+    }
+
+    free(compiler->constants);
+    compiler->constants = constants;
+    compiler->constants_size = size;
+    return true;
+}
+
+static size_t cwr_bytecode_add_constant(cwr_bytecode_compiler *compiler, cwr_tagged_value value)
+{
+    cwr_bytecode_function *function = compiler->function;
+    if ((function->constants_capacity + 1) * 2 > compiler->constants_size && !cwr_bytecode_grow_constants(compiler))
+    {
+        return SIZE_MAX;
+    }
+
+    size_t position = cwr_bytecode_hash_constant(value) & (compiler->constants_size - 1);
+    for (; compiler->constants[position] != 0; position = (position + 1) & (compiler->constants_size - 1))
+    {
+        cwr_tagged_value constant = function->constants[compiler->constants[position] - 1];
+        if (constant.type == value.type && constant.integer_n == value.integer_n)
+        {
+            return compiler->constants[position] - 1;
+        }
+    }
+
+    if (!CWR_VECTOR_RESERVE(function->constants, function->constants_size, function->constants_capacity, 1))
+    {
+        return SIZE_MAX;
+    }
+
+    compiler->constants[position] = function->constants_capacity + 1;
+    function->constants[function->constants_capacity] = value;
+    return function->constants_capacity++;
+}
+
+static cwr_tagged_value cwr_bytecode_literal(const cwr_expression *expression)
+{
+    switch (expression->type)
+    {
+    case cwr_expression_float_type:
+        return cwr_tagged_value_float(expression->float_n.value);
+    case cwr_expression_character_type:
+        return cwr_tagged_value_character(expression->character.value);
+    default:
+        return cwr_tagged_value_integer(expression->integer_n.value);
+    }
+}
+
+static bool cwr_bytecode_is_literal(const cwr_expression *expression)
+{
+    return expression->type == cwr_expression_float_type || expression->type == cwr_expression_integer_type ||
+           expression->type == cwr_expression_character_type;
+}
+
+static bool cwr_bytecode_collect_constant(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    const cwr_expression *expression = cwr_expression_pool_get(pool, index);
+    if (!cwr_bytecode_is_literal(expression))
+    {
+        return true;
+    }
+
+    return cwr_bytecode_add_constant(context, cwr_bytecode_literal(expression)) != SIZE_MAX;
+}
+
+static void cwr_bytecode_mark_slot(cwr_bytecode_compiler *compiler, cwr_var_decl_statement statement)
+{
+    if (cwr_bytecode_is_reference(statement.value_type))
+    {
+        compiler->references[statement.identifier] = true;
+        compiler->function->with_references = true;
+    }
+}
+
+typedef struct cwr_bytecode_scan
+{
+    cwr_bytecode_compiler *compiler;
+    cwr_walker *walker;
+} cwr_bytecode_scan;
+
+static bool cwr_bytecode_scan_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    (void)body;
+    cwr_bytecode_scan *scan = context;
+
+    switch (statement->type)
+    {
+    case cwr_statement_var_decl_type:
+        cwr_bytecode_mark_slot(scan->compiler, statement->var_decl);
+        break;
+    case cwr_statement_for_loop_type:
+        if (statement->for_loop.with_variable)
+        {
+            cwr_bytecode_mark_slot(scan->compiler, statement->for_loop.variable);
+        }
+
+        break;
+    default:
+        break;
+    }
+
+    return cwr_walker_walk_statement_expressions(scan->walker, (cwr_expression_pool *)scan->compiler->pool, statement, cwr_bytecode_collect_constant, scan->compiler);
+}
+
+static size_t cwr_bytecode_constant(cwr_bytecode_compiler *compiler, const cwr_expression *expression)
+{
+    return compiler->function->frame_size + cwr_bytecode_add_constant(compiler, cwr_bytecode_literal(expression));
+}
+
+static bool cwr_bytecode_push_task(cwr_bytecode_compiler *compiler, cwr_bytecode_task task)
+{
+    if (!CWR_VECTOR_RESERVE(compiler->tasks, compiler->tasks_size, compiler->tasks_capacity, 1))
+    {
+        cwr_bytecode_throw_out_of_memory(compiler, task.location);
+        return false;
+    }
+
+    compiler->tasks[compiler->tasks_capacity++] = task;
+    return true;
+}
+
+// Gives false with the next argument in 'child' until every one is compiled, then emits the call
+static bool cwr_bytecode_step_call(cwr_bytecode_compiler *compiler, cwr_bytecode_task *task, size_t *result, cwr_expression_index *child, size_t *child_target)
+{
+    cwr_bytecode_function *function = compiler->function;
+    cwr_func_call_statement call = task->call;
+    cwr_location location = task->location;
+
+    if (task->stage == 0)
+    {
+        task->base = cwr_bytecode_reserve(compiler, task->top, call.count > 0 ? call.count : 1, location);
+    }
+    else
+    {
+        compiler->top = task->base + call.count;
+    }
+
+    if (task->stage < call.count)
+    {
+        *child = cwr_expression_pool_argument(compiler->pool, call.arguments, task->stage);
+        *child_target = task->base + task->stage;
+        task->stage++;
+        return false;
+    }
+
+    size_t base = task->base;
+    if (!CWR_VECTOR_RESERVE(function->calls, function->calls_size, function->calls_capacity, 1))
+    {
+        cwr_bytecode_throw_out_of_memory(compiler, location);
+        *result = base;
+        return true;
+    }
+
+    function->calls[function->calls_capacity] = (cwr_bytecode_call){
+        .function = call.identifier,
+        .count = (uint16_t)call.count,
+        .location = location};
+
+    cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = task->instruction,
+        .a = (uint16_t)base,
+        .index = (uint32_t)function->calls_capacity++}, location);
+
+    if (task->target == CWR_BYTECODE_ANY_REGISTER)
+    {
+        compiler->top = base + 1;
+        *result = base;
+        return true;
+    }
+
+    compiler->top = task->top;
+    *result = cwr_bytecode_place(compiler, base, task->target, location);
+    return true;
+}
+
+static cwr_instruction_type cwr_bytecode_specialize(cwr_instruction_type type, cwr_binary_kernel_type kernel)
+{
+    switch (kernel)
+    {
+    case cwr_binary_kernel_integer_type:
+        return type + 1;
+    case cwr_binary_kernel_float_type:
+        return type + 2;
+    default:
+        return type;
+    }
+}
+
+static cwr_instruction_type cwr_bytecode_binary_instruction(cwr_binary_operator_type type, cwr_binary_kernel_type kernel)
+{
+    switch (type)
+    {
+    case cwr_binary_operator_plus_type:
+        return cwr_bytecode_specialize(cwr_instruction_add_type, kernel);
+    case cwr_binary_operator_minus_type:
+        return cwr_bytecode_specialize(cwr_instruction_subtract_type, kernel);
+    case cwr_binary_operator_multiplicative_type:
+        return cwr_bytecode_specialize(cwr_instruction_multiply_type, kernel);
+    case cwr_binary_operator_division_type:
+        return cwr_bytecode_specialize(cwr_instruction_divide_type, kernel);
+    case cwr_binary_operator_equals_type:
+        return cwr_bytecode_specialize(cwr_instruction_equals_type, kernel);
+    case cwr_binary_operator_not_equals_type:
+        return cwr_bytecode_specialize(cwr_instruction_not_equals_type, kernel);
+    case cwr_binary_operator_greater_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_greater_type, kernel);
+    case cwr_binary_operator_less_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_less_type, kernel);
+    case cwr_binary_operator_greater_equals_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_greater_equals_type, kernel);
+    case cwr_binary_operator_less_equals_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_less_equals_type, kernel);
+    default:
+        return cwr_instruction_zero_type;
+    }
+}
+
+static cwr_instruction_type cwr_bytecode_branch_instruction(cwr_binary_operator_type type, cwr_binary_kernel_type kernel)
+{
+    switch (type)
+    {
+    case cwr_binary_operator_equals_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_equals_type, kernel);
+    case cwr_binary_operator_not_equals_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_not_equals_type, kernel);
+    case cwr_binary_operator_greater_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_greater_type, kernel);
+    case cwr_binary_operator_less_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_less_type, kernel);
+    case cwr_binary_operator_greater_equals_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_greater_equals_type, kernel);
+    case cwr_binary_operator_less_equals_than_type:
+        return cwr_bytecode_specialize(cwr_instruction_jump_not_less_equals_type, kernel);
+    default:
+        return cwr_instruction_move_type;
+    }
+}
+
+// Gives false with the next child to compile in 'child', 'result' then holds its register on the next step
+static bool cwr_bytecode_step(cwr_bytecode_compiler *compiler, cwr_bytecode_task *task, size_t *result, cwr_expression_index *child, size_t *child_target)
+{
+    if (task->is_call)
+    {
+        return cwr_bytecode_step_call(compiler, task, result, child, child_target);
+    }
+
+    const cwr_expression *expression = cwr_expression_pool_get(compiler->pool, task->index);
+    cwr_location location = task->location;
+    size_t target = task->target;
+    size_t top = task->top;
+
+    switch (expression->type)
+    {
+    case cwr_expression_var_type:
+        *result = cwr_bytecode_place(compiler, expression->var.identifier, target, location);
+        return true;
+    case cwr_expression_float_type:
+    case cwr_expression_integer_type:
+    case cwr_expression_character_type:
+        *result = cwr_bytecode_place(compiler, cwr_bytecode_constant(compiler, expression), target, location);
+        return true;
+    case cwr_expression_string_type:
+        *result = cwr_bytecode_target(compiler, target, top, location);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_load_string_type,
+            .a = (uint16_t)*result,
+            .index = task->index}, location);
+        return true;
+    case cwr_expression_func_call_type:
+        task->is_call = true;
+        task->call = expression->func_call;
+        task->instruction = cwr_instruction_call_type;
+        return cwr_bytecode_step_call(compiler, task, result, child, child_target);
+    case cwr_expression_unary_type:
+    {
+        if (task->stage++ == 0)
+        {
+            *child = expression->unary.child;
+            return false;
+        }
+
+        cwr_instruction_type type;
+        switch (expression->unary.type)
+        {
+        case cwr_binary_operator_minus_type:
+            type = cwr_instruction_negate_type;
+            break;
+        case cwr_binary_operator_negation_type:
+            type = cwr_instruction_not_type;
+            break;
+        case cwr_binary_operator_reference_type:
+            type = cwr_instruction_reference_type;
+            break;
+        case cwr_binary_operator_dereference_type:
+            type = cwr_instruction_dereference_type;
+            break;
+        default:
+            *result = cwr_bytecode_place(compiler, *result, target, location);
+            return true;
+        }
+
+        size_t value = *result;
+        *result = cwr_bytecode_target(compiler, target, top, location);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = type,
+            .a = (uint16_t)*result,
+            .b = (uint16_t)value,
+            .c = (uint16_t)expression->unary.kernel}, location);
+        return true;
+    }
+    case cwr_expression_binary_type:
+    case cwr_expression_array_element_type:
+    {
+        bool is_binary = expression->type == cwr_expression_binary_type;
+        const cwr_expression_index *children = is_binary ? expression->binary.children : expression->array_element.children;
+
+        if (task->stage < 2)
+        {
+            if (task->stage == 1)
+            {
+                task->base = *result;
+            }
+
+            *child = children[task->stage++];
+            return false;
+        }
+
+        size_t right = *result;
+        // Operands are read before the result is written, so it can reuse either register
+        *result = cwr_bytecode_target(compiler, target, top, location);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = is_binary ? cwr_bytecode_binary_instruction(expression->binary.type, expression->binary.kernel) : cwr_instruction_element_type,
+            .a = (uint16_t)*result,
+            .b = (uint16_t)task->base,
+            .c = (uint16_t)right}, location);
+        return true;
+    }
+    }
+
+    // Reported only when reached, like the tree walker does
+    *result = cwr_bytecode_target(compiler, target, top, location);
+    cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_fail_type,
+        .a = (uint16_t)*result}, location);
+    return true;
+}
+
+// Runs the tasks above 'base' and gives the register of the first one
+static size_t cwr_bytecode_run(cwr_bytecode_compiler *compiler, size_t base)
+{
+    size_t result = 0;
+    while (compiler->tasks_capacity > base && !compiler->error->is_failed)
+    {
+        cwr_bytecode_task *task = &compiler->tasks[compiler->tasks_capacity - 1];
+        if (task->stage == 0)
+        {
+            task->top = compiler->top;
+        }
+
+        cwr_expression_index child;
+        size_t child_target = CWR_BYTECODE_ANY_REGISTER;
+        if (cwr_bytecode_step(compiler, task, &result, &child, &child_target))
+        {
+            compiler->tasks_capacity--;
+            continue;
+        }
+
+        cwr_bytecode_push_task(compiler, (cwr_bytecode_task){
+                                             .index = child,
+                                             .location = cwr_expression_pool_location(compiler->pool, child),
+                                             .target = child_target});
+    }
+
+    compiler->tasks_capacity = base;
+    return result;
+}
+
+static size_t cwr_bytecode_compile_expression(cwr_bytecode_compiler *compiler, cwr_expression_index index, size_t target)
+{
+    size_t base = compiler->tasks_capacity;
+    cwr_bytecode_push_task(compiler, (cwr_bytecode_task){
+                                         .index = index,
+                                         .location = cwr_expression_pool_location(compiler->pool, index),
+                                         .target = target});
+    return cwr_bytecode_run(compiler, base);
+}
+
+static size_t cwr_bytecode_compile_call(cwr_bytecode_compiler *compiler, cwr_func_call_statement call, cwr_instruction_type instruction, cwr_location location, size_t target)
+{
+    size_t base = compiler->tasks_capacity;
+    cwr_bytecode_push_task(compiler, (cwr_bytecode_task){
+                                         .is_call = true,
+                                         .call = call,
+                                         .instruction = instruction,
+                                         .location = location,
+                                         .target = target});
+    return cwr_bytecode_run(compiler, base);
+}
+
+static size_t cwr_bytecode_compile_condition(cwr_bytecode_compiler *compiler, cwr_expression_index condition, cwr_location location)
+{
+    const cwr_expression *expression = cwr_expression_pool_get(compiler->pool, condition);
+    size_t top = compiler->top;
+
+    cwr_instruction_type branch = expression->type == cwr_expression_binary_type ? cwr_bytecode_branch_instruction(expression->binary.type, expression->binary.kernel) : cwr_instruction_move_type;
+    if (branch != cwr_instruction_move_type)
+    {
+        size_t left = cwr_bytecode_compile_expression(compiler, expression->binary.children[0], CWR_BYTECODE_ANY_REGISTER);
+        size_t right = cwr_bytecode_compile_expression(compiler, expression->binary.children[1], CWR_BYTECODE_ANY_REGISTER);
+        compiler->top = top;
+
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = branch,
+            .b = (uint16_t)left,
+            .c = (uint16_t)right}, location);
+        return cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_jump_type}, location);
+    }
+
+    size_t value = cwr_bytecode_compile_expression(compiler, condition, CWR_BYTECODE_ANY_REGISTER);
+    compiler->top = top;
+
+    return cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_jump_false_type,
+        .a = (uint16_t)value}, location);
+}
+
+static void cwr_bytecode_compile_store(cwr_bytecode_compiler *compiler, size_t slot, cwr_expression_index value, bool is_reference, cwr_location location)
+{
+    size_t top = compiler->top;
+
+    if (!is_reference)
+    {
+        cwr_bytecode_compile_expression(compiler, value, slot);
+        compiler->top = top;
+        return;
+    }
+
+    size_t result = cwr_bytecode_compile_expression(compiler, value, CWR_BYTECODE_ANY_REGISTER);
+    cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_store_type,
+        .a = (uint16_t)slot,
+        .b = (uint16_t)result}, location);
+    compiler->top = top;
+}
+
+static void cwr_bytecode_compile_var_decl(cwr_bytecode_compiler *compiler, cwr_var_decl_statement statement, cwr_location location)
+{
+    cwr_bytecode_compile_store(compiler, statement.identifier, statement.value, compiler->references[statement.identifier], location);
+}
+
+static void cwr_bytecode_compile_return(cwr_bytecode_compiler *compiler, cwr_return_statement statement, cwr_location location)
+{
+    size_t top = compiler->top;
+    size_t value;
+
+    const cwr_expression *expression = cwr_expression_pool_get(compiler->pool, statement.value);
+    if (statement.with_body)
+    {
+        // Copied, so the body can't change it through its variable
+        value = cwr_bytecode_reserve(compiler, top, 1, location);
+        cwr_bytecode_compile_expression(compiler, statement.value, value);
+        compiler->top = value + 1;
+
+        size_t exits_base = compiler->exits_base;
+        bool is_in_return_body = compiler->is_in_return_body;
+        compiler->exits_base = compiler->exits_capacity;
+        compiler->is_in_return_body = true;
+
+        cwr_bytecode_compile_body(compiler, statement.body);
+
+        for (size_t i = compiler->exits_base; i < compiler->exits_capacity; i++)
+        {
+            cwr_bytecode_patch(compiler, compiler->exits[i]);
+        }
+
+        compiler->exits_capacity = compiler->exits_base;
+        compiler->exits_base = exits_base;
+        compiler->is_in_return_body = is_in_return_body;
+    }
+    else if (statement.is_tail_call && !compiler->is_in_return_body && expression->type == cwr_expression_func_call_type)
+    {
+        // Only a bound callee comes back to the return after it
+        value = cwr_bytecode_compile_call(compiler, expression->func_call, cwr_instruction_tail_call_type, cwr_expression_pool_location(compiler->pool, statement.value), CWR_BYTECODE_ANY_REGISTER);
+    }
+    else
+    {
+        value = cwr_bytecode_compile_expression(compiler, statement.value, CWR_BYTECODE_ANY_REGISTER);
+    }
+
+    compiler->top = top;
+    if (!compiler->is_in_return_body)
+    {
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_return_type,
+            .a = (uint16_t)value}, location);
+        return;
+    }
+
+    cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_release_type,
+        .a = (uint16_t)value}, location);
+
+    size_t exit = cwr_bytecode_emit(compiler, (cwr_instruction){
+        .type = cwr_instruction_jump_type}, location);
+    if (!CWR_VECTOR_RESERVE(compiler->exits, compiler->exits_size, compiler->exits_capacity, 1))
+    {
+        cwr_bytecode_throw_out_of_memory(compiler, location);
+        return;
+    }
+
+    compiler->exits[compiler->exits_capacity++] = exit;
+}
+
+static void cwr_bytecode_compile_statement(cwr_bytecode_compiler *compiler, const cwr_statement *statement)
+{
+    cwr_location location = statement->location;
+    size_t top = compiler->top;
+
+    switch (statement->type)
+    {
+    case cwr_statement_func_call_type:
+    {
+        size_t result = cwr_bytecode_compile_call(compiler, statement->func_call, cwr_instruction_call_type, location, CWR_BYTECODE_ANY_REGISTER);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_release_type,
+            .a = (uint16_t)result}, location);
+        break;
+    }
+    case cwr_statement_var_decl_type:
+        cwr_bytecode_compile_var_decl(compiler, statement->var_decl, location);
+        break;
+    case cwr_statement_assign_type:
+    {
+        cwr_assign_statement assign = statement->assign;
+        if (!assign.is_dereference)
+        {
+            const cwr_expression *variable = cwr_expression_pool_get(compiler->pool, assign.identifier);
+            bool is_reference = cwr_bytecode_is_reference(cwr_expression_pool_type(compiler->pool, assign.identifier));
+            cwr_bytecode_compile_store(compiler, variable->var.identifier, assign.value, is_reference, location);
+            break;
+        }
+
+        const cwr_expression *identifier = cwr_expression_pool_get(compiler->pool, assign.identifier);
+        size_t value = cwr_bytecode_compile_expression(compiler, assign.value, CWR_BYTECODE_ANY_REGISTER);
+        size_t pointer = cwr_bytecode_compile_expression(compiler, identifier->unary.child, CWR_BYTECODE_ANY_REGISTER);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_store_dereference_type,
+            .a = (uint16_t)pointer,
+            .b = (uint16_t)value}, location);
+        break;
+    }
+    case cwr_statement_if_type:
+    {
+        size_t skip = cwr_bytecode_compile_condition(compiler, statement->if_stat.condition, location);
+        cwr_bytecode_compile_body(compiler, statement->if_stat.body);
+        cwr_bytecode_patch(compiler, skip);
+        break;
+    }
+    case cwr_statement_for_loop_type:
+    {
+        cwr_for_loop_statement for_loop = statement->for_loop;
+        if (for_loop.with_variable)
+        {
+            cwr_bytecode_compile_var_decl(compiler, for_loop.variable, location);
+        }
+
+        size_t start = compiler->function->capacity;
+        size_t exit = SIZE_MAX;
+        if (for_loop.with_condition)
+        {
+            exit = cwr_bytecode_compile_condition(compiler, for_loop.condition, location);
+        }
+
+        // Step runs before the body, as in the tree walker
+        if (for_loop.with_statement)
+        {
+            cwr_bytecode_compile_statement(compiler, for_loop.statement);
+        }
+
+        cwr_bytecode_compile_body(compiler, for_loop.body);
+        cwr_bytecode_emit(compiler, (cwr_instruction){
+            .type = cwr_instruction_jump_type,
+            .index = (uint32_t)start}, location);
+
+        if (exit != SIZE_MAX)
+        {
+            cwr_bytecode_patch(compiler, exit);
+        }
+
+        break;
+    }
+    case cwr_statement_return_type:
+        cwr_bytecode_compile_return(compiler, statement->ret, location);
+        break;
+    default:
+        break;
+    }
+
+    compiler->top = top;
+}
+
+static void cwr_bytecode_compile_body(cwr_bytecode_compiler *compiler, cwr_func_body_expression body)
+{
+    for (size_t i = 0; i < body.count && !compiler->error->is_failed; i++)
+    {
+        cwr_bytecode_compile_statement(compiler, &body.statements[i]);
+    }
+}
+
+cwr_bytecode_function *cwr_bytecode_compile(cwr_walker *walker, const cwr_expression_pool *pool, cwr_function_instance instance, cwr_location location, cwr_interpreter_error *error)
+{
+    cwr_bytecode_function *function = calloc(1, sizeof(cwr_bytecode_function));
+    bool *references = calloc(instance.frame_size + 1, sizeof(bool));
+    if (function == NULL || references == NULL)
+    {
+        free(function);
+        free(references);
+        cwr_interpreter_error_throw_out_of_memory(error, location);
+        return NULL;
+    }
+
+    function->arguments_count = instance.count;
+    function->frame_size = instance.frame_size;
+
+    cwr_bytecode_compiler compiler = (cwr_bytecode_compiler){
+        .pool = pool,
+        .function = function,
+        .references = references,
+        .error = error};
+
+    for (size_t i = 0; i < instance.count; i++)
+    {
+        if (cwr_bytecode_is_reference(instance.arguments[i].type))
+        {
+            references[instance.arguments[i].identifier] = true;
+            function->with_references = true;
+        }
+    }
+
+    cwr_bytecode_scan scan = (cwr_bytecode_scan){
+        .compiler = &compiler,
+        .walker = walker};
+    if (!cwr_walker_walk_statements(walker, instance.body.statements, instance.body.count, &instance.body, cwr_bytecode_scan_statement, &scan))
+    {
+        cwr_bytecode_throw_out_of_memory(&compiler, location);
+    }
+
+    cwr_bytecode_reserve(&compiler, function->frame_size + function->constants_capacity, 0, location);
+
+    cwr_bytecode_compile_body(&compiler, instance.body);
+    cwr_bytecode_emit(&compiler, (cwr_instruction){
+        .type = cwr_instruction_return_none_type}, location);
+
+    free(compiler.exits);
+    free(compiler.tasks);
+    free(compiler.constants);
+    free(references);
+
+    if (error->is_failed)
+    {
+        cwr_bytecode_function_destroy(function);
+        return NULL;
+    }
+
+    return function;
+}
+
+void cwr_bytecode_function_destroy(cwr_bytecode_function *function)
+{
+    if (function == NULL)
+    {
+        return;
+    }
+
+    free(function->instructions);
+    free(function->locations);
+    free(function->calls);
+    free(function->constants);
+    free(function);
+}
\ No newline at end of file
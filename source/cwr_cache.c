@@ -0,0 +1,1015 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cwr_cache.h>
+#include <cwr_hash.h>
+#include <cwr_vector.h>
+#include <cwr_preprocessor_includer.h>
+
+#define CWR_CACHE_MAGIC "CWRC"
+#define CWR_CACHE_ALIGNMENT _Alignof(max_align_t)
+#define CWR_CACHE_TABLE_DEFAULT_SIZE 64
+
+// Pointers are stored as offsets from the image start and listed in the relocation table
+typedef struct cwr_cache_header
+{
+    char magic[4];
+    uint32_t version;
+    size_t key;
+    size_t size;
+    size_t statements;
+    size_t statements_count;
+    size_t global_variables;
+    size_t global_variables_count;
+    size_t functions;
+    size_t functions_count;
+    // Expression pool tables, copied out of the image on load
+    size_t expressions;
+    size_t types;
+    size_t locations;
+    size_t expressions_count;
+    size_t indices;
+    size_t indices_count;
+    size_t names;
+    size_t names_count;
+    size_t strings;
+    size_t strings_count;
+    size_t relocations;
+    size_t relocations_count;
+} cwr_cache_header;
+
+typedef struct cwr_cache
+{
+    char *directory;
+} cwr_cache;
+
+// Copied names and types, so each is stored once. Offset 0 marks a free entry
+typedef struct cwr_cache_entry
+{
+    size_t hash;
+    const void *source;
+    size_t offset;
+} cwr_cache_entry;
+
+typedef struct cwr_cache_table
+{
+    cwr_cache_entry *entries;
+    size_t entries_size;
+    size_t entries_capacity;
+} cwr_cache_table;
+
+// Bodies enclosing the one being written, 'root' pointers only lead to them
+typedef struct cwr_cache_body cwr_cache_body;
+
+typedef struct cwr_cache_body
+{
+    const cwr_func_body_expression *source;
+    size_t offset;
+    const cwr_cache_body *parent;
+} cwr_cache_body;
+
+typedef struct cwr_cache_writer
+{
+    char *image;
+    size_t image_size;
+    size_t image_capacity;
+    size_t *relocations;
+    size_t relocations_size;
+    size_t relocations_capacity;
+    cwr_cache_table strings;
+    cwr_cache_table types;
+    bool is_failed;
+} cwr_cache_writer;
+
+static size_t cwr_cache_writer_statements(cwr_cache_writer *writer, const cwr_statement *statements, size_t count, const cwr_cache_body *bodies);
+
+static char *cwr_cache_path(cwr_cache *cache, size_t key, const char *suffix)
+{
+    size_t length = strlen(cache->directory) + strlen(suffix) + 2 * sizeof(size_t) + sizeof(CWR_CACHE_EXTENSION) + 1;
+
+    char *path = malloc(length);
+    if (path == NULL)
+    {
+        return NULL;
+    }
+
+    snprintf(path, length, "%s/%016zx%s%s", cache->directory, key, CWR_CACHE_EXTENSION, suffix);
+    return path;
+}
+
+cwr_cache *cwr_cache_create(const char *directory)
+{
+    cwr_cache *cache = malloc(sizeof(cwr_cache));
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+
+    cache->directory = strdup(directory);
+    if (cache->directory == NULL)
+    {
+        free(cache);
+        return NULL;
+    }
+
+    // Another run may create it first, a missing directory only makes every lookup miss
+    mkdir(directory, 0755);
+    return cache;
+}
+
+size_t cwr_cache_key(const char *executor, const char *source, size_t length)
+{
+    size_t layout[] = {
+        CWR_CACHE_VERSION,
+        sizeof(cwr_cache_header),
+        sizeof(cwr_statement),
+        sizeof(cwr_expression),
+        sizeof(cwr_expression_type_value),
+        sizeof(cwr_location),
+        sizeof(cwr_argument),
+        sizeof(cwr_parser_variable),
+        sizeof(cwr_parser_function)};
+
+    size_t hash = cwr_hash_bytes(layout, sizeof(layout));
+    hash = cwr_hash_continue(hash, CWR_STDIO_SOURCE, sizeof(CWR_STDIO_SOURCE));
+    hash = cwr_hash_continue(hash, executor, strlen(executor) + 1);
+    return cwr_hash_continue(hash, source, length);
+}
+
+// Copies 'size' bytes to the end of the image and returns their offset, 0 for an empty copy or a failure
+static size_t cwr_cache_writer_place(cwr_cache_writer *writer, const void *source, size_t size, size_t alignment)
+{
+    if (writer->is_failed || size == 0)
+    {
+        return 0;
+    }
+
+    size_t padding = (alignment - writer->image_capacity % alignment) % alignment;
+    if (!CWR_VECTOR_RESERVE(writer->image, writer->image_size, writer->image_capacity, padding + size))
+    {
+        writer->is_failed = true;
+        return 0;
+    }
+
+    memset(writer->image + writer->image_capacity, 0, padding);
+    writer->image_capacity += padding;
+
+    size_t offset = writer->image_capacity;
+    if (source == NULL)
+    {
+        memset(writer->image + offset, 0, size);
+    }
+    else
+    {
+        memcpy(writer->image + offset, source, size);
+    }
+
+    writer->image_capacity += size;
+    return offset;
+}
+
+// Stores 'target' in the pointer at 'field' and lists it for relocation
+static void cwr_cache_writer_pointer(cwr_cache_writer *writer, size_t field, size_t target)
+{
+    if (writer->is_failed)
+    {
+        return;
+    }
+
+    memcpy(writer->image + field, &target, sizeof(target));
+    if (target == 0)
+    {
+        return;
+    }
+
+    if (!CWR_VECTOR_RESERVE(writer->relocations, writer->relocations_size, writer->relocations_capacity, 1))
+    {
+        writer->is_failed = true;
+        return;
+    }
+
+    writer->relocations[writer->relocations_capacity++] = field;
+}
+
+static bool cwr_cache_table_grow(cwr_cache_table *table)
+{
+    size_t size = table->entries_size == 0 ? CWR_CACHE_TABLE_DEFAULT_SIZE : table->entries_size * 2;
+
+    cwr_cache_entry *entries = calloc(size, sizeof(cwr_cache_entry));
+    if (entries == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < table->entries_size; i++)
+    {
+        cwr_cache_entry entry = table->entries[i];
+        if (entry.offset == 0)
+        {
+            continue;
+        }
+
+        size_t position = entry.hash & (size - 1);
+        while (entries[position].offset != 0)
+        {
+            position = (position + 1) & (size - 1);
+        }
+
+        entries[position] = entry;
+    }
+
+    free(table->entries);
+    table->entries = entries;
+    table->entries_size = size;
+    return true;
+}
+
+// Makes room for one more entry, keeping the table at most half full
+static bool cwr_cache_table_reserve(cwr_cache_writer *writer, cwr_cache_table *table)
+{
+    if ((table->entries_capacity + 1) * 2 > table->entries_size && !cwr_cache_table_grow(table))
+    {
+        writer->is_failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+static void cwr_cache_table_add(cwr_cache_table *table, size_t position, size_t hash, const void *source, size_t offset)
+{
+    table->entries[position] = (cwr_cache_entry){
+        .hash = hash,
+        .source = source,
+        .offset = offset};
+    table->entries_capacity++;
+}
+
+// Equal names share one copy
+static void cwr_cache_writer_string(cwr_cache_writer *writer, size_t field, const char *value)
+{
+    if (writer->is_failed || value == NULL || !cwr_cache_table_reserve(writer, &writer->strings))
+    {
+        cwr_cache_writer_pointer(writer, field, 0);
+        return;
+    }
+
+    cwr_cache_table *table = &writer->strings;
+    size_t length = strlen(value) + 1;
+    size_t hash = cwr_hash_bytes(value, length);
+    size_t position = hash & (table->entries_size - 1);
+
+    while (table->entries[position].offset != 0)
+    {
+        cwr_cache_entry entry = table->entries[position];
+        if (entry.hash == hash && strcmp(writer->image + entry.offset, value) == 0)
+        {
+            cwr_cache_writer_pointer(writer, field, entry.offset);
+            return;
+        }
+
+        position = (position + 1) & (table->entries_size - 1);
+    }
+
+    size_t offset = cwr_cache_writer_place(writer, value, length, 1);
+    if (writer->is_failed)
+    {
+        return;
+    }
+
+    cwr_cache_table_add(table, position, hash, NULL, offset);
+    cwr_cache_writer_pointer(writer, field, offset);
+}
+
+// Interned types are copied once each and found again by their pointer
+static void cwr_cache_writer_type(cwr_cache_writer *writer, size_t field, const cwr_expression_type_value *type)
+{
+    if (writer->is_failed || type == NULL || !cwr_cache_table_reserve(writer, &writer->types))
+    {
+        cwr_cache_writer_pointer(writer, field, 0);
+        return;
+    }
+
+    cwr_cache_table *table = &writer->types;
+    size_t hash = cwr_hash_bytes(&type, sizeof(type));
+    size_t position = hash & (table->entries_size - 1);
+
+    while (table->entries[position].offset != 0)
+    {
+        if (table->entries[position].source == type)
+        {
+            cwr_cache_writer_pointer(writer, field, table->entries[position].offset);
+            return;
+        }
+
+        position = (position + 1) & (table->entries_size - 1);
+    }
+
+    size_t offset = cwr_cache_writer_place(writer, type, sizeof(cwr_expression_type_value), CWR_CACHE_ALIGNMENT);
+    if (writer->is_failed)
+    {
+        return;
+    }
+
+    // Targets may grow the table, the new type is listed before they are written
+    cwr_cache_table_add(table, position, hash, type, offset);
+    cwr_cache_writer_pointer(writer, field, offset);
+
+    cwr_cache_writer_string(writer, offset + offsetof(cwr_expression_type_value, name), type->name);
+    cwr_cache_writer_type(writer, offset + offsetof(cwr_expression_type_value, target_type), type->target_type);
+}
+
+// Returns the offset of the copied list
+static size_t cwr_cache_writer_arguments(cwr_cache_writer *writer, const cwr_argument *arguments, size_t count)
+{
+    size_t offset = cwr_cache_writer_place(writer, arguments, count * sizeof(cwr_argument), CWR_CACHE_ALIGNMENT);
+
+    for (size_t i = 0; offset != 0 && i < count; i++)
+    {
+        size_t argument = offset + i * sizeof(cwr_argument);
+
+        cwr_cache_writer_string(writer, argument + offsetof(cwr_argument, name), arguments[i].name);
+        cwr_cache_writer_type(writer, argument + offsetof(cwr_argument, type), arguments[i].type);
+    }
+
+    return offset;
+}
+
+static void cwr_cache_writer_var_decl(cwr_cache_writer *writer, size_t field, const cwr_var_decl_statement *var_decl)
+{
+    cwr_cache_writer_string(writer, field + offsetof(cwr_var_decl_statement, name), var_decl->name);
+    cwr_cache_writer_type(writer, field + offsetof(cwr_var_decl_statement, value_type), var_decl->value_type);
+}
+
+static size_t cwr_cache_body_find(const cwr_cache_body *bodies, const cwr_func_body_expression *source)
+{
+    for (; bodies != NULL; bodies = bodies->parent)
+    {
+        if (bodies->source == source)
+        {
+            return bodies->offset;
+        }
+    }
+
+    return 0;
+}
+
+static void cwr_cache_writer_body(cwr_cache_writer *writer, size_t field, const cwr_func_body_expression *body, const cwr_cache_body *bodies)
+{
+    cwr_cache_body link = (cwr_cache_body){
+        .source = body,
+        .offset = field,
+        .parent = bodies};
+
+    cwr_cache_writer_pointer(writer, field + offsetof(cwr_func_body_expression, root), cwr_cache_body_find(bodies, body->root));
+    size_t statements = cwr_cache_writer_statements(writer, body->statements, body->count, &link);
+    cwr_cache_writer_pointer(writer, field + offsetof(cwr_func_body_expression, statements), statements);
+}
+
+// Parts of a statement not in use are cleared, so no stale pointer ends up in the image
+static void cwr_cache_writer_clear(cwr_cache_writer *writer, size_t field, size_t size)
+{
+    if (!writer->is_failed)
+    {
+        memset(writer->image + field, 0, size);
+    }
+}
+
+// 'field' is the offset of an already copied statement
+static void cwr_cache_writer_statement(cwr_cache_writer *writer, size_t field, const cwr_statement *statement, const cwr_cache_body *bodies)
+{
+    cwr_cache_writer_string(writer, field + offsetof(cwr_statement, location) + offsetof(cwr_location, executor), statement->location.executor);
+
+    switch (statement->type)
+    {
+    case cwr_statement_func_decl_type:
+    {
+        size_t func_decl = field + offsetof(cwr_statement, func_decl);
+
+        cwr_cache_writer_string(writer, func_decl + offsetof(cwr_func_decl_statement, name), statement->func_decl.name);
+        size_t arguments = cwr_cache_writer_arguments(writer, statement->func_decl.arguments, statement->func_decl.count);
+        cwr_cache_writer_pointer(writer, func_decl + offsetof(cwr_func_decl_statement, arguments), arguments);
+        cwr_cache_writer_body(writer, func_decl + offsetof(cwr_func_decl_statement, func_body), &statement->func_decl.func_body, bodies);
+        cwr_cache_writer_type(writer, func_decl + offsetof(cwr_func_decl_statement, return_type), statement->func_decl.return_type);
+        break;
+    }
+    case cwr_statement_var_decl_type:
+        cwr_cache_writer_var_decl(writer, field + offsetof(cwr_statement, var_decl), &statement->var_decl);
+        break;
+    case cwr_statement_for_loop_type:
+    {
+        size_t for_loop = field + offsetof(cwr_statement, for_loop);
+
+        if (statement->for_loop.with_variable)
+        {
+            cwr_cache_writer_var_decl(writer, for_loop + offsetof(cwr_for_loop_statement, variable), &statement->for_loop.variable);
+        }
+        else
+        {
+            cwr_cache_writer_clear(writer, for_loop + offsetof(cwr_for_loop_statement, variable), sizeof(cwr_var_decl_statement));
+        }
+
+        size_t step = 0;
+        if (statement->for_loop.with_statement)
+        {
+            step = cwr_cache_writer_statements(writer, statement->for_loop.statement, 1, bodies);
+        }
+
+        cwr_cache_writer_pointer(writer, for_loop + offsetof(cwr_for_loop_statement, statement), step);
+
+        if (statement->for_loop.with_body)
+        {
+            cwr_cache_writer_body(writer, for_loop + offsetof(cwr_for_loop_statement, body), &statement->for_loop.body, bodies);
+        }
+        else
+        {
+            cwr_cache_writer_clear(writer, for_loop + offsetof(cwr_for_loop_statement, body), sizeof(cwr_func_body_expression));
+        }
+
+        break;
+    }
+    case cwr_statement_if_type:
+        cwr_cache_writer_body(writer, field + offsetof(cwr_statement, if_stat) + offsetof(cwr_if_statement, body), &statement->if_stat.body, bodies);
+        break;
+    case cwr_statement_return_type:
+        if (statement->ret.with_body)
+        {
+            cwr_cache_writer_body(writer, field + offsetof(cwr_statement, ret) + offsetof(cwr_return_statement, body), &statement->ret.body, bodies);
+        }
+        else
+        {
+            cwr_cache_writer_clear(writer, field + offsetof(cwr_statement, ret) + offsetof(cwr_return_statement, body), sizeof(cwr_func_body_expression));
+        }
+
+        break;
+    default:
+        // Calls and assignments only refer to the pool
+        break;
+    }
+}
+
+static size_t cwr_cache_writer_statements(cwr_cache_writer *writer, const cwr_statement *statements, size_t count, const cwr_cache_body *bodies)
+{
+    size_t offset = cwr_cache_writer_place(writer, statements, count * sizeof(cwr_statement), CWR_CACHE_ALIGNMENT);
+
+    for (size_t i = 0; offset != 0 && i < count; i++)
+    {
+        cwr_cache_writer_statement(writer, offset + i * sizeof(cwr_statement), &statements[i], bodies);
+    }
+
+    return offset;
+}
+
+static void cwr_cache_writer_result(cwr_cache_writer *writer, const cwr_parser_result *result, size_t key)
+{
+    cwr_cache_header header = (cwr_cache_header){
+        .version = CWR_CACHE_VERSION,
+        .key = key};
+    memcpy(header.magic, CWR_CACHE_MAGIC, sizeof(header.magic));
+
+    // Header goes first and is filled in at the end, every offset below it is not 0
+    cwr_cache_writer_place(writer, NULL, sizeof(cwr_cache_header), CWR_CACHE_ALIGNMENT);
+
+    header.statements = cwr_cache_writer_statements(writer, result->nodes_list.statements, result->nodes_list.count, NULL);
+    header.statements_count = result->nodes_list.count;
+
+    header.global_variables = cwr_cache_writer_place(writer, result->global_variables, result->global_variables_count * sizeof(cwr_parser_variable), CWR_CACHE_ALIGNMENT);
+    header.global_variables_count = result->global_variables_count;
+    for (size_t i = 0; header.global_variables != 0 && i < result->global_variables_count; i++)
+    {
+        size_t variable = header.global_variables + i * sizeof(cwr_parser_variable);
+
+        // Globals belong to no body
+        cwr_cache_writer_string(writer, variable + offsetof(cwr_parser_variable, name), result->global_variables[i].name);
+        cwr_cache_writer_pointer(writer, variable + offsetof(cwr_parser_variable, root), 0);
+        cwr_cache_writer_type(writer, variable + offsetof(cwr_parser_variable, type), result->global_variables[i].type);
+    }
+
+    header.functions = cwr_cache_writer_place(writer, result->functions, result->functions_count * sizeof(cwr_parser_function), CWR_CACHE_ALIGNMENT);
+    header.functions_count = result->functions_count;
+    for (size_t i = 0; header.functions != 0 && i < result->functions_count; i++)
+    {
+        size_t function = header.functions + i * sizeof(cwr_parser_function);
+
+        cwr_cache_writer_string(writer, function + offsetof(cwr_parser_function, name), result->functions[i].name);
+        size_t arguments = cwr_cache_writer_arguments(writer, result->functions[i].arguments, result->functions[i].count);
+        cwr_cache_writer_pointer(writer, function + offsetof(cwr_parser_function, arguments), arguments);
+        cwr_cache_writer_type(writer, function + offsetof(cwr_parser_function, return_type), result->functions[i].return_type);
+    }
+
+    // Expressions, indices and strings hold no pointers and are copied as they are
+    const cwr_expression_pool *pool = result->nodes_list.pool;
+    header.expressions_count = pool->count;
+    header.expressions = cwr_cache_writer_place(writer, pool->expressions, pool->count * sizeof(cwr_expression), CWR_CACHE_ALIGNMENT);
+    header.indices_count = pool->indices_count;
+    header.indices = cwr_cache_writer_place(writer, pool->indices, pool->indices_count * sizeof(cwr_expression_index), CWR_CACHE_ALIGNMENT);
+    header.strings_count = pool->strings_count;
+    header.strings = cwr_cache_writer_place(writer, pool->strings, pool->strings_count, 1);
+
+    header.types = cwr_cache_writer_place(writer, pool->types, pool->count * sizeof(cwr_expression_type_value *), CWR_CACHE_ALIGNMENT);
+    for (size_t i = 0; header.types != 0 && i < pool->count; i++)
+    {
+        cwr_cache_writer_type(writer, header.types + i * sizeof(cwr_expression_type_value *), pool->types[i]);
+    }
+
+    header.locations = cwr_cache_writer_place(writer, pool->locations, pool->count * sizeof(cwr_location), CWR_CACHE_ALIGNMENT);
+    for (size_t i = 0; header.locations != 0 && i < pool->count; i++)
+    {
+        cwr_cache_writer_string(writer, header.locations + i * sizeof(cwr_location) + offsetof(cwr_location, executor), pool->locations[i].executor);
+    }
+
+    header.names_count = pool->names_count;
+    header.names = cwr_cache_writer_place(writer, pool->names, pool->names_count * sizeof(cwr_expression_name), CWR_CACHE_ALIGNMENT);
+    for (size_t i = 0; header.names != 0 && i < pool->names_count; i++)
+    {
+        cwr_cache_writer_string(writer, header.names + i * sizeof(cwr_expression_name) + offsetof(cwr_expression_name, name), pool->names[i].name);
+    }
+
+    header.relocations_count = writer->relocations_capacity;
+    header.relocations = cwr_cache_writer_place(writer, writer->relocations, writer->relocations_capacity * sizeof(size_t), CWR_CACHE_ALIGNMENT);
+    header.size = writer->image_capacity;
+
+    if (!writer->is_failed)
+    {
+        memcpy(writer->image, &header, sizeof(header));
+    }
+}
+
+bool cwr_cache_store(cwr_cache *cache, size_t key, const cwr_parser_result *result)
+{
+    if (result->is_failed || result->lazy != NULL)
+    {
+        return false;
+    }
+
+    cwr_cache_writer writer = (cwr_cache_writer){};
+    cwr_cache_writer_result(&writer, result, key);
+
+    free(writer.relocations);
+    free(writer.strings.entries);
+    free(writer.types.entries);
+
+    if (writer.is_failed)
+    {
+        free(writer.image);
+        return false;
+    }
+
+    char *path = cwr_cache_path(cache, key, "");
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long)getpid());
+    char *temporary = cwr_cache_path(cache, key, suffix);
+
+    bool is_successful = path != NULL && temporary != NULL;
+    if (is_successful)
+    {
+        FILE *target = fopen(temporary, "wb");
+        is_successful = target != NULL;
+
+        if (is_successful)
+        {
+            is_successful = fwrite(writer.image, 1, writer.image_capacity, target) == writer.image_capacity;
+            is_successful = fclose(target) == 0 && is_successful;
+        }
+
+        // Readers see either the old file or the whole new one
+        is_successful = is_successful && rename(temporary, path) == 0;
+        if (!is_successful)
+        {
+            remove(temporary);
+        }
+    }
+
+    free(path);
+    free(temporary);
+    free(writer.image);
+    return is_successful;
+}
+
+static bool cwr_cache_section_is_valid(size_t image_size, size_t offset, size_t count, size_t element_size)
+{
+    if (count == 0)
+    {
+        return offset == 0;
+    }
+
+    return offset != 0 && offset <= image_size && count <= (image_size - offset) / element_size;
+}
+
+static bool cwr_cache_header_is_valid(const cwr_cache_header *header, size_t key, size_t image_size)
+{
+    return memcmp(header->magic, CWR_CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == CWR_CACHE_VERSION &&
+           header->key == key &&
+           header->size == image_size &&
+           cwr_cache_section_is_valid(image_size, header->statements, header->statements_count, sizeof(cwr_statement)) &&
+           cwr_cache_section_is_valid(image_size, header->global_variables, header->global_variables_count, sizeof(cwr_parser_variable)) &&
+           cwr_cache_section_is_valid(image_size, header->functions, header->functions_count, sizeof(cwr_parser_function)) &&
+           cwr_cache_section_is_valid(image_size, header->expressions, header->expressions_count, sizeof(cwr_expression)) &&
+           cwr_cache_section_is_valid(image_size, header->types, header->expressions_count, sizeof(cwr_expression_type_value *)) &&
+           cwr_cache_section_is_valid(image_size, header->locations, header->expressions_count, sizeof(cwr_location)) &&
+           cwr_cache_section_is_valid(image_size, header->indices, header->indices_count, sizeof(cwr_expression_index)) &&
+           cwr_cache_section_is_valid(image_size, header->names, header->names_count, sizeof(cwr_expression_name)) &&
+           cwr_cache_section_is_valid(image_size, header->strings, header->strings_count, 1) &&
+           cwr_cache_section_is_valid(image_size, header->relocations, header->relocations_count, sizeof(size_t));
+}
+
+// Turns every listed offset into an address in the mapping
+static bool cwr_cache_relocate(char *image, const cwr_cache_header *header)
+{
+    const size_t *relocations = (const size_t *)(image + header->relocations);
+
+    for (size_t i = 0; i < header->relocations_count; i++)
+    {
+        size_t field = relocations[i];
+        if (field > header->size - sizeof(size_t) || field % _Alignof(void *) != 0)
+        {
+            return false;
+        }
+
+        size_t target;
+        memcpy(&target, image + field, sizeof(target));
+        if (target == 0 || target >= header->size)
+        {
+            return false;
+        }
+
+        *(void **)(image + field) = image + target;
+    }
+
+    return true;
+}
+
+// Counts, expression indices and slots have to stay inside what they refer to
+typedef struct cwr_cache_validator
+{
+    const char *image;
+    const cwr_cache_header *header;
+    const cwr_expression *expressions;
+    const cwr_expression_index *indices;
+    // Slots of the function being checked, top level statements never run
+    size_t frame_size;
+    cwr_expression_index *stack;
+    size_t stack_size;
+    size_t stack_capacity;
+} cwr_cache_validator;
+
+// Relocated arrays have to fit in the image as a whole, not only start in it
+static bool cwr_cache_array_is_valid(const cwr_cache_validator *validator, const void *array, size_t count, size_t element_size)
+{
+    if (count == 0)
+    {
+        return true;
+    }
+
+    const char *start = array;
+    const char *end = validator->image + validator->header->size;
+    return start > validator->image && start < end && (size_t)(start - validator->image) % CWR_CACHE_ALIGNMENT == 0 &&
+           count <= (size_t)(end - start) / element_size;
+}
+
+// Flags are read as bytes, anything but 0 and 1 is not a bool
+static bool cwr_cache_flag_is_valid(const bool *flag)
+{
+    return *(const unsigned char *)flag <= 1;
+}
+
+static bool cwr_cache_slot_is_valid(const cwr_cache_validator *validator, int slot)
+{
+    return slot >= 0 && (size_t)slot < validator->frame_size;
+}
+
+static bool cwr_cache_call_is_valid(const cwr_cache_validator *validator, cwr_func_call_statement func_call)
+{
+    return func_call.identifier >= 0 && (size_t)func_call.identifier < validator->header->functions_count &&
+           func_call.count <= validator->header->indices_count && func_call.arguments <= validator->header->indices_count - func_call.count;
+}
+
+static bool cwr_cache_push_index(cwr_cache_validator *validator, cwr_expression_index index)
+{
+    if (index >= validator->header->expressions_count ||
+        !CWR_VECTOR_RESERVE(validator->stack, validator->stack_size, validator->stack_capacity, 1))
+    {
+        return false;
+    }
+
+    validator->stack[validator->stack_capacity++] = index;
+    return true;
+}
+
+// A tree reaching more nodes than the pool holds has a cycle
+static bool cwr_cache_tree_is_valid(cwr_cache_validator *validator, cwr_expression_index root)
+{
+    validator->stack_capacity = 0;
+    bool result = cwr_cache_push_index(validator, root);
+
+    for (size_t visits = 0; result && validator->stack_capacity > 0; visits++)
+    {
+        const cwr_expression *expression = &validator->expressions[validator->stack[--validator->stack_capacity]];
+        result = visits < validator->header->expressions_count;
+
+        switch (expression->type)
+        {
+        case cwr_expression_binary_type:
+            result = result && cwr_cache_push_index(validator, expression->binary.children[0]) && cwr_cache_push_index(validator, expression->binary.children[1]);
+            break;
+        case cwr_expression_array_element_type:
+            result = result && cwr_cache_push_index(validator, expression->array_element.children[0]) && cwr_cache_push_index(validator, expression->array_element.children[1]);
+            break;
+        case cwr_expression_unary_type:
+            result = result && cwr_cache_push_index(validator, expression->unary.child);
+            break;
+        case cwr_expression_func_call_type:
+            result = result && cwr_cache_call_is_valid(validator, expression->func_call);
+            for (size_t i = 0; result && i < expression->func_call.count; i++)
+            {
+                result = cwr_cache_push_index(validator, validator->indices[expression->func_call.arguments + i]);
+            }
+
+            break;
+        case cwr_expression_var_type:
+            result = result && cwr_cache_slot_is_valid(validator, expression->var.identifier);
+            break;
+        case cwr_expression_string_type:
+            result = result && expression->string.length <= validator->header->strings_count &&
+                     expression->string.offset <= validator->header->strings_count - expression->string.length;
+            break;
+        case cwr_expression_character_type:
+        case cwr_expression_float_type:
+        case cwr_expression_integer_type:
+            break;
+        default:
+            result = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+static bool cwr_cache_statements_are_valid(cwr_cache_validator *validator, const cwr_statement *statements, size_t count);
+
+// Nested statements follow their parent, so a corrupt image can not form a cycle
+static bool cwr_cache_nested_is_valid(cwr_cache_validator *validator, const cwr_statement *parent, const cwr_statement *statements, size_t count)
+{
+    return count == 0 || (statements > parent && cwr_cache_array_is_valid(validator, statements, count, sizeof(cwr_statement)) &&
+                          cwr_cache_statements_are_valid(validator, statements, count));
+}
+
+static bool cwr_cache_var_decl_is_valid(cwr_cache_validator *validator, const cwr_var_decl_statement *var_decl)
+{
+    return cwr_cache_slot_is_valid(validator, var_decl->identifier) && cwr_cache_tree_is_valid(validator, var_decl->value);
+}
+
+static bool cwr_cache_func_decl_is_valid(cwr_cache_validator *validator, const cwr_statement *statement)
+{
+    const cwr_func_decl_statement *func_decl = &statement->func_decl;
+
+    // Every slot past the arguments belongs to a declaration, which has a value node
+    if (func_decl->identifier < 0 || (size_t)func_decl->identifier >= validator->header->functions_count ||
+        !cwr_cache_flag_is_valid(&func_decl->with_body) || !cwr_cache_flag_is_valid(&func_decl->is_lazy) || func_decl->is_lazy ||
+        func_decl->frame_size < func_decl->count || func_decl->frame_size - func_decl->count > validator->header->expressions_count ||
+        !cwr_cache_array_is_valid(validator, func_decl->arguments, func_decl->count, sizeof(cwr_argument)))
+    {
+        return false;
+    }
+
+    size_t frame_size = validator->frame_size;
+    validator->frame_size = func_decl->frame_size;
+
+    bool result = true;
+    for (size_t i = 0; result && i < func_decl->count; i++)
+    {
+        result = cwr_cache_slot_is_valid(validator, func_decl->arguments[i].identifier);
+    }
+
+    result = result && cwr_cache_nested_is_valid(validator, statement, func_decl->func_body.statements, func_decl->func_body.count);
+    validator->frame_size = frame_size;
+    return result;
+}
+
+static bool cwr_cache_statement_is_valid(cwr_cache_validator *validator, const cwr_statement *statement)
+{
+    if (!cwr_cache_flag_is_valid(&statement->is_block))
+    {
+        return false;
+    }
+
+    switch (statement->type)
+    {
+    case cwr_statement_func_decl_type:
+        return cwr_cache_func_decl_is_valid(validator, statement);
+    case cwr_statement_func_call_type:
+        if (!cwr_cache_call_is_valid(validator, statement->func_call))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < statement->func_call.count; i++)
+        {
+            if (!cwr_cache_tree_is_valid(validator, validator->indices[statement->func_call.arguments + i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    case cwr_statement_var_decl_type:
+        return cwr_cache_var_decl_is_valid(validator, &statement->var_decl);
+    case cwr_statement_assign_type:
+        return cwr_cache_flag_is_valid(&statement->assign.is_dereference) && cwr_cache_tree_is_valid(validator, statement->assign.identifier) && cwr_cache_tree_is_valid(validator, statement->assign.value);
+    case cwr_statement_for_loop_type:
+        if (!cwr_cache_flag_is_valid(&statement->for_loop.with_variable) || !cwr_cache_flag_is_valid(&statement->for_loop.with_condition) ||
+            !cwr_cache_flag_is_valid(&statement->for_loop.with_statement) || !cwr_cache_flag_is_valid(&statement->for_loop.with_body))
+        {
+            return false;
+        }
+
+        return (!statement->for_loop.with_variable || cwr_cache_var_decl_is_valid(validator, &statement->for_loop.variable)) &&
+               (!statement->for_loop.with_condition || cwr_cache_tree_is_valid(validator, statement->for_loop.condition)) &&
+               (!statement->for_loop.with_statement || cwr_cache_nested_is_valid(validator, statement, statement->for_loop.statement, 1)) &&
+               (!statement->for_loop.with_body || cwr_cache_nested_is_valid(validator, statement, statement->for_loop.body.statements, statement->for_loop.body.count));
+    case cwr_statement_if_type:
+        return cwr_cache_tree_is_valid(validator, statement->if_stat.condition) &&
+               cwr_cache_nested_is_valid(validator, statement, statement->if_stat.body.statements, statement->if_stat.body.count);
+    case cwr_statement_return_type:
+        return cwr_cache_flag_is_valid(&statement->ret.with_body) && cwr_cache_flag_is_valid(&statement->ret.is_tail_call) &&
+               cwr_cache_tree_is_valid(validator, statement->ret.value) &&
+               (!statement->ret.with_body || cwr_cache_nested_is_valid(validator, statement, statement->ret.body.statements, statement->ret.body.count));
+    case cwr_statement_struct_decl_type:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool cwr_cache_statements_are_valid(cwr_cache_validator *validator, const cwr_statement *statements, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!cwr_cache_statement_is_valid(validator, &statements[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool cwr_cache_image_is_valid(const char *image, const cwr_cache_header *header)
+{
+    cwr_cache_validator validator = (cwr_cache_validator){
+        .image = image,
+        .header = header,
+        .expressions = (const cwr_expression *)(image + header->expressions),
+        .indices = (const cwr_expression_index *)(image + header->indices),
+        .frame_size = SIZE_MAX};
+
+    const cwr_expression_name *names = (const cwr_expression_name *)(image + header->names);
+    bool result = true;
+    for (size_t i = 0; result && i < header->names_count; i++)
+    {
+        result = names[i].expression < header->expressions_count;
+    }
+
+    const cwr_parser_function *functions = (const cwr_parser_function *)(image + header->functions);
+    for (size_t i = 0; result && i < header->functions_count; i++)
+    {
+        result = cwr_cache_array_is_valid(&validator, functions[i].arguments, functions[i].count, sizeof(cwr_argument));
+    }
+
+    result = result && cwr_cache_statements_are_valid(&validator, (const cwr_statement *)(image + header->statements), header->statements_count);
+    free(validator.stack);
+    return result;
+}
+
+static void *cwr_cache_at(char *image, size_t offset)
+{
+    return offset == 0 ? NULL : image + offset;
+}
+
+static cwr_expression_pool *cwr_cache_load_pool(char *image, const cwr_cache_header *header)
+{
+    cwr_expression_pool *pool = cwr_expression_pool_create();
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    if (!cwr_expression_pool_reserve(pool, header->expressions_count) ||
+        !CWR_VECTOR_RESERVE(pool->indices, pool->indices_capacity, pool->indices_count, header->indices_count) ||
+        !CWR_VECTOR_RESERVE(pool->names, pool->names_capacity, pool->names_count, header->names_count) ||
+        !CWR_VECTOR_RESERVE(pool->strings, pool->strings_capacity, pool->strings_count, header->strings_count))
+    {
+        cwr_expression_pool_destroy(pool);
+        return NULL;
+    }
+
+    if (header->expressions_count > 0)
+    {
+        memcpy(pool->expressions, image + header->expressions, header->expressions_count * sizeof(cwr_expression));
+        memcpy(pool->types, image + header->types, header->expressions_count * sizeof(cwr_expression_type_value *));
+        memcpy(pool->locations, image + header->locations, header->expressions_count * sizeof(cwr_location));
+    }
+
+    if (header->indices_count > 0)
+    {
+        memcpy(pool->indices, image + header->indices, header->indices_count * sizeof(cwr_expression_index));
+    }
+
+    if (header->names_count > 0)
+    {
+        memcpy(pool->names, image + header->names, header->names_count * sizeof(cwr_expression_name));
+    }
+
+    if (header->strings_count > 0)
+    {
+        memcpy(pool->strings, image + header->strings, header->strings_count);
+    }
+
+    pool->count = header->expressions_count;
+    pool->indices_count = header->indices_count;
+    pool->names_count = header->names_count;
+    pool->strings_count = header->strings_count;
+    return pool;
+}
+
+bool cwr_cache_load(cwr_cache *cache, size_t key, cwr_parser_result *result)
+{
+    char *path = cwr_cache_path(cache, key, "");
+    if (path == NULL)
+    {
+        return false;
+    }
+
+    int descriptor = open(path, O_RDONLY);
+    free(path);
+
+    if (descriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(cwr_cache_header))
+    {
+        close(descriptor);
+        return false;
+    }
+
+    // Private pages, relocation only copies the ones holding pointers
+    size_t image_size = (size_t)status.st_size;
+    char *image = mmap(NULL, image_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (image == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const cwr_cache_header *header = (const cwr_cache_header *)image;
+    if (!cwr_cache_header_is_valid(header, key, image_size) || !cwr_cache_relocate(image, header) || !cwr_cache_image_is_valid(image, header))
+    {
+        munmap(image, image_size);
+        return false;
+    }
+
+    cwr_arena *arena = cwr_arena_create();
+    cwr_expression_pool *pool = cwr_cache_load_pool(image, header);
+    if (arena == NULL || pool == NULL)
+    {
+        cwr_arena_destroy(arena);
+        cwr_expression_pool_destroy(pool);
+        munmap(image, image_size);
+        return false;
+    }
+
+    *result = (cwr_parser_result){
+        .arena = arena,
+        .nodes_list = (cwr_nodes_list){
+            .statements = cwr_cache_at(image, header->statements),
+            .count = header->statements_count,
+            .pool = pool},
+        .global_variables = cwr_cache_at(image, header->global_variables),
+        .global_variables_count = header->global_variables_count,
+        .functions = cwr_cache_at(image, header->functions),
+        .functions_count = header->functions_count,
+        .image = image,
+        .image_size = image_size,
+        .is_failed = false};
+    return true;
+}
+
+void cwr_cache_destroy(cwr_cache *cache)
+{
+    if (cache == NULL)
+    {
+        return;
+    }
+
+    free(cache->directory);
+    free(cache);
+}
\ No newline at end of file
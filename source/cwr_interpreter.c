@@ -1,45 +1,59 @@
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
 #include <cwr_interpreter.h>
 #include <cwr_scope.h>
+#include <cwr_stack.h>
+#include <cwr_quickening.h>
 #include <cwr_string.h>
 
 typedef struct cwr_interpreter
 {
     cwr_parser_result result;
+    cwr_interpreter_configuration configuration;
 } cwr_interpreter;
 
-static cwr_value *printf_array_function(cwr_func_call_context context)
+static cwr_tagged_value printf_array_function(cwr_func_call_context context)
 {
-    cwr_value **arguments = context.arguments;
-    cwr_value *content = arguments[0];
+    cwr_tagged_value *arguments = context.arguments;
+    cwr_value *content = arguments[0].value;
     printf("%s\n", content->array.characters);
 
-    cwr_func_call_context_destroy(context);
-    return cwr_value_create_void();
+    return cwr_tagged_value_void();
 }
 
-static cwr_value *printf_character_function(cwr_func_call_context context)
+static cwr_tagged_value printf_character_function(cwr_func_call_context context)
 {
-    cwr_value **arguments = context.arguments;
-    cwr_value *content = arguments[0];
-    printf("%c\n", content->character);
+    cwr_tagged_value *arguments = context.arguments;
+    printf("%c\n", arguments[0].character);
 
-    cwr_func_call_context_destroy(context);
-    return cwr_value_create_void();
+    return cwr_tagged_value_void();
 }
 
-static cwr_value *printf_number_function(cwr_func_call_context context)
+static cwr_tagged_value printf_number_function(cwr_func_call_context context)
 {
-    cwr_value **arguments = context.arguments;
-    cwr_value *content = arguments[0];
-    printf("%f\n", cwr_value_as_float(content));
+    cwr_tagged_value *arguments = context.arguments;
+    printf("%f\n", cwr_tagged_value_as_float(&arguments[0]));
 
-    cwr_func_call_context_destroy(context);
-    return cwr_value_create_void();
+    return cwr_tagged_value_void();
 }
 
-cwr_interpreter *cwr_intepreter_create(cwr_parser_result result)
+void cwr_intepreter_load_function(cwr_program_context program_context, cwr_instance *function, cwr_interpreter_error *error)
+{
+    cwr_parser_error parser_error;
+    if (!cwr_parser_parse_lazy_body(program_context.lazy, function->identifier, &function->function.body, &function->function.frame_size, &parser_error))
+    {
+        cwr_interpreter_error_throw(error, cwr_interpreter_error_parser_type, parser_error.message, parser_error.location);
+        error->is_free_message = parser_error.is_free_message;
+        return;
+    }
+
+    function->function.is_lazy = false;
+}
+
+cwr_interpreter *cwr_intepreter_create(cwr_parser_result result, cwr_interpreter_configuration *configuration)
 {
     cwr_interpreter *interpreter = malloc(sizeof(cwr_interpreter));
     if (interpreter == NULL)
@@ -48,9 +62,46 @@ cwr_interpreter *cwr_intepreter_create(cwr_parser_result result)
     }
 
     interpreter->result = result;
+    interpreter->configuration = *configuration;
     return interpreter;
 }
 
+static inline uintptr_t cwr_intepreter_native_position()
+{
+#ifdef __GNUC__
+    return (uintptr_t)__builtin_frame_address(0);
+#else
+    char position;
+    return (uintptr_t)&position;
+#endif
+}
+
+// Lowest native stack address the tree walker can nest to on this thread, 0 when the stack is unknown
+static uintptr_t cwr_intepreter_native_limit(size_t reserve)
+{
+#ifdef __GLIBC__
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+    {
+        return 0;
+    }
+
+    void *address;
+    size_t size;
+    int status = pthread_attr_getstack(&attributes, &address, &size);
+    pthread_attr_destroy(&attributes);
+    if (status != 0 || size <= reserve)
+    {
+        return 0;
+    }
+
+    return (uintptr_t)address + reserve;
+#else
+    (void)reserve;
+    return 0;
+#endif
+}
+
 cwr_value *cwr_interpreter_evaluate_entry_point(cwr_interpreter_result result, cwr_interpreter_error *error)
 {
     cwr_instance *entry_point = cwr_scope_get_by_name(result.context.functions, CWR_SCOPE_GLOBAL_SCOPE, CWR_INTERPRETER_ENTRY_POINT_FUNC);
@@ -61,18 +112,58 @@ cwr_value *cwr_interpreter_evaluate_entry_point(cwr_interpreter_result result, c
         return NULL;
     }
 
+    if (entry_point->function.is_lazy)
+    {
+        cwr_intepreter_load_function(result.context, entry_point, error);
+        if (error->is_failed)
+        {
+            return NULL;
+        }
+    }
+
+    if (result.machine != NULL)
+    {
+        return cwr_machine_run(result.machine, entry_point, error);
+    }
+
+    cwr_stack *stack = result.context.stack;
+    stack->native_limit = cwr_intepreter_native_limit(stack->native_reserve);
+
+    size_t frame;
+    if (!cwr_stack_push(stack, entry_point->function.frame_size, &frame))
+    {
+        cwr_interpreter_error_throw_out_of_memory(error, (cwr_location){0});
+        return NULL;
+    }
+
     cwr_func_call_context context = (cwr_func_call_context){
         .context = result.context,
         .arguments = NULL,
         .count = 0,
         .location = (cwr_location){0}};
 
-    return cwr_intepreter_evaluate_func(entry_point->function, context, error);
+    cwr_tagged_value value = cwr_intepreter_evaluate_func(&entry_point->function, context, frame, error);
+    if (error->is_failed || value.type == cwr_value_void_type)
+    {
+        return NULL;
+    }
+
+    cwr_value *boxed = cwr_tagged_value_box(result.context.slab, value);
+    if (boxed == NULL)
+    {
+        cwr_interpreter_error_throw_out_of_memory(error, (cwr_location){0});
+    }
+
+    return boxed;
 }
 
 cwr_interpreter_result cwr_intepreter_interpret(cwr_interpreter *interpreter, cwr_interpreter_error *error)
 {
     cwr_program_context context = cwr_program_context_default();
+    context.pool = interpreter->result.nodes_list.pool;
+    context.lazy = interpreter->result.lazy;
+    context.stack->max_depth = interpreter->configuration.max_depth;
+    context.stack->native_reserve = interpreter->configuration.native_stack_reserve;
 
     for (size_t i = 0; i < interpreter->result.nodes_list.count; i++)
     {
@@ -91,11 +182,14 @@ cwr_interpreter_result cwr_intepreter_interpret(cwr_interpreter *interpreter, cw
                 .function = (cwr_function_instance){
                     .type = cwr_function_instance_user_type,
                     .arguments = statement.func_decl.arguments,
+                    .count = statement.func_decl.count,
+                    .frame_size = statement.func_decl.frame_size,
+                    .is_lazy = statement.func_decl.is_lazy,
                     .body = statement.func_decl.func_body}};
 
             if (strcmp(instance.name, "printf") == 0)
             {
-                switch (instance.function.arguments[0].type.value_type)
+                switch (instance.function.arguments[0].type->value_type)
                 {
                 case cwr_value_pointer_type:
                     instance.function.type = cwr_function_instance_bind_type;
@@ -112,9 +206,10 @@ cwr_interpreter_result cwr_intepreter_interpret(cwr_interpreter *interpreter, cw
                 }
             }
 
-            if (!cwr_scope_add(context.functions, instance))
+            // Calls refer to functions by identifier, so it is also the position in the scope
+            if (!cwr_scope_set(context.functions, instance.identifier, instance))
             {
-                cwr_instance_destroy(instance);
+                cwr_instance_destroy(context.slab, instance);
                 cwr_interpreter_error_throw_out_of_memory(error, statement.location);
             }
 
@@ -128,562 +223,642 @@ cwr_interpreter_result cwr_intepreter_interpret(cwr_interpreter *interpreter, cw
         }
     }
 
+    cwr_machine *machine = NULL;
+    if (interpreter->configuration.engine == cwr_interpreter_engine_bytecode_type && !error->is_failed)
+    {
+        machine = cwr_machine_create(context, interpreter->configuration.max_depth);
+        if (machine == NULL)
+        {
+            cwr_interpreter_error_throw_out_of_memory(error, (cwr_location){0});
+        }
+    }
+
     return (cwr_interpreter_result){
         .source = interpreter->result,
-        .context = context};
+        .context = context,
+        .machine = machine};
 }
 
-cwr_value *cwr_intepreter_evaluate_stat(cwr_program_context program_context, cwr_statement statement, cwr_func_body_expression *root, cwr_interpreter_error *error)
+// Quickens a binary node that just ran over a local and a literal or two locals, so it reads them straight from the frame.
+// Only integer and float kernels are quickened, the literal then has the type of the kernel
+static void cwr_intepreter_quicken_binary(cwr_program_context program_context, cwr_expression_index index)
 {
-    switch (statement.type)
+    const cwr_expression_pool *pool = program_context.pool;
+    cwr_binary_expression binary = cwr_expression_pool_get(pool, index)->binary;
+    const cwr_expression *left = cwr_expression_pool_get(pool, binary.children[0]);
+    const cwr_expression *right = cwr_expression_pool_get(pool, binary.children[1]);
+
+    cwr_quickened_expression quickened = (cwr_quickened_expression){
+        .type = cwr_quickened_generic_type,
+        .operator = binary.type,
+        .kernel = binary.kernel};
+
+    if ((binary.kernel == cwr_binary_kernel_integer_type || binary.kernel == cwr_binary_kernel_float_type) && left->type == cwr_expression_var_type)
     {
-    case cwr_statement_func_call_type:
+        quickened.slots[0] = left->var.identifier;
+
+        if (right->type == cwr_expression_var_type)
+        {
+            quickened.type = cwr_quickened_slots_type;
+            quickened.slots[1] = right->var.identifier;
+        }
+        else if (binary.kernel == cwr_binary_kernel_integer_type && right->type == cwr_expression_integer_type)
+        {
+            quickened.type = cwr_quickened_slot_constant_type;
+            quickened.integer_n = right->integer_n.value;
+        }
+        else if (binary.kernel == cwr_binary_kernel_float_type && right->type == cwr_expression_float_type)
+        {
+            quickened.type = cwr_quickened_slot_constant_type;
+            quickened.float_n = right->float_n.value;
+        }
+    }
+
+    cwr_quickening_set(program_context.quickening, index, quickened);
+}
+
+// Right operand of a slot and constant node, kept in 'constant'
+static inline const cwr_tagged_value *cwr_intepreter_quickened_right(cwr_program_context program_context, const cwr_quickened_expression *quickened, size_t frame, cwr_tagged_value *constant)
+{
+    if (quickened->type == cwr_quickened_slots_type)
     {
-        return cwr_intepreter_evaluate_stat_func_call(program_context, statement.func_call, root, statement.location, error);
+        return cwr_stack_at(program_context.stack, frame + quickened->slots[1]);
     }
-    case cwr_statement_if_type:
+
+    *constant = quickened->kernel == cwr_binary_kernel_integer_type ? cwr_tagged_value_integer(quickened->integer_n) : cwr_tagged_value_float(quickened->float_n);
+    return constant;
+}
+
+// Quickened nodes are decided without making a value, as a fused compare and branch
+static bool cwr_intepreter_evaluate_condition(cwr_program_context program_context, cwr_expression_index index, size_t frame, cwr_interpreter_error *error)
+{
+    const cwr_quickened_expression *quickened = cwr_quickening_get(program_context.quickening, index);
+    if (quickened != NULL && quickened->type != cwr_quickened_generic_type && quickened->operator != cwr_binary_operator_division_type)
+    {
+        cwr_tagged_value constant;
+        const cwr_tagged_value *left = cwr_stack_at(program_context.stack, frame + quickened->slots[0]);
+        const cwr_tagged_value *right = cwr_intepreter_quickened_right(program_context, quickened, frame, &constant);
+        return cwr_tagged_value_compare(quickened->operator, quickened->kernel, left, right);
+    }
+
+    // Division can fail, so it goes through the expression like any other condition
+    cwr_tagged_value condition = cwr_intepreter_evaluate_expr(program_context, index, frame, error);
+    if (error->is_failed)
     {
-        cwr_value *condition = cwr_intepreter_evaluate_expr(program_context, statement.if_stat.condition, root, error);
+        return false;
+    }
+
+    bool is_true = cwr_tagged_value_as_integer(&condition);
+    cwr_tagged_value_release(program_context.slab, &condition);
+    return is_true;
+}
+
+static void cwr_intepreter_evaluate_var_decl(cwr_program_context program_context, const cwr_var_decl_statement *statement, size_t frame, cwr_interpreter_error *error)
+{
+    cwr_tagged_value value = cwr_intepreter_evaluate_expr(program_context, statement->value, frame, error);
+    if (error->is_failed)
+    {
+        return;
+    }
+
+    // A block that runs again declares into the same slot and drops the previous value
+    cwr_tagged_value *slot = cwr_stack_at(program_context.stack, frame + statement->identifier);
+    cwr_tagged_value_add_reference(&value);
+    cwr_tagged_value_remove_reference(program_context.slab, slot);
+    *slot = value;
+}
+
+// 'statement' is a copy, as the pool can move when a lazy function is loaded
+static cwr_instance *cwr_intepreter_enter_call(cwr_program_context program_context, cwr_func_call_statement statement, size_t frame, cwr_location location, size_t *window, cwr_interpreter_error *error)
+{
+    cwr_instance *function = cwr_scope_at(program_context.functions, statement.identifier);
+    if (function->function.is_lazy)
+    {
+        cwr_intepreter_load_function(program_context, function, error);
         if (error->is_failed)
         {
-            return condition;
+            return NULL;
         }
+    }
+
+    // Every call also nests the walker on the native stack, which grows down
+    cwr_stack *stack = program_context.stack;
+    if (stack->frames_capacity >= stack->max_depth || cwr_intepreter_native_position() < stack->native_limit)
+    {
+        cwr_interpreter_error_throw_stack_overflow(error, location);
+        return NULL;
+    }
 
-        int result = cwr_value_as_integer(condition);
-        cwr_value_runtime_destroy(condition);
+    size_t size = statement.count;
+    if (function->function.type == cwr_function_instance_user_type)
+    {
+        size = function->function.frame_size;
+    }
+
+    if (!cwr_stack_push(stack, size, window))
+    {
+        cwr_interpreter_error_throw_out_of_memory(error, location);
+        return NULL;
+    }
 
-        if (result)
+    for (size_t i = 0; i < statement.count; i++)
+    {
+        cwr_expression_index expression = cwr_expression_pool_argument(program_context.pool, statement.arguments, i);
+        cwr_tagged_value argument = cwr_intepreter_evaluate_expr(program_context, expression, frame, error);
+        if (error->is_failed)
         {
-            return cwr_intepreter_evaluate_expr_body(program_context, statement.if_stat.body, root, error);
+            cwr_stack_pop(program_context.stack);
+            return NULL;
         }
 
-        return NULL;
+        // Nested calls can move the slots, so the window is kept by position
+        cwr_tagged_value_add_reference(&argument);
+        *cwr_stack_at(program_context.stack, *window + i) = argument;
     }
-    case cwr_statement_for_loop_type:
+
+    return function;
+}
+
+// The callee takes the frame of its caller, which returns at once
+static bool cwr_intepreter_evaluate_tail_call(cwr_program_context program_context, cwr_func_call_statement statement, size_t frame, cwr_location location, cwr_tagged_value *result, cwr_interpreter_error *error)
+{
+    size_t window;
+    cwr_instance *function = cwr_intepreter_enter_call(program_context, statement, frame, location, &window, error);
+    if (function == NULL)
     {
-        cwr_func_body_expression body = (cwr_func_body_expression){
-            .root = root,
-            .statements = statement.for_loop.body.statements,
-            .count = statement.for_loop.body.count};
-        cwr_func_body_expression *body_pointer = &body;
+        return false;
+    }
 
-        if (statement.for_loop.with_variable)
+    if (function->function.type == cwr_function_instance_bind_type)
+    {
+        cwr_func_call_context context = (cwr_func_call_context){
+            .context = program_context,
+            .arguments = cwr_stack_at(program_context.stack, window),
+            .count = statement.count,
+            .location = location};
+
+        *result = cwr_intepreter_evaluate_func(&function->function, context, window, error);
+        return !error->is_failed;
+    }
+
+    cwr_stack_replace(program_context.stack);
+    program_context.stack->tail_call = statement.identifier;
+    *result = cwr_tagged_value_void();
+    return true;
+}
+
+bool cwr_intepreter_evaluate_stat(cwr_program_context program_context, const cwr_statement *statement, size_t frame, cwr_tagged_value *result, cwr_interpreter_error *error)
+{
+    cwr_slab *slab = program_context.slab;
+
+    switch (statement->type)
+    {
+    case cwr_statement_func_call_type:
+    {
+        cwr_tagged_value value = cwr_intepreter_evaluate_stat_func_call(program_context, &statement->func_call, frame, statement->location, error);
+        if (!error->is_failed)
         {
-            char *name = statement.for_loop.variable.name;
-            cwr_value *value = cwr_intepreter_evaluate_expr(program_context, statement.for_loop.variable.value, root, error);
+            cwr_tagged_value_release(slab, &value);
+        }
 
-            if (error->is_failed)
-            {
-                return value;
-            }
+        return false;
+    }
+    case cwr_statement_if_type:
+    {
+        bool is_true = cwr_intepreter_evaluate_condition(program_context, statement->if_stat.condition, frame, error);
+        if (error->is_failed)
+        {
+            return false;
+        }
 
-            value->references_count++;
-            cwr_instance variable = (cwr_instance){
-                .type = cwr_instance_variable_type,
-                .root = body_pointer,
-                .identifier = statement.for_loop.variable.identifier,
-                .name = name,
-                .variable = (cwr_variable_instance){
-                    .type = statement.for_loop.variable.value_type,
-                    .value = value}};
+        if (is_true)
+        {
+            return cwr_intepreter_evaluate_expr_body(program_context, &statement->if_stat.body, frame, result, error);
+        }
 
-            if (!cwr_scope_add(program_context.variables, variable))
+        return false;
+    }
+    case cwr_statement_for_loop_type:
+    {
+        if (statement->for_loop.with_variable)
+        {
+            cwr_intepreter_evaluate_var_decl(program_context, &statement->for_loop.variable, frame, error);
+            if (error->is_failed)
             {
-                cwr_instance_destroy(variable);
-                cwr_interpreter_error_throw_out_of_memory(error, statement.location);
-                return value;
+                return false;
             }
         }
 
         while (true)
         {
-            if (statement.for_loop.with_condition)
+            if (statement->for_loop.with_condition)
             {
-                cwr_value *condition = cwr_intepreter_evaluate_expr(program_context, statement.for_loop.condition, body_pointer, error);
+                bool is_true = cwr_intepreter_evaluate_condition(program_context, statement->for_loop.condition, frame, error);
                 if (error->is_failed)
                 {
-                    return condition;
+                    return false;
                 }
 
-                int result = cwr_value_as_integer(condition);
-                cwr_value_runtime_destroy(condition);
-
-                if (!result)
+                if (!is_true)
                 {
                     break;
                 }
             }
 
-            if (statement.for_loop.with_statement)
+            if (statement->for_loop.with_statement)
             {
-                cwr_value *result = cwr_intepreter_evaluate_stat(program_context, *statement.for_loop.statement, body_pointer, error);
-                if (error->is_failed)
+                // A return in the step statement leaves only the step
+                if (cwr_intepreter_evaluate_stat(program_context, statement->for_loop.statement, frame, result, error))
                 {
-                    return result;
+                    cwr_tagged_value_release(slab, result);
                 }
 
-                cwr_value_runtime_destroy(result);
+                if (error->is_failed)
+                {
+                    return false;
+                }
             }
 
-            cwr_value *result = cwr_intepreter_evaluate_expr_body(program_context, statement.for_loop.body, body_pointer, error);
-            if (error->is_failed)
+            if (cwr_intepreter_evaluate_expr_body(program_context, &statement->for_loop.body, frame, result, error))
             {
-                return result;
+                return true;
             }
 
-            if (result != NULL)
+            if (error->is_failed)
             {
-                return result;
+                return false;
             }
         }
 
-        cwr_scope_root_destroy(program_context.variables, body_pointer);
-        return NULL;
+        // Variables of the loop keep their slots until redeclared or the frame is popped
+        return false;
     }
     case cwr_statement_var_decl_type:
+        cwr_intepreter_evaluate_var_decl(program_context, &statement->var_decl, frame, error);
+        return false;
+    case cwr_statement_assign_type:
     {
-        char *name = statement.var_decl.name;
-        cwr_value *value = cwr_intepreter_evaluate_expr(program_context, statement.var_decl.value, root, error);
-
+        cwr_tagged_value value = cwr_intepreter_evaluate_expr(program_context, statement->assign.value, frame, error);
         if (error->is_failed)
         {
-            return NULL;
+            return false;
         }
 
-        cwr_value_add_reference(value);
-        cwr_instance variable = (cwr_instance){
-            .type = cwr_instance_variable_type,
-            .root = root,
-            .identifier = statement.var_decl.identifier,
-            .name = name,
-            .variable = (cwr_variable_instance){
-                .type = statement.var_decl.value_type,
-                .value = value}};
-
-        if (!cwr_scope_add(program_context.variables, variable))
+        if (!statement->assign.is_dereference)
         {
-            cwr_instance_destroy(variable);
-            cwr_interpreter_error_throw_out_of_memory(error, statement.location);
-            return value;
+            int identifier = cwr_expression_pool_get(program_context.pool, statement->assign.identifier)->var.identifier;
+            cwr_tagged_value *slot = cwr_stack_at(program_context.stack, frame + identifier);
+
+            cwr_tagged_value_add_reference(&value);
+            cwr_tagged_value_remove_reference(slab, slot);
+            *slot = value;
+            return false;
         }
 
-        return NULL;
-    }
-    case cwr_statement_assign_type:
-    {
-        cwr_value *value = cwr_intepreter_evaluate_expr(program_context, statement.assign.value, root, error);
+        // Target is the dereference, its child is the pointer
+        cwr_expression_index child = cwr_expression_pool_get(program_context.pool, statement->assign.identifier)->unary.child;
+        cwr_tagged_value pointer = cwr_intepreter_evaluate_expr(program_context, child, frame, error);
         if (error->is_failed)
         {
-            return NULL;
+            cwr_tagged_value_release(slab, &value);
+            return false;
         }
 
-        cwr_value_add_reference(value);
-        if (!statement.assign.is_dereference)
+        if (!cwr_tagged_value_is_reference(&pointer) || cwr_tagged_value_is_reference(&value))
         {
-            cwr_instance *instance = cwr_scope_get(program_context.variables, root, statement.assign.identifier.var.identifier);
-            cwr_value *variable_value = instance->variable.value;
-
-            cwr_value_remove_reference(variable_value);
-            instance->variable.value = value;
-            return value;
+            cwr_tagged_value_release(slab, &value);
+            cwr_tagged_value_release(slab, &pointer);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_incorrect_type_type, "Incorrect type", statement->location);
+            return false;
         }
 
-        cwr_value *identifier = cwr_intepreter_evaluate_expr(program_context, statement.assign.identifier, root, error);
-        if (error->is_failed)
+        cwr_tagged_value_store(pointer.value, value);
+        cwr_tagged_value_release(slab, &pointer);
+        return false;
+    }
+    case cwr_statement_return_type:
+    {
+        if (statement->ret.is_tail_call)
         {
-            cwr_value_runtime_destroy(value);
-            return NULL;
+            // Checked again, the optimizer can inline the call into another expression
+            const cwr_expression *value = cwr_expression_pool_get(program_context.pool, statement->ret.value);
+            if (value->type == cwr_expression_func_call_type)
+            {
+                return cwr_intepreter_evaluate_tail_call(program_context, value->func_call, frame, cwr_expression_pool_location(program_context.pool, statement->ret.value), result, error);
+            }
         }
 
-        cwr_value_set(identifier, value);
-
-        // In 'identifier' we already have data from 'value', so we need free the block of memory
-        free(value);
-        return identifier;
-    }
-    case cwr_statement_return_type:
-        cwr_value *ret_value = cwr_intepreter_evaluate_expr(program_context, statement.ret.value, root, error);
+        *result = cwr_intepreter_evaluate_expr(program_context, statement->ret.value, frame, error);
         if (error->is_failed)
         {
-            return ret_value;
+            return false;
         }
 
-        if (statement.ret.with_body)
+        if (statement->ret.with_body)
         {
-            cwr_value *body_result = cwr_intepreter_evaluate_expr_body(program_context, statement.ret.body, root, error);
-            if (error->is_failed)
+            // A return inside the body leaves only the body
+            cwr_tagged_value body_result;
+            if (cwr_intepreter_evaluate_expr_body(program_context, &statement->ret.body, frame, &body_result, error))
             {
-                cwr_value_runtime_destroy(ret_value);
-                return ret_value;
+                cwr_tagged_value_release(slab, &body_result);
             }
 
-            if (body_result != NULL)
+            if (error->is_failed)
             {
-                cwr_value_runtime_destroy(body_result);
+                cwr_tagged_value_release(slab, result);
+                return false;
             }
         }
 
-        return ret_value;
+        return true;
+    }
     }
 
-    cwr_interpreter_error_throw(error, cwr_parser_error_unknown_statement_type, "Unknown statement", statement.location);
-    return NULL;
+    cwr_interpreter_error_throw(error, cwr_parser_error_unknown_statement_type, "Unknown statement", statement->location);
+    return false;
 }
 
-cwr_value *cwr_intepreter_evaluate_stat_func_call(cwr_program_context program_context, cwr_func_call_statement statement, cwr_func_body_expression *root, cwr_location location, cwr_interpreter_error *error)
+cwr_tagged_value cwr_intepreter_evaluate_stat_func_call(cwr_program_context program_context, const cwr_func_call_statement *statement, size_t frame, cwr_location location, cwr_interpreter_error *error)
 {
-    cwr_instance *function = cwr_scope_get(program_context.functions, root, statement.identifier);
-    cwr_value **arguments = malloc(statement.count * sizeof(cwr_value *));
+    cwr_func_call_statement call = *statement;
 
-    if (arguments == NULL)
+    size_t window;
+    cwr_instance *function = cwr_intepreter_enter_call(program_context, call, frame, location, &window, error);
+    if (function == NULL)
     {
-        cwr_interpreter_error_throw_out_of_memory(error, location);
-        return NULL;
+        return cwr_tagged_value_void();
     }
 
-    size_t count = 0;
     cwr_func_call_context context = (cwr_func_call_context){
         .context = program_context,
-        .arguments = arguments,
-        .count = 0,
+        .arguments = cwr_stack_at(program_context.stack, window),
+        .count = call.count,
         .location = location};
 
-    for (size_t i = 0; i < statement.count; i++)
-    {
-        cwr_value *argument = cwr_intepreter_evaluate_expr(program_context, statement.arguments[i], root, error);
-        if (error->is_failed)
-        {
-            cwr_func_call_context_destroy(context);
-            return NULL;
-        }
-
-        arguments[count] = argument;
-        context.count = ++count;
-    }
-
-    return cwr_intepreter_evaluate_func(function->function, context, error);
+    return cwr_intepreter_evaluate_func(&function->function, context, window, error);
 }
 
-cwr_value *cwr_intepreter_evaluate_func(cwr_function_instance instance, cwr_func_call_context context, cwr_interpreter_error *error)
+cwr_tagged_value cwr_intepreter_evaluate_func(const cwr_function_instance *instance, cwr_func_call_context context, size_t frame, cwr_interpreter_error *error)
 {
-    if (instance.type == cwr_function_instance_bind_type)
-    {
-        return instance.bind(context);
-    }
-
     cwr_program_context program_context = context.context;
-    size_t count = context.count;
 
-    // New scope
-    cwr_func_body_expression body = (cwr_func_body_expression){
-        .root = instance.body.root,
-        .statements = instance.body.statements,
-        .count = instance.body.count};
-    cwr_func_body_expression *body_pointer = &body;
-
-    for (size_t i = 0; i < count; i++)
+    cwr_tagged_value result;
+    if (instance->type == cwr_function_instance_bind_type)
     {
-        cwr_value *value = context.arguments[i];
-        cwr_argument argument = instance.arguments[i];
-        char *name = argument.name;
+        result = instance->bind(context);
+    }
+    else
+    {
+        while (true)
+        {
+            if (!cwr_intepreter_evaluate_expr_body(program_context, &instance->body, frame, &result, error))
+            {
+                result = cwr_tagged_value_void();
+            }
 
-        cwr_value_add_reference(value);
-        cwr_instance variable = (cwr_instance){
-            .type = cwr_instance_variable_type,
-            .root = body_pointer,
-            .identifier = argument.identifier,
-            .name = name,
-            .variable = (cwr_variable_instance){
-                .type = argument.type,
-                .value = value}};
+            int tail_call = program_context.stack->tail_call;
+            if (tail_call < 0)
+            {
+                break;
+            }
 
-        if (!cwr_scope_add(program_context.variables, variable))
-        {
-            cwr_instance_destroy(variable);
-            cwr_scope_root_destroy(program_context.variables, body_pointer);
-            cwr_interpreter_error_throw_out_of_memory(error, context.location);
-            return cwr_value_create_void();
+            program_context.stack->tail_call = -1;
+            instance = &cwr_scope_at(program_context.functions, tail_call)->function;
         }
     }
 
-    free(context.arguments);
+    // An array held by a variable of the frame outlives it and is a temporary again for the caller
+    bool is_reference = cwr_tagged_value_is_reference(&result);
+    if (is_reference)
+    {
+        cwr_value_add_reference(result.value);
+    }
+
+    cwr_stack_pop(program_context.stack);
+    if (is_reference)
+    {
+        result.value->references_count--;
+    }
 
-    cwr_value *result = cwr_intepreter_evaluate_expr_body(program_context, body, body_pointer, error);
-    cwr_scope_root_destroy(program_context.variables, body_pointer);
     return result;
 }
 
-cwr_value *cwr_intepreter_evaluate_expr(cwr_program_context program_context, cwr_expression expression, cwr_func_body_expression *root, cwr_interpreter_error *error)
+cwr_tagged_value cwr_intepreter_evaluate_expr(cwr_program_context program_context, cwr_expression_index index, size_t frame, cwr_interpreter_error *error)
 {
-    switch (expression.type)
+    const cwr_expression_pool *pool = program_context.pool;
+    cwr_slab *slab = program_context.slab;
+    // Points into the pool, which grows when a lazily parsed body is loaded, so fields are read before children run
+    const cwr_expression *expression = cwr_expression_pool_get(pool, index);
+
+    // Operands nest the walker on the native stack as calls do
+    if (cwr_intepreter_native_position() < program_context.stack->native_limit)
     {
-    case cwr_expression_array_type:
+        cwr_interpreter_error_throw_stack_overflow(error, cwr_expression_pool_location(pool, index));
+        return cwr_tagged_value_void();
+    }
+
+    switch (expression->type)
     {
-        switch (expression.array.type.value_type)
-        {
-        case cwr_value_character_type:
+    case cwr_expression_string_type:
+    {
+        char *characters = cwr_slab_allocate(slab, expression->string.length * sizeof(char));
+        if (characters == NULL)
         {
-            char *characters = malloc(expression.array.count * sizeof(char));
-
-            if (characters == NULL)
-            {
-                cwr_interpreter_error_throw_out_of_memory(error, expression.location);
-                return NULL;
-            }
-
-            for (size_t i = 0; i < expression.array.count; i++)
-            {
-                characters[i] = expression.array.elements[i].character.value;
-            }
+            cwr_interpreter_error_throw_out_of_memory(error, cwr_expression_pool_location(pool, index));
+            return cwr_tagged_value_void();
+        }
 
-            cwr_array_value array = (cwr_array_value){
-                .type = expression.array.type.value_type,
-                .capacity = expression.array.count,
-                .is_reference = false,
-                .characters = characters};
+        memcpy(characters, cwr_expression_pool_string(pool, expression->string), expression->string.length);
 
-            cwr_value *characters_value = cwr_value_create_array(array);
-            if (characters_value == NULL)
-            {
-                free(characters);
-                cwr_interpreter_error_throw_out_of_memory(error, expression.location);
-            }
-
-            return characters_value;
-        }
+        cwr_value *string = cwr_value_create_array(slab, (cwr_array_value){
+            .type = cwr_value_character_type,
+            .capacity = expression->string.length,
+            .is_reference = false,
+            .characters = characters});
+        if (string == NULL)
+        {
+            cwr_slab_free(slab, characters, expression->string.length * sizeof(char));
+            cwr_interpreter_error_throw_out_of_memory(error, cwr_expression_pool_location(pool, index));
+            return cwr_tagged_value_void();
         }
+
+        return cwr_tagged_value_array(cwr_value_array_type, string);
     }
     case cwr_expression_unary_type:
-        cwr_value *value = cwr_intepreter_evaluate_expr(program_context, expression.unary.child[0], root, error);
+    {
+        cwr_binary_operator_type operator = expression->unary.type;
+        cwr_binary_kernel_type kernel = expression->unary.kernel;
+        cwr_tagged_value value = cwr_intepreter_evaluate_expr(program_context, expression->unary.child, frame, error);
         if (error->is_failed)
         {
             return value;
         }
 
-        cwr_value *result = value;
-        switch (expression.unary.type)
+        cwr_tagged_value result = value;
+        switch (operator)
         {
         case cwr_binary_operator_minus_type:
-            if (result->type == cwr_value_float_type)
-            {
-                result = cwr_value_create_float(-cwr_value_as_float(value));
-            }
-            else
-            {
-                result = cwr_value_create_integer(-cwr_value_as_integer(value));
-            }
-
-            break;
         case cwr_binary_operator_negation_type:
-            if (result->type == cwr_value_float_type)
+            result = cwr_tagged_value_apply_unary(operator, kernel, &value);
+            break;
+        case cwr_binary_operator_reference_type:
+        {
+            // Scalars have no value to point at, a copy of them is made for the pointer
+            cwr_value *target = cwr_tagged_value_box(slab, value);
+            cwr_value *pointer = target == NULL ? NULL : cwr_value_reference(slab, target);
+            if (pointer == NULL)
             {
-                result = cwr_value_create_float(!cwr_value_as_float(value));
+                cwr_interpreter_error_throw_out_of_memory(error, cwr_expression_pool_location(pool, index));
+                return cwr_tagged_value_void();
             }
-            else
+
+            return cwr_tagged_value_array(cwr_value_pointer_type, pointer);
+        }
+        case cwr_binary_operator_dereference_type:
+            if (!cwr_tagged_value_is_reference(&value))
             {
-                result = cwr_value_create_integer(!cwr_value_as_integer(value));
+                cwr_interpreter_error_throw(error, cwr_interpreter_error_incorrect_type_type, "Incorrect type", cwr_expression_pool_location(pool, index));
+                return cwr_tagged_value_void();
             }
 
+            result = cwr_tagged_value_dereference(value.value);
             break;
-        case cwr_binary_operator_reference_type:
-            result = cwr_value_reference(value);
-            break;
-        case cwr_binary_operator_dereference_type:
-            result = cwr_value_dereference(value);
-            break;
-        }
-
-        cwr_value_runtime_destroy(value);
-        if (result == NULL)
-        {
-            cwr_interpreter_error_throw_out_of_memory(error, expression.location);
+        default:
+            return value;
         }
 
+        cwr_tagged_value_release(slab, &value);
         return result;
+    }
     case cwr_expression_float_type:
-        cwr_value *number = cwr_value_create_float(expression.float_n.value);
-        if (number == NULL)
-        {
-            cwr_interpreter_error_throw_out_of_memory(error, expression.location);
-        }
-
-        return number;
+        return cwr_tagged_value_float(expression->float_n.value);
     case cwr_expression_integer_type:
-        cwr_value *integer_n = cwr_value_create_integer(expression.integer_n.value);
-        if (integer_n == NULL)
-        {
-            cwr_interpreter_error_throw_out_of_memory(error, expression.location);
-        }
-
-        return integer_n;
+        return cwr_tagged_value_integer(expression->integer_n.value);
     case cwr_expression_character_type:
-        cwr_value *character = cwr_value_create_character(expression.character.value);
-        if (character == NULL)
-        {
-            cwr_interpreter_error_throw_out_of_memory(error, expression.location);
-        }
-
-        return character;
+        return cwr_tagged_value_character(expression->character.value);
     case cwr_expression_var_type:
-        return cwr_scope_get(program_context.variables, root, expression.var.identifier)->variable.value;
+        return *cwr_stack_at(program_context.stack, frame + expression->var.identifier);
     case cwr_expression_func_call_type:
-        return cwr_intepreter_evaluate_stat_func_call(program_context, expression.func_call, root, expression.location, error);
+        return cwr_intepreter_evaluate_stat_func_call(program_context, &expression->func_call, frame, cwr_expression_pool_location(pool, index), error);
     case cwr_expression_binary_type:
     {
-        cwr_value *left = cwr_intepreter_evaluate_expr(program_context, expression.binary.children[0], root, error);
-        if (error->is_failed)
-        {
-            return NULL;
-        }
+        cwr_binary_operator_type operator = expression->binary.type;
+        cwr_binary_kernel_type kernel = expression->binary.kernel;
+        cwr_expression_index right_index = expression->binary.children[1];
+        const cwr_quickened_expression *quickened = cwr_quickening_get(program_context.quickening, index);
+        cwr_tagged_value result;
 
-        cwr_value *right = cwr_intepreter_evaluate_expr(program_context, expression.binary.children[1], root, error);
-        if (error->is_failed)
+        if (quickened != NULL && quickened->type != cwr_quickened_generic_type)
         {
-            cwr_value_runtime_destroy(left);
-            return NULL;
-        }
+            // Locals are only read, so nothing is released
+            cwr_tagged_value constant;
+            const cwr_tagged_value *left = cwr_stack_at(program_context.stack, frame + quickened->slots[0]);
+            const cwr_tagged_value *right = cwr_intepreter_quickened_right(program_context, quickened, frame, &constant);
 
-        float left_number = cwr_value_as_float(left);
-        float right_number = cwr_value_as_float(right);
-        float result;
-        switch (expression.binary.type)
-        {
-        case cwr_binary_operator_plus_type:
-            result = left_number + right_number;
-            break;
-        case cwr_binary_operator_minus_type:
-            result = left_number - right_number;
-            break;
-        case cwr_binary_operator_multiplicative_type:
-            result = left_number * right_number;
-            break;
-        case cwr_binary_operator_division_type:
-            if (right_number == 0)
+            if (!cwr_tagged_value_apply(operator, kernel, left, right, &result))
             {
-                cwr_interpreter_error_throw(error, cwr_interpreter_error_division_by_zero_type, "Division by zero", expression.location);
-                break;
+                cwr_interpreter_error_throw(error, cwr_interpreter_error_division_by_zero_type, "Division by zero", cwr_expression_pool_location(pool, index));
+                return cwr_tagged_value_void();
             }
 
-            result = left_number / right_number;
-            break;
-        case cwr_binary_operator_not_equals_type:
-            result = left_number != right_number;
-            break;
-        case cwr_binary_operator_equals_type:
-            result = left_number == right_number;
-            break;
-        case cwr_binary_operator_greater_than_type:
-            result = left_number > right_number;
-            break;
-        case cwr_binary_operator_less_than_type:
-            result = left_number < right_number;
-            break;
-        case cwr_binary_operator_greater_equals_than_type:
-            result = left_number >= right_number;
-            break;
-        case cwr_binary_operator_less_equals_than_type:
-            result = left_number <= right_number;
-            break;
+            return result;
         }
 
+        cwr_tagged_value left = cwr_intepreter_evaluate_expr(program_context, expression->binary.children[0], frame, error);
         if (error->is_failed)
         {
-            cwr_value_runtime_destroy(left);
-            cwr_value_runtime_destroy(right);
-            return NULL;
+            return left;
         }
 
-        cwr_value *value_result;
-
-        if (left->type == cwr_value_float_type || right->type == cwr_value_float_type)
+        cwr_tagged_value right = cwr_intepreter_evaluate_expr(program_context, right_index, frame, error);
+        if (error->is_failed)
         {
-            value_result = cwr_value_create_float(result);
+            cwr_tagged_value_release(slab, &left);
+            return right;
         }
-        else
+
+        if (!cwr_tagged_value_apply(operator, kernel, &left, &right, &result))
         {
-            value_result = cwr_value_create_integer(result);
+            cwr_tagged_value_release(slab, &left);
+            cwr_tagged_value_release(slab, &right);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_division_by_zero_type, "Division by zero", cwr_expression_pool_location(pool, index));
+            return cwr_tagged_value_void();
         }
 
-        cwr_value_runtime_destroy(left);
-        cwr_value_runtime_destroy(right);
-
-        if (value_result == NULL)
+        cwr_tagged_value_release(slab, &left);
+        cwr_tagged_value_release(slab, &right);
+        if (quickened == NULL)
         {
-            cwr_interpreter_error_throw_out_of_memory(error, expression.location);
+            cwr_intepreter_quicken_binary(program_context, index);
         }
 
-        return value_result;
+        return result;
     }
     case cwr_expression_array_element_type:
     {
-        cwr_value *value = cwr_intepreter_evaluate_expr(program_context, expression.array_element.children[0], root, error);
+        cwr_expression_index position_index = expression->array_element.children[1];
+        cwr_tagged_value value = cwr_intepreter_evaluate_expr(program_context, expression->array_element.children[0], frame, error);
         if (error->is_failed)
         {
-            return NULL;
+            return value;
         }
 
-        cwr_value *index = cwr_intepreter_evaluate_expr(program_context, expression.array_element.children[1], root, error);
+        cwr_tagged_value position = cwr_intepreter_evaluate_expr(program_context, position_index, frame, error);
         if (error->is_failed)
         {
-            cwr_value_runtime_destroy(value);
-            return NULL;
+            cwr_tagged_value_release(slab, &value);
+            return position;
         }
 
-        int target = cwr_value_as_float(index);
+        int target = cwr_tagged_value_as_integer(&position);
+        cwr_tagged_value_release(slab, &position);
+
         if (target < 0)
         {
-            cwr_value_runtime_destroy(value);
-            cwr_value_runtime_destroy(index);
-            cwr_interpreter_error_throw(error, cwr_interpreter_error_negative_index_type, "Index must be non-negative", expression.location);
-            return NULL;
+            cwr_tagged_value_release(slab, &value);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_negative_index_type, "Index must be non-negative", cwr_expression_pool_location(pool, index));
+            return cwr_tagged_value_void();
         }
 
-        if (target > value->array.capacity - 1)
+        if (target > value.value->array.capacity - 1)
         {
-            cwr_value_runtime_destroy(value);
-            cwr_value_runtime_destroy(index);
-            cwr_interpreter_error_throw(error, cwr_interpreter_error_index_out_of_range_type, "Index out of range", expression.location);
-            return NULL;
+            cwr_tagged_value_release(slab, &value);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_index_out_of_range_type, "Index out of range", cwr_expression_pool_location(pool, index));
+            return cwr_tagged_value_void();
         }
 
-        cwr_value *element = cwr_value_at(value->array, target);
-        cwr_value_runtime_destroy(value);
-        cwr_value_runtime_destroy(index);
+        cwr_tagged_value element = cwr_tagged_value_at(value.value->array, target);
+        cwr_tagged_value_release(slab, &value);
         return element;
     }
     }
 
-    cwr_interpreter_error_throw(error, cwr_interpreter_error_unknown_expression_type, "Unknown expression", expression.location);
-    return NULL;
+    cwr_interpreter_error_throw(error, cwr_interpreter_error_unknown_expression_type, "Unknown expression", cwr_expression_pool_location(pool, index));
+    return cwr_tagged_value_void();
 }
 
-cwr_value *cwr_intepreter_evaluate_expr_body(cwr_program_context program_context, cwr_func_body_expression expression, cwr_func_body_expression *root, cwr_interpreter_error *error)
+bool cwr_intepreter_evaluate_expr_body(cwr_program_context program_context, const cwr_func_body_expression *expression, size_t frame, cwr_tagged_value *result, cwr_interpreter_error *error)
 {
-    for (size_t i = 0; i < expression.count; i++)
+    for (size_t i = 0; i < expression->count; i++)
     {
-        cwr_statement statement = expression.statements[i];
-        cwr_value *result = cwr_intepreter_evaluate_stat(program_context, statement, root, error);
-        if (error->is_failed || statement.type == cwr_statement_return_type)
-        {
-            return result;
-        }
-
-        if (statement.is_block && result != NULL)
+        // Only return statements and the blocks around them report a return, so it leaves this body too
+        if (cwr_intepreter_evaluate_stat(program_context, &expression->statements[i], frame, result, error))
         {
-            return result;
+            return true;
         }
 
-        if (result != NULL)
+        if (error->is_failed)
         {
-            cwr_value_runtime_destroy(result);
+            return false;
         }
     }
 
-    return NULL;
+    return false;
 }
 
 void cwr_interpreter_result_destroy(cwr_interpreter_result result)
 {
+    cwr_machine_destroy(result.machine);
     cwr_program_context_destroy(result.context);
 }
 
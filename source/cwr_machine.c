@@ -0,0 +1,769 @@
+#include <stdlib.h>
+#include <string.h>
+#include <cwr_machine.h>
+#include <cwr_interpreter.h>
+#include <cwr_scope.h>
+
+#if defined(__GNUC__)
+// Handlers jump to the next one through a table of label addresses
+#define CWR_MACHINE_THREADED
+#endif
+
+#ifdef CWR_MACHINE_THREADED
+#define CWR_MACHINE_CASE(name) instruction_##name
+#define CWR_MACHINE_NEXT() goto *labels[pc->type]
+#else
+#define CWR_MACHINE_CASE(name) case cwr_instruction_##name##_type
+#define CWR_MACHINE_NEXT() goto dispatch
+#endif
+
+#define CWR_MACHINE_LOCATION() function->locations[pc - function->instructions]
+
+#define CWR_MACHINE_ARITHMETIC(operator)                                                                                   \
+    {                                                                                                                      \
+        if (!cwr_tagged_value_apply(operator, cwr_binary_kernel_generic_type, &registers[pc->b], &registers[pc->c], &registers[pc->a])) \
+        {                                                                                                                  \
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_division_by_zero_type, "Division by zero", CWR_MACHINE_LOCATION()); \
+            goto failure;                                                                                                  \
+        }                                                                                                                  \
+                                                                                                                           \
+        pc++;                                                                                                              \
+        CWR_MACHINE_NEXT();                                                                                                \
+    }
+
+// Integers go through 'cast' so arithmetic wraps and comparisons stay signed
+#define CWR_MACHINE_KERNEL(value_type, field, create, cast, operator, operator_type)                  \
+    {                                                                                                 \
+        const cwr_tagged_value *left = &registers[pc->b];                                             \
+        const cwr_tagged_value *right = &registers[pc->c];                                            \
+        if (left->type == value_type && right->type == value_type)                                    \
+        {                                                                                             \
+            registers[pc->a] = create((cast)left->field operator (cast)right->field);                 \
+            pc++;                                                                                     \
+            CWR_MACHINE_NEXT();                                                                       \
+        }                                                                                             \
+                                                                                                      \
+        CWR_MACHINE_ARITHMETIC(operator_type);                                                        \
+    }
+
+#define CWR_MACHINE_INTEGER(operator, operator_type) \
+    CWR_MACHINE_KERNEL(cwr_value_integer_type, integer_n, cwr_tagged_value_integer, unsigned int, operator, operator_type)
+
+#define CWR_MACHINE_INTEGER_COMPARE(operator, operator_type) \
+    CWR_MACHINE_KERNEL(cwr_value_integer_type, integer_n, cwr_tagged_value_integer, int, operator, operator_type)
+
+#define CWR_MACHINE_FLOAT(operator, operator_type) \
+    CWR_MACHINE_KERNEL(cwr_value_float_type, float_n, cwr_tagged_value_float, float, operator, operator_type)
+
+#define CWR_MACHINE_FLOAT_COMPARE(operator, operator_type) \
+    CWR_MACHINE_KERNEL(cwr_value_float_type, float_n, cwr_tagged_value_integer, float, operator, operator_type)
+
+#define CWR_MACHINE_JUMP(condition)                            \
+    {                                                          \
+        if (condition)                                         \
+        {                                                      \
+            pc += 2;                                           \
+        }                                                      \
+        else                                                   \
+        {                                                      \
+            pc = &function->instructions[pc[1].index];         \
+        }                                                      \
+                                                               \
+        CWR_MACHINE_NEXT();                                    \
+    }
+
+#define CWR_MACHINE_BRANCH(operator_type) \
+    CWR_MACHINE_JUMP(cwr_tagged_value_compare(operator_type, cwr_binary_kernel_generic_type, &registers[pc->b], &registers[pc->c]))
+
+#define CWR_MACHINE_BRANCH_KERNEL(value_type, field, operator, operator_type)                                                 \
+    {                                                                                                                        \
+        const cwr_tagged_value *left = &registers[pc->b];                                                                    \
+        const cwr_tagged_value *right = &registers[pc->c];                                                                   \
+        if (left->type == value_type && right->type == value_type)                                                           \
+        {                                                                                                                    \
+            CWR_MACHINE_JUMP(left->field operator right->field);                                                             \
+        }                                                                                                                    \
+                                                                                                                             \
+        CWR_MACHINE_BRANCH(operator_type);                                                                                   \
+    }
+
+typedef struct cwr_machine_frame
+{
+    const cwr_bytecode_function *function;
+    const cwr_instruction *call;
+    size_t base;
+} cwr_machine_frame;
+
+typedef struct cwr_machine
+{
+    cwr_program_context context;
+    cwr_walker *walker;
+    cwr_bytecode_function **functions;
+    size_t functions_size;
+    size_t functions_capacity;
+    cwr_tagged_value *registers;
+    size_t registers_size;
+    cwr_machine_frame *frames;
+    size_t frames_size;
+    size_t frames_capacity;
+    size_t max_depth;
+} cwr_machine;
+
+static const cwr_bytecode_function *cwr_machine_function(cwr_machine *machine, cwr_instance *instance, cwr_location location, cwr_interpreter_error *error)
+{
+    size_t identifier = instance->identifier;
+    if (identifier < machine->functions_capacity && machine->functions[identifier] != NULL)
+    {
+        return machine->functions[identifier];
+    }
+
+    if (instance->function.type == cwr_function_instance_bind_type)
+    {
+        return NULL;
+    }
+
+    if (identifier >= machine->functions_capacity)
+    {
+        size_t count = identifier + 1 - machine->functions_capacity;
+        if (!CWR_VECTOR_RESERVE(machine->functions, machine->functions_size, machine->functions_capacity, count))
+        {
+            cwr_interpreter_error_throw_out_of_memory(error, location);
+            return NULL;
+        }
+
+        memset(&machine->functions[machine->functions_capacity], 0, count * sizeof(cwr_bytecode_function *));
+        machine->functions_capacity = identifier + 1;
+    }
+
+    if (instance->function.is_lazy)
+    {
+        cwr_intepreter_load_function(machine->context, instance, error);
+        if (error->is_failed)
+        {
+            return NULL;
+        }
+    }
+
+    machine->functions[identifier] = cwr_bytecode_compile(machine->walker, machine->context.pool, instance->function, location, error);
+    return machine->functions[identifier];
+}
+
+static bool cwr_machine_enter(cwr_machine *machine, const cwr_bytecode_function *function, const cwr_instruction *call, size_t base, size_t count, cwr_location location, cwr_interpreter_error *error)
+{
+    if (machine->frames_capacity >= machine->max_depth)
+    {
+        cwr_interpreter_error_throw_stack_overflow(error, location);
+        return false;
+    }
+
+    if (!CWR_VECTOR_RESERVE(machine->registers, machine->registers_size, base, function->registers) ||
+        !CWR_VECTOR_RESERVE(machine->frames, machine->frames_size, machine->frames_capacity, 1))
+    {
+        cwr_interpreter_error_throw_out_of_memory(error, location);
+        return false;
+    }
+
+    cwr_tagged_value *registers = &machine->registers[base];
+    if (function->with_references)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            cwr_tagged_value_add_reference(&registers[i]);
+        }
+
+        // Stores release what a slot held, so slots of earlier frames must not look like arrays
+        memset(&registers[count], 0, (function->frame_size - count) * sizeof(cwr_tagged_value));
+    }
+
+    if (function->constants_capacity > 0)
+    {
+        memcpy(&registers[function->frame_size], function->constants, function->constants_capacity * sizeof(cwr_tagged_value));
+    }
+
+    machine->frames[machine->frames_capacity++] = (cwr_machine_frame){
+        .function = function,
+        .call = call,
+        .base = base};
+    return true;
+}
+
+static void cwr_machine_leave(cwr_machine *machine, cwr_tagged_value *result)
+{
+    cwr_machine_frame frame = machine->frames[--machine->frames_capacity];
+    if (!frame.function->with_references)
+    {
+        return;
+    }
+
+    bool is_reference = cwr_tagged_value_is_reference(result);
+    if (is_reference)
+    {
+        cwr_value_add_reference(result->value);
+    }
+
+    cwr_tagged_value *registers = &machine->registers[frame.base];
+    for (size_t i = 0; i < frame.function->frame_size; i++)
+    {
+        cwr_tagged_value_remove_reference(machine->context.slab, &registers[i]);
+    }
+
+    if (is_reference)
+    {
+        result->value->references_count--;
+    }
+}
+
+static const cwr_instruction *cwr_machine_leave_for_tail_call(cwr_machine *machine, cwr_tagged_value *arguments, size_t count)
+{
+    cwr_machine_frame frame = machine->frames[--machine->frames_capacity];
+    cwr_tagged_value *registers = &machine->registers[frame.base];
+    if (frame.function->with_references)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            cwr_tagged_value_add_reference(&arguments[i]);
+        }
+
+        for (size_t i = 0; i < frame.function->frame_size; i++)
+        {
+            cwr_tagged_value_remove_reference(machine->context.slab, &registers[i]);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (cwr_tagged_value_is_reference(&arguments[i]))
+            {
+                arguments[i].value->references_count--;
+            }
+        }
+    }
+
+    memmove(registers, arguments, count * sizeof(cwr_tagged_value));
+    return frame.call;
+}
+
+static void cwr_machine_call_bind(cwr_machine *machine, cwr_instance *instance, const cwr_bytecode_call *call, cwr_tagged_value *arguments)
+{
+    cwr_func_call_context context = (cwr_func_call_context){
+        .context = machine->context,
+        .arguments = arguments,
+        .count = call->count,
+        .location = call->location};
+
+    cwr_tagged_value result = instance->function.bind(context);
+    for (size_t i = 0; i < call->count; i++)
+    {
+        cwr_tagged_value_release(machine->context.slab, &arguments[i]);
+    }
+
+    arguments[0] = result;
+}
+
+static cwr_value *cwr_machine_create_string(cwr_slab *slab, const cwr_expression_pool *pool, const cwr_expression *expression)
+{
+    char *characters = cwr_slab_allocate(slab, expression->string.length * sizeof(char));
+    if (characters == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(characters, cwr_expression_pool_string(pool, expression->string), expression->string.length);
+
+    cwr_value *string = cwr_value_create_array(slab, (cwr_array_value){
+        .type = cwr_value_character_type,
+        .capacity = expression->string.length,
+        .is_reference = false,
+        .characters = characters});
+    if (string == NULL)
+    {
+        cwr_slab_free(slab, characters, expression->string.length * sizeof(char));
+    }
+
+    return string;
+}
+
+static bool cwr_machine_execute(cwr_machine *machine, size_t frames, cwr_tagged_value *result, cwr_interpreter_error *error)
+{
+    const cwr_expression_pool *pool = machine->context.pool;
+    cwr_slab *slab = machine->context.slab;
+    cwr_machine_frame *frame = &machine->frames[machine->frames_capacity - 1];
+    const cwr_bytecode_function *function = frame->function;
+    size_t base = frame->base;
+    cwr_tagged_value *registers = &machine->registers[base];
+    const cwr_instruction *pc = function->instructions;
+    cwr_tagged_value value;
+
+#ifdef CWR_MACHINE_THREADED
+    static const void *labels[] = {
+        [cwr_instruction_move_type] = &&instruction_move,
+        [cwr_instruction_load_string_type] = &&instruction_load_string,
+        [cwr_instruction_add_type] = &&instruction_add,
+        [cwr_instruction_add_integer_type] = &&instruction_add_integer,
+        [cwr_instruction_add_float_type] = &&instruction_add_float,
+        [cwr_instruction_subtract_type] = &&instruction_subtract,
+        [cwr_instruction_subtract_integer_type] = &&instruction_subtract_integer,
+        [cwr_instruction_subtract_float_type] = &&instruction_subtract_float,
+        [cwr_instruction_multiply_type] = &&instruction_multiply,
+        [cwr_instruction_multiply_integer_type] = &&instruction_multiply_integer,
+        [cwr_instruction_multiply_float_type] = &&instruction_multiply_float,
+        [cwr_instruction_divide_type] = &&instruction_divide,
+        [cwr_instruction_divide_integer_type] = &&instruction_divide_integer,
+        [cwr_instruction_divide_float_type] = &&instruction_divide_float,
+        [cwr_instruction_equals_type] = &&instruction_equals,
+        [cwr_instruction_equals_integer_type] = &&instruction_equals_integer,
+        [cwr_instruction_equals_float_type] = &&instruction_equals_float,
+        [cwr_instruction_not_equals_type] = &&instruction_not_equals,
+        [cwr_instruction_not_equals_integer_type] = &&instruction_not_equals_integer,
+        [cwr_instruction_not_equals_float_type] = &&instruction_not_equals_float,
+        [cwr_instruction_greater_type] = &&instruction_greater,
+        [cwr_instruction_greater_integer_type] = &&instruction_greater_integer,
+        [cwr_instruction_greater_float_type] = &&instruction_greater_float,
+        [cwr_instruction_less_type] = &&instruction_less,
+        [cwr_instruction_less_integer_type] = &&instruction_less_integer,
+        [cwr_instruction_less_float_type] = &&instruction_less_float,
+        [cwr_instruction_greater_equals_type] = &&instruction_greater_equals,
+        [cwr_instruction_greater_equals_integer_type] = &&instruction_greater_equals_integer,
+        [cwr_instruction_greater_equals_float_type] = &&instruction_greater_equals_float,
+        [cwr_instruction_less_equals_type] = &&instruction_less_equals,
+        [cwr_instruction_less_equals_integer_type] = &&instruction_less_equals_integer,
+        [cwr_instruction_less_equals_float_type] = &&instruction_less_equals_float,
+        [cwr_instruction_zero_type] = &&instruction_zero,
+        [cwr_instruction_negate_type] = &&instruction_negate,
+        [cwr_instruction_not_type] = &&instruction_not,
+        [cwr_instruction_reference_type] = &&instruction_reference,
+        [cwr_instruction_dereference_type] = &&instruction_dereference,
+        [cwr_instruction_element_type] = &&instruction_element,
+        [cwr_instruction_jump_type] = &&instruction_jump,
+        [cwr_instruction_jump_false_type] = &&instruction_jump_false,
+        [cwr_instruction_jump_not_equals_type] = &&instruction_jump_not_equals,
+        [cwr_instruction_jump_not_equals_integer_type] = &&instruction_jump_not_equals_integer,
+        [cwr_instruction_jump_not_equals_float_type] = &&instruction_jump_not_equals_float,
+        [cwr_instruction_jump_not_not_equals_type] = &&instruction_jump_not_not_equals,
+        [cwr_instruction_jump_not_not_equals_integer_type] = &&instruction_jump_not_not_equals_integer,
+        [cwr_instruction_jump_not_not_equals_float_type] = &&instruction_jump_not_not_equals_float,
+        [cwr_instruction_jump_not_greater_type] = &&instruction_jump_not_greater,
+        [cwr_instruction_jump_not_greater_integer_type] = &&instruction_jump_not_greater_integer,
+        [cwr_instruction_jump_not_greater_float_type] = &&instruction_jump_not_greater_float,
+        [cwr_instruction_jump_not_less_type] = &&instruction_jump_not_less,
+        [cwr_instruction_jump_not_less_integer_type] = &&instruction_jump_not_less_integer,
+        [cwr_instruction_jump_not_less_float_type] = &&instruction_jump_not_less_float,
+        [cwr_instruction_jump_not_greater_equals_type] = &&instruction_jump_not_greater_equals,
+        [cwr_instruction_jump_not_greater_equals_integer_type] = &&instruction_jump_not_greater_equals_integer,
+        [cwr_instruction_jump_not_greater_equals_float_type] = &&instruction_jump_not_greater_equals_float,
+        [cwr_instruction_jump_not_less_equals_type] = &&instruction_jump_not_less_equals,
+        [cwr_instruction_jump_not_less_equals_integer_type] = &&instruction_jump_not_less_equals_integer,
+        [cwr_instruction_jump_not_less_equals_float_type] = &&instruction_jump_not_less_equals_float,
+        [cwr_instruction_store_type] = &&instruction_store,
+        [cwr_instruction_store_dereference_type] = &&instruction_store_dereference,
+        [cwr_instruction_release_type] = &&instruction_release,
+        [cwr_instruction_call_type] = &&instruction_call,
+        [cwr_instruction_tail_call_type] = &&instruction_tail_call,
+        [cwr_instruction_return_type] = &&instruction_return,
+        [cwr_instruction_return_none_type] = &&instruction_return_none,
+        [cwr_instruction_fail_type] = &&instruction_fail};
+
+    CWR_MACHINE_NEXT();
+#else
+dispatch:
+    switch (pc->type)
+#endif
+    {
+    CWR_MACHINE_CASE(move):
+        registers[pc->a] = registers[pc->b];
+        pc++;
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(load_string):
+    {
+        cwr_value *string = cwr_machine_create_string(slab, pool, cwr_expression_pool_get(pool, pc->index));
+        if (string == NULL)
+        {
+            cwr_interpreter_error_throw_out_of_memory(error, CWR_MACHINE_LOCATION());
+            goto failure;
+        }
+
+        registers[pc->a] = cwr_tagged_value_array(cwr_value_array_type, string);
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(add):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_plus_type);
+    CWR_MACHINE_CASE(add_integer):
+        CWR_MACHINE_INTEGER(+, cwr_binary_operator_plus_type);
+    CWR_MACHINE_CASE(add_float):
+        CWR_MACHINE_FLOAT(+, cwr_binary_operator_plus_type);
+    CWR_MACHINE_CASE(subtract):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_minus_type);
+    CWR_MACHINE_CASE(subtract_integer):
+        CWR_MACHINE_INTEGER(-, cwr_binary_operator_minus_type);
+    CWR_MACHINE_CASE(subtract_float):
+        CWR_MACHINE_FLOAT(-, cwr_binary_operator_minus_type);
+    CWR_MACHINE_CASE(multiply):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_multiplicative_type);
+    CWR_MACHINE_CASE(multiply_integer):
+        CWR_MACHINE_INTEGER(*, cwr_binary_operator_multiplicative_type);
+    CWR_MACHINE_CASE(multiply_float):
+        CWR_MACHINE_FLOAT(*, cwr_binary_operator_multiplicative_type);
+    CWR_MACHINE_CASE(divide):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_division_type);
+    // Division by zero is checked by the generic kernel
+    CWR_MACHINE_CASE(divide_integer):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_division_type);
+    CWR_MACHINE_CASE(divide_float):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_division_type);
+    CWR_MACHINE_CASE(equals):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(equals_integer):
+        CWR_MACHINE_INTEGER_COMPARE(==, cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(equals_float):
+        CWR_MACHINE_FLOAT_COMPARE(==, cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(not_equals):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(not_equals_integer):
+        CWR_MACHINE_INTEGER_COMPARE(!=, cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(not_equals_float):
+        CWR_MACHINE_FLOAT_COMPARE(!=, cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(greater):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(greater_integer):
+        CWR_MACHINE_INTEGER_COMPARE(>, cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(greater_float):
+        CWR_MACHINE_FLOAT_COMPARE(>, cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(less):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(less_integer):
+        CWR_MACHINE_INTEGER_COMPARE(<, cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(less_float):
+        CWR_MACHINE_FLOAT_COMPARE(<, cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(greater_equals):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(greater_equals_integer):
+        CWR_MACHINE_INTEGER_COMPARE(>=, cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(greater_equals_float):
+        CWR_MACHINE_FLOAT_COMPARE(>=, cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(less_equals):
+        CWR_MACHINE_ARITHMETIC(cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(less_equals_integer):
+        CWR_MACHINE_INTEGER_COMPARE(<=, cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(less_equals_float):
+        CWR_MACHINE_FLOAT_COMPARE(<=, cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(zero):
+        registers[pc->a] = cwr_tagged_value_number(&registers[pc->b], &registers[pc->c], 0);
+        pc++;
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(negate):
+        registers[pc->a] = cwr_tagged_value_apply_unary(cwr_binary_operator_minus_type, pc->c, &registers[pc->b]);
+        pc++;
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(not):
+        registers[pc->a] = cwr_tagged_value_apply_unary(cwr_binary_operator_negation_type, pc->c, &registers[pc->b]);
+        pc++;
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(reference):
+    {
+        // Scalars are boxed to have a value to point at
+        cwr_value *target = cwr_tagged_value_box(slab, registers[pc->b]);
+        cwr_value *pointer = target == NULL ? NULL : cwr_value_reference(slab, target);
+        if (pointer == NULL)
+        {
+            cwr_interpreter_error_throw_out_of_memory(error, CWR_MACHINE_LOCATION());
+            goto failure;
+        }
+
+        registers[pc->a] = cwr_tagged_value_array(cwr_value_pointer_type, pointer);
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(dereference):
+    {
+        value = registers[pc->b];
+        if (!cwr_tagged_value_is_reference(&value))
+        {
+            goto instruction_incorrect_type;
+        }
+
+        registers[pc->a] = cwr_tagged_value_dereference(value.value);
+        cwr_value_runtime_destroy(slab, value.value);
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(element):
+    {
+        value = registers[pc->b];
+        if (!cwr_tagged_value_is_reference(&value))
+        {
+            goto instruction_incorrect_type;
+        }
+
+        cwr_array_value array = value.value->array;
+        int position = cwr_tagged_value_as_integer(&registers[pc->c]);
+        if (position < 0)
+        {
+            cwr_value_runtime_destroy(slab, value.value);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_negative_index_type, "Index must be non-negative", CWR_MACHINE_LOCATION());
+            goto failure;
+        }
+
+        if ((size_t)position >= array.capacity)
+        {
+            cwr_value_runtime_destroy(slab, value.value);
+            cwr_interpreter_error_throw(error, cwr_interpreter_error_index_out_of_range_type, "Index out of range", CWR_MACHINE_LOCATION());
+            goto failure;
+        }
+
+        registers[pc->a] = cwr_tagged_value_at(array, position);
+
+        cwr_value_runtime_destroy(slab, value.value);
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(jump):
+        pc = &function->instructions[pc->index];
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(jump_false):
+        if (cwr_tagged_value_as_integer(&registers[pc->a]))
+        {
+            pc++;
+        }
+        else
+        {
+            pc = &function->instructions[pc->index];
+        }
+
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(jump_not_equals):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(jump_not_equals_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, ==, cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(jump_not_equals_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, ==, cwr_binary_operator_equals_type);
+    CWR_MACHINE_CASE(jump_not_not_equals):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(jump_not_not_equals_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, !=, cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(jump_not_not_equals_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, !=, cwr_binary_operator_not_equals_type);
+    CWR_MACHINE_CASE(jump_not_greater):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(jump_not_greater_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, >, cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(jump_not_greater_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, >, cwr_binary_operator_greater_than_type);
+    CWR_MACHINE_CASE(jump_not_less):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(jump_not_less_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, <, cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(jump_not_less_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, <, cwr_binary_operator_less_than_type);
+    CWR_MACHINE_CASE(jump_not_greater_equals):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(jump_not_greater_equals_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, >=, cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(jump_not_greater_equals_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, >=, cwr_binary_operator_greater_equals_than_type);
+    CWR_MACHINE_CASE(jump_not_less_equals):
+        CWR_MACHINE_BRANCH(cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(jump_not_less_equals_integer):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_integer_type, integer_n, <=, cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(jump_not_less_equals_float):
+        CWR_MACHINE_BRANCH_KERNEL(cwr_value_float_type, float_n, <=, cwr_binary_operator_less_equals_than_type);
+    CWR_MACHINE_CASE(store):
+    {
+        value = registers[pc->b];
+        cwr_tagged_value *slot = &registers[pc->a];
+
+        cwr_tagged_value_add_reference(&value);
+        cwr_tagged_value_remove_reference(slab, slot);
+
+        *slot = value;
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(store_dereference):
+    {
+        value = registers[pc->a];
+        if (!cwr_tagged_value_is_reference(&value) || cwr_tagged_value_is_reference(&registers[pc->b]))
+        {
+            goto instruction_incorrect_type;
+        }
+
+        cwr_tagged_value_store(value.value, registers[pc->b]);
+        pc++;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(release):
+        cwr_tagged_value_release(slab, &registers[pc->a]);
+
+        pc++;
+        CWR_MACHINE_NEXT();
+    CWR_MACHINE_CASE(call):
+    CWR_MACHINE_CASE(tail_call):
+    {
+        const cwr_bytecode_call *call = &function->calls[pc->index];
+        const cwr_bytecode_function *callee = NULL;
+        if (call->function < machine->functions_capacity)
+        {
+            callee = machine->functions[call->function];
+        }
+
+        if (callee == NULL)
+        {
+            cwr_instance *instance = cwr_scope_at(machine->context.functions, call->function);
+            if (instance->function.type == cwr_function_instance_bind_type)
+            {
+                cwr_machine_call_bind(machine, instance, call, &registers[pc->a]);
+                pc++;
+                CWR_MACHINE_NEXT();
+            }
+
+            callee = cwr_machine_function(machine, instance, call->location, error);
+            if (callee == NULL)
+            {
+                goto failure;
+            }
+        }
+
+        if (pc->type == cwr_instruction_tail_call_type)
+        {
+            const cwr_instruction *caller = cwr_machine_leave_for_tail_call(machine, &registers[pc->a], call->count);
+            if (!cwr_machine_enter(machine, callee, caller, base, call->count, call->location, error))
+            {
+                goto failure;
+            }
+        }
+        else
+        {
+            if (!cwr_machine_enter(machine, callee, pc, base + pc->a, call->count, call->location, error))
+            {
+                goto failure;
+            }
+
+            base += pc->a;
+        }
+
+        function = callee;
+        registers = &machine->registers[base];
+        pc = function->instructions;
+        CWR_MACHINE_NEXT();
+    }
+    CWR_MACHINE_CASE(return):
+        value = registers[pc->a];
+        goto instruction_leave;
+    CWR_MACHINE_CASE(return_none):
+        value = (cwr_tagged_value){
+            .type = cwr_value_void_type};
+        goto instruction_leave;
+    CWR_MACHINE_CASE(fail):
+        goto instruction_unknown;
+    }
+
+instruction_leave:
+{
+    const cwr_instruction *call = machine->frames[machine->frames_capacity - 1].call;
+    cwr_machine_leave(machine, &value);
+    if (machine->frames_capacity == frames)
+    {
+        *result = value;
+        return true;
+    }
+
+    frame = &machine->frames[machine->frames_capacity - 1];
+    function = frame->function;
+    base = frame->base;
+    registers = &machine->registers[base];
+    registers[call->a] = value;
+    pc = call + 1;
+    CWR_MACHINE_NEXT();
+}
+
+instruction_incorrect_type:
+    cwr_interpreter_error_throw(error, cwr_interpreter_error_incorrect_type_type, "Incorrect type", CWR_MACHINE_LOCATION());
+    goto failure;
+
+instruction_unknown:
+    cwr_interpreter_error_throw(error, cwr_interpreter_error_unknown_expression_type, "Unknown expression", CWR_MACHINE_LOCATION());
+
+failure:
+    while (machine->frames_capacity > frames)
+    {
+        value = (cwr_tagged_value){
+            .type = cwr_value_void_type};
+        cwr_machine_leave(machine, &value);
+    }
+
+    return false;
+}
+
+cwr_machine *cwr_machine_create(cwr_program_context context, size_t max_depth)
+{
+    cwr_machine *machine = calloc(1, sizeof(cwr_machine));
+    if (machine == NULL)
+    {
+        return NULL;
+    }
+
+    machine->context = context;
+    machine->max_depth = max_depth;
+    machine->walker = cwr_walker_create();
+    if (machine->walker == NULL)
+    {
+        free(machine);
+        return NULL;
+    }
+
+    return machine;
+}
+
+cwr_value *cwr_machine_run(cwr_machine *machine, cwr_instance *function, cwr_interpreter_error *error)
+{
+    const cwr_bytecode_function *bytecode = cwr_machine_function(machine, function, (cwr_location){0}, error);
+    if (bytecode == NULL)
+    {
+        return NULL;
+    }
+
+    size_t frames = machine->frames_capacity;
+    size_t base = 0;
+    if (frames > 0)
+    {
+        cwr_machine_frame frame = machine->frames[frames - 1];
+        base = frame.base + frame.function->registers;
+    }
+
+    if (!cwr_machine_enter(machine, bytecode, NULL, base, 0, (cwr_location){0}, error))
+    {
+        return NULL;
+    }
+
+    cwr_tagged_value result;
+    if (!cwr_machine_execute(machine, frames, &result, error) || result.type == cwr_value_void_type)
+    {
+        return NULL;
+    }
+
+    cwr_value *value = cwr_tagged_value_box(machine->context.slab, result);
+    if (value == NULL)
+    {
+        cwr_interpreter_error_throw_out_of_memory(error, (cwr_location){0});
+    }
+
+    return value;
+}
+
+void cwr_machine_destroy(cwr_machine *machine)
+{
+    if (machine == NULL)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < machine->functions_capacity; i++)
+    {
+        cwr_bytecode_function_destroy(machine->functions[i]);
+    }
+
+    free(machine->functions);
+    free(machine->registers);
+    free(machine->frames);
+    cwr_walker_destroy(machine->walker);
+    free(machine);
+}
\ No newline at end of file
@@ -0,0 +1,767 @@
+#include <cwr_optimizer.h>
+#include <cwr_walker.h>
+#include <cwr_arena.h>
+#include <stdint.h>
+
+#define CWR_OPTIMIZER_ENTRY_POINT_FUNC "main"
+
+typedef struct cwr_optimizer_context
+{
+    cwr_walker *walker;
+    cwr_expression_pool *pool;
+    cwr_arena *arena;
+    // Reachability of functions by identifier
+    bool *is_reachable;
+    size_t *pending;
+    size_t pending_count;
+    // Declarations by function identifier, NULL for not yet known or not inlinable ones
+    cwr_func_decl_statement **inlinable;
+    bool *is_checked;
+    size_t functions_count;
+    size_t depth;
+    // State of the expression currently measured, checked or cloned
+    int identifier;
+    size_t size;
+    bool is_accepted;
+    cwr_func_decl_statement *callee;
+    uint32_t arguments;
+    cwr_expression_index sources[CWR_OPTIMIZER_INLINE_SIZE];
+    cwr_expression_index clones[CWR_OPTIMIZER_INLINE_SIZE];
+    size_t clones_count;
+} cwr_optimizer_context;
+
+static bool cwr_optimizer_is_number(cwr_expression *expression)
+{
+    return expression->type == cwr_expression_integer_type || expression->type == cwr_expression_float_type;
+}
+
+static float cwr_optimizer_as_float(cwr_expression *expression)
+{
+    return expression->type == cwr_expression_integer_type ? expression->integer_n.value : expression->float_n.value;
+}
+
+static bool cwr_optimizer_fold_expression(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    (void)context;
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+
+    // Children are already folded, the node is replaced in place so parents, types and locations stay valid.
+    // Literals are folded with the kernel the interpreter would use for them
+    if (expression->type == cwr_expression_binary_type)
+    {
+        cwr_expression *left = cwr_expression_pool_get(pool, expression->binary.children[0]);
+        cwr_expression *right = cwr_expression_pool_get(pool, expression->binary.children[1]);
+        if (!cwr_optimizer_is_number(left) || !cwr_optimizer_is_number(right))
+        {
+            return true;
+        }
+
+        if (left->type == cwr_expression_integer_type && right->type == cwr_expression_integer_type)
+        {
+            int result;
+            if (!cwr_binary_operator_apply_integer(expression->binary.type, left->integer_n.value, right->integer_n.value, &result))
+            {
+                // Left for the interpreter to report
+                return true;
+            }
+
+            *expression = (cwr_expression){
+                .type = cwr_expression_integer_type,
+                .integer_n = (cwr_integer_expression){
+                    .value = result}};
+            return true;
+        }
+
+        float result;
+        if (!cwr_binary_operator_apply_float(expression->binary.type, cwr_optimizer_as_float(left), cwr_optimizer_as_float(right), &result))
+        {
+            return true;
+        }
+
+        if (cwr_binary_operator_is_comparison(expression->binary.type))
+        {
+            *expression = (cwr_expression){
+                .type = cwr_expression_integer_type,
+                .integer_n = (cwr_integer_expression){
+                    .value = (int)result}};
+            return true;
+        }
+
+        *expression = (cwr_expression){
+            .type = cwr_expression_float_type,
+            .float_n = (cwr_float_expression){
+                .value = result}};
+        return true;
+    }
+
+    if (expression->type != cwr_expression_unary_type)
+    {
+        return true;
+    }
+
+    cwr_expression child = *cwr_expression_pool_get(pool, expression->unary.child);
+    if (!cwr_optimizer_is_number(&child))
+    {
+        return true;
+    }
+
+    switch (expression->unary.type)
+    {
+    case cwr_binary_operator_minus_type:
+    case cwr_binary_operator_negation_type:
+        if (child.type == cwr_expression_float_type)
+        {
+            child.float_n.value = cwr_unary_operator_apply_float(expression->unary.type, child.float_n.value);
+        }
+        else
+        {
+            child.integer_n.value = cwr_unary_operator_apply_integer(expression->unary.type, child.integer_n.value);
+        }
+
+        break;
+    default:
+        return true;
+    }
+
+    *expression = child;
+    return true;
+}
+
+static bool cwr_optimizer_fold_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    (void)body;
+    cwr_optimizer_context *optimizer = context;
+    return cwr_walker_walk_statement_expressions(optimizer->walker, optimizer->pool, statement, cwr_optimizer_fold_expression, optimizer);
+}
+
+static bool cwr_optimizer_is_leaf(cwr_expression *expression)
+{
+    switch (expression->type)
+    {
+    case cwr_expression_var_type:
+    case cwr_expression_integer_type:
+    case cwr_expression_float_type:
+    case cwr_expression_character_type:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool cwr_optimizer_measure_expression(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_optimizer_context *optimizer = context;
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+
+    // Self calls would inline forever
+    if (++optimizer->size > CWR_OPTIMIZER_INLINE_SIZE ||
+        (expression->type == cwr_expression_func_call_type && expression->func_call.identifier == optimizer->identifier))
+    {
+        optimizer->is_accepted = false;
+        return false;
+    }
+
+    if (expression->type != cwr_expression_var_type)
+    {
+        return true;
+    }
+
+    // A function has no other variables, checked so cloning never meets one it can not map
+    cwr_func_decl_statement *function = optimizer->inlinable[optimizer->identifier];
+    for (size_t i = 0; i < function->count; i++)
+    {
+        if (function->arguments[i].identifier == expression->var.identifier)
+        {
+            return true;
+        }
+    }
+
+    optimizer->is_accepted = false;
+    return false;
+}
+
+static cwr_func_decl_statement *cwr_optimizer_get_inlinable(cwr_optimizer_context *context, int identifier)
+{
+    if (context->is_checked[identifier])
+    {
+        return context->inlinable[identifier];
+    }
+
+    context->is_checked[identifier] = true;
+
+    cwr_func_decl_statement *function = context->inlinable[identifier];
+    if (function == NULL || !function->with_body || function->func_body.count != 1)
+    {
+        context->inlinable[identifier] = NULL;
+        return NULL;
+    }
+
+    cwr_statement statement = function->func_body.statements[0];
+    if (statement.type != cwr_statement_return_type || statement.ret.with_body)
+    {
+        context->inlinable[identifier] = NULL;
+        return NULL;
+    }
+
+    context->identifier = identifier;
+    context->size = 0;
+    context->is_accepted = true;
+    if (!cwr_walker_walk_expression(context->walker, context->pool, statement.ret.value, cwr_optimizer_measure_expression, context) && context->is_accepted)
+    {
+        // Out of memory, just not inlined
+        context->is_accepted = false;
+    }
+
+    if (!context->is_accepted)
+    {
+        context->inlinable[identifier] = NULL;
+    }
+
+    return context->inlinable[identifier];
+}
+
+// Arguments are evaluated in the caller before the call, after inlining only where the parameter is used.
+// That is the same only for expressions that can not fail and have no side effects
+static bool cwr_optimizer_check_argument(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_optimizer_context *optimizer = context;
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+
+    switch (expression->type)
+    {
+    case cwr_expression_var_type:
+    case cwr_expression_integer_type:
+    case cwr_expression_float_type:
+    case cwr_expression_character_type:
+    case cwr_expression_string_type:
+        return true;
+    case cwr_expression_unary_type:
+        if (expression->unary.type == cwr_binary_operator_minus_type || expression->unary.type == cwr_binary_operator_negation_type)
+        {
+            return true;
+        }
+
+        break;
+    case cwr_expression_binary_type:
+        if (expression->binary.type != cwr_binary_operator_division_type)
+        {
+            return true;
+        }
+
+        break;
+    default:
+        break;
+    }
+
+    optimizer->is_accepted = false;
+    return false;
+}
+
+static bool cwr_optimizer_count_uses(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_optimizer_context *optimizer = context;
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+
+    if (expression->type == cwr_expression_var_type && expression->var.identifier == optimizer->identifier)
+    {
+        optimizer->size++;
+    }
+
+    return true;
+}
+
+static cwr_expression_index cwr_optimizer_get_clone(cwr_optimizer_context *context, cwr_expression_index source)
+{
+    for (size_t i = 0; i < context->clones_count; i++)
+    {
+        if (context->sources[i] == source)
+        {
+            return context->clones[i];
+        }
+    }
+
+    return CWR_EXPRESSION_INDEX_NONE;
+}
+
+static bool cwr_optimizer_is_cloned(cwr_optimizer_context *context, cwr_expression_index clone)
+{
+    for (size_t i = 0; i < context->clones_count; i++)
+    {
+        if (context->clones[i] == clone)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static cwr_expression_index cwr_optimizer_add_copy(cwr_expression_pool *pool, cwr_expression expression, cwr_expression_index source)
+{
+    cwr_expression_index index = cwr_expression_pool_add(pool, expression, cwr_expression_pool_type(pool, source), cwr_expression_pool_location(pool, source));
+    if (index == CWR_EXPRESSION_INDEX_NONE)
+    {
+        return index;
+    }
+
+    // New nodes have the largest index, so names stay sorted
+    char *name = cwr_expression_pool_name(pool, source);
+    if (name != NULL && !cwr_expression_pool_add_name(pool, index, name))
+    {
+        return CWR_EXPRESSION_INDEX_NONE;
+    }
+
+    return index;
+}
+
+// Post-order, so children of a node are cloned before it. Parameters become the argument, repeated ones a copy of it
+static bool cwr_optimizer_clone_expression(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_optimizer_context *optimizer = context;
+    cwr_expression expression = *cwr_expression_pool_get(pool, index);
+    cwr_expression_index clone = CWR_EXPRESSION_INDEX_NONE;
+
+    switch (expression.type)
+    {
+    case cwr_expression_var_type:
+        for (size_t i = 0; i < optimizer->callee->count; i++)
+        {
+            if (optimizer->callee->arguments[i].identifier != expression.var.identifier)
+            {
+                continue;
+            }
+
+            cwr_expression_index argument = cwr_expression_pool_argument(pool, optimizer->arguments, i);
+            clone = cwr_optimizer_is_cloned(optimizer, argument) ? cwr_optimizer_add_copy(pool, *cwr_expression_pool_get(pool, argument), argument) : argument;
+            break;
+        }
+
+        break;
+    case cwr_expression_binary_type:
+        expression.binary.children[0] = cwr_optimizer_get_clone(optimizer, expression.binary.children[0]);
+        expression.binary.children[1] = cwr_optimizer_get_clone(optimizer, expression.binary.children[1]);
+        clone = cwr_optimizer_add_copy(pool, expression, index);
+        break;
+    case cwr_expression_array_element_type:
+        expression.array_element.children[0] = cwr_optimizer_get_clone(optimizer, expression.array_element.children[0]);
+        expression.array_element.children[1] = cwr_optimizer_get_clone(optimizer, expression.array_element.children[1]);
+        clone = cwr_optimizer_add_copy(pool, expression, index);
+        break;
+    case cwr_expression_unary_type:
+        expression.unary.child = cwr_optimizer_get_clone(optimizer, expression.unary.child);
+        clone = cwr_optimizer_add_copy(pool, expression, index);
+        break;
+    case cwr_expression_func_call_type:
+    {
+        cwr_expression_index arguments[CWR_OPTIMIZER_INLINE_SIZE];
+        for (size_t i = 0; i < expression.func_call.count; i++)
+        {
+            arguments[i] = cwr_optimizer_get_clone(optimizer, cwr_expression_pool_argument(pool, expression.func_call.arguments, i));
+        }
+
+        expression.func_call.arguments = cwr_expression_pool_add_indices(pool, arguments, expression.func_call.count);
+        if (expression.func_call.arguments != CWR_EXPRESSION_INDEX_NONE)
+        {
+            clone = cwr_optimizer_add_copy(pool, expression, index);
+        }
+
+        break;
+    }
+    default:
+        clone = cwr_optimizer_add_copy(pool, expression, index);
+        break;
+    }
+
+    if (clone == CWR_EXPRESSION_INDEX_NONE)
+    {
+        return false;
+    }
+
+    optimizer->sources[optimizer->clones_count] = index;
+    optimizer->clones[optimizer->clones_count++] = clone;
+    return true;
+}
+
+static bool cwr_optimizer_inline_expression(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_optimizer_context *optimizer = context;
+    cwr_expression call = *cwr_expression_pool_get(pool, index);
+
+    if (call.type != cwr_expression_func_call_type)
+    {
+        return true;
+    }
+
+    cwr_func_decl_statement *callee = cwr_optimizer_get_inlinable(optimizer, call.func_call.identifier);
+    if (callee == NULL)
+    {
+        return true;
+    }
+
+    cwr_expression_index body = callee->func_body.statements[0].ret.value;
+    for (size_t i = 0; i < call.func_call.count; i++)
+    {
+        cwr_expression_index argument = cwr_expression_pool_argument(pool, call.func_call.arguments, i);
+
+        optimizer->is_accepted = true;
+        if (!cwr_walker_walk_expression(optimizer->walker, pool, argument, cwr_optimizer_check_argument, optimizer) && optimizer->is_accepted)
+        {
+            return false;
+        }
+
+        if (!optimizer->is_accepted)
+        {
+            return true;
+        }
+
+        // Repeating anything but a leaf repeats work
+        optimizer->identifier = callee->arguments[i].identifier;
+        optimizer->size = 0;
+        if (!cwr_walker_walk_expression(optimizer->walker, pool, body, cwr_optimizer_count_uses, optimizer))
+        {
+            return false;
+        }
+
+        if (optimizer->size > 1 && !cwr_optimizer_is_leaf(cwr_expression_pool_get(pool, argument)))
+        {
+            return true;
+        }
+    }
+
+    optimizer->callee = callee;
+    optimizer->arguments = call.func_call.arguments;
+    optimizer->clones_count = 0;
+    if (!cwr_walker_walk_expression(optimizer->walker, pool, body, cwr_optimizer_clone_expression, optimizer))
+    {
+        return false;
+    }
+
+    // Root replaces the call in place, so the parent, type and location of the call stay
+    *cwr_expression_pool_get(pool, index) = *cwr_expression_pool_get(pool, cwr_optimizer_get_clone(optimizer, body));
+
+    if (optimizer->depth >= CWR_OPTIMIZER_INLINE_DEPTH)
+    {
+        return true;
+    }
+
+    optimizer->depth++;
+    bool is_successful = cwr_walker_walk_expression(optimizer->walker, pool, index, cwr_optimizer_inline_expression, optimizer);
+    optimizer->depth--;
+    return is_successful;
+}
+
+static bool cwr_optimizer_inline_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    (void)body;
+    cwr_optimizer_context *optimizer = context;
+    return cwr_walker_walk_statement_expressions(optimizer->walker, optimizer->pool, statement, cwr_optimizer_inline_expression, optimizer);
+}
+
+// Truth of a number literal the way the interpreter tests conditions
+static bool cwr_optimizer_get_condition(cwr_expression_pool *pool, cwr_expression_index index, bool *value)
+{
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+    if (!cwr_optimizer_is_number(expression))
+    {
+        return false;
+    }
+
+    *value = expression->type == cwr_expression_integer_type ? expression->integer_n.value != 0 : (int)expression->float_n.value != 0;
+    return true;
+}
+
+// Copies statements of 'body' that can run to 'target', or only counts them when 'target' is NULL. Stops after 'return'.
+// The interpreter runs a true 'if' body in the enclosing root, so its statements move to the enclosing body
+static size_t cwr_optimizer_prune_statements(cwr_optimizer_context *context, cwr_func_body_expression body, cwr_statement *target, bool *is_returned)
+{
+    size_t count = 0;
+    *is_returned = false;
+
+    for (size_t i = 0; i < body.count && !*is_returned; i++)
+    {
+        cwr_statement statement = body.statements[i];
+        bool condition;
+
+        if (statement.type == cwr_statement_if_type && cwr_optimizer_get_condition(context->pool, statement.if_stat.condition, &condition))
+        {
+            if (!condition)
+            {
+                continue;
+            }
+
+            // Already pruned, so a 'return' can only be the last statement
+            size_t inlined = cwr_optimizer_prune_statements(context, statement.if_stat.body, target == NULL ? NULL : target + count, is_returned);
+            count += inlined;
+            continue;
+        }
+
+        if (target != NULL)
+        {
+            target[count] = statement;
+        }
+
+        count++;
+        *is_returned = statement.type == cwr_statement_return_type;
+    }
+
+    return count;
+}
+
+static bool cwr_optimizer_prune_body(cwr_optimizer_context *context, cwr_func_body_expression *body)
+{
+    bool is_returned;
+    size_t count = cwr_optimizer_prune_statements(context, *body, NULL, &is_returned);
+
+    // Same count can still mean a true 'if' with one statement was inlined
+    bool is_changed = count != body->count;
+    for (size_t i = 0; !is_changed && i < body->count; i++)
+    {
+        bool condition;
+        is_changed = body->statements[i].type == cwr_statement_if_type && cwr_optimizer_get_condition(context->pool, body->statements[i].if_stat.condition, &condition);
+    }
+
+    if (!is_changed)
+    {
+        return true;
+    }
+
+    cwr_statement *statements = NULL;
+    if (count > 0)
+    {
+        statements = cwr_arena_allocate(context->arena, count * sizeof(cwr_statement));
+        if (statements == NULL)
+        {
+            return false;
+        }
+
+        cwr_optimizer_prune_statements(context, *body, statements, &is_returned);
+    }
+
+    body->statements = statements;
+    body->count = count;
+    return true;
+}
+
+// Nested bodies are visited first, so bodies inlined from 'if' statements are already pruned
+static bool cwr_optimizer_prune_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    (void)body;
+    switch (statement->type)
+    {
+    case cwr_statement_func_decl_type:
+        return !statement->func_decl.with_body || cwr_optimizer_prune_body(context, &statement->func_decl.func_body);
+    case cwr_statement_if_type:
+        return cwr_optimizer_prune_body(context, &statement->if_stat.body);
+    case cwr_statement_for_loop_type:
+        return !statement->for_loop.with_body || cwr_optimizer_prune_body(context, &statement->for_loop.body);
+    case cwr_statement_return_type:
+        return !statement->ret.with_body || cwr_optimizer_prune_body(context, &statement->ret.body);
+    default:
+        return true;
+    }
+}
+
+static void cwr_optimizer_reach(cwr_optimizer_context *context, int identifier)
+{
+    if (context->is_reachable[identifier])
+    {
+        return;
+    }
+
+    context->is_reachable[identifier] = true;
+    context->pending[context->pending_count++] = identifier;
+}
+
+static bool cwr_optimizer_reach_expression(cwr_expression_pool *pool, cwr_expression_index index, void *context)
+{
+    cwr_expression *expression = cwr_expression_pool_get(pool, index);
+    if (expression->type == cwr_expression_func_call_type)
+    {
+        cwr_optimizer_reach(context, expression->func_call.identifier);
+    }
+
+    return true;
+}
+
+static bool cwr_optimizer_reach_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    (void)body;
+    cwr_optimizer_context *optimizer = context;
+    if (statement->type == cwr_statement_func_call_type)
+    {
+        cwr_optimizer_reach(optimizer, statement->func_call.identifier);
+    }
+
+    return cwr_walker_walk_statement_expressions(optimizer->walker, optimizer->pool, statement, cwr_optimizer_reach_expression, optimizer);
+}
+
+static bool cwr_optimizer_remove_unreachable(cwr_optimizer_context *context, cwr_parser_result *result)
+{
+    cwr_nodes_list *nodes_list = &result->nodes_list;
+    size_t *declarations = malloc(result->functions_count * sizeof(size_t));
+    context->is_reachable = calloc(result->functions_count, sizeof(bool));
+    context->pending = malloc(result->functions_count * sizeof(size_t));
+    context->pending_count = 0;
+
+    bool is_successful = declarations != NULL && context->is_reachable != NULL && context->pending != NULL;
+    bool with_entry_point = false;
+    bool with_lazy_body = false;
+
+    for (size_t i = 0; is_successful && i < result->functions_count; i++)
+    {
+        declarations[i] = SIZE_MAX;
+    }
+
+    for (size_t i = 0; is_successful && i < nodes_list->count; i++)
+    {
+        cwr_statement statement = nodes_list->statements[i];
+        if (statement.type != cwr_statement_func_decl_type)
+        {
+            continue;
+        }
+
+        declarations[statement.func_decl.identifier] = i;
+        if (strcmp(statement.func_decl.name, CWR_OPTIMIZER_ENTRY_POINT_FUNC) == 0)
+        {
+            cwr_optimizer_reach(context, statement.func_decl.identifier);
+            with_entry_point = true;
+        }
+    }
+
+    while (is_successful && context->pending_count > 0)
+    {
+        size_t declaration = declarations[context->pending[--context->pending_count]];
+        if (declaration == SIZE_MAX || !nodes_list->statements[declaration].func_decl.with_body)
+        {
+            continue;
+        }
+
+        cwr_statement *statement = &nodes_list->statements[declaration];
+        if (statement->func_decl.is_lazy)
+        {
+            // Calls of a body not parsed yet are unknown
+            with_lazy_body = true;
+            break;
+        }
+
+        cwr_func_body_expression *body = &statement->func_decl.func_body;
+        is_successful = cwr_walker_walk_statements(context->walker, body->statements, body->count, body, cwr_optimizer_reach_statement, context);
+    }
+
+    // Without an entry point every function is kept, the interpreter reports it
+    if (is_successful && with_entry_point && !with_lazy_body)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < nodes_list->count; i++)
+        {
+            cwr_statement statement = nodes_list->statements[i];
+            if (statement.type == cwr_statement_func_decl_type && !context->is_reachable[statement.func_decl.identifier])
+            {
+                continue;
+            }
+
+            // Top level list is rewritten in place, the removed statements stay in the arena
+            nodes_list->statements[count++] = statement;
+        }
+
+        nodes_list->count = count;
+    }
+
+    free(declarations);
+    free(context->is_reachable);
+    free(context->pending);
+    context->is_reachable = NULL;
+    context->pending = NULL;
+    return is_successful;
+}
+
+bool cwr_optimizer_optimize(cwr_parser_result *result, cwr_optimizer_configuration *configuration)
+{
+    if (result->is_failed)
+    {
+        return true;
+    }
+
+    if (configuration->is_inlining && !cwr_optimizer_inline_functions(result))
+    {
+        return false;
+    }
+
+    if (configuration->is_folding_constants && !cwr_optimizer_fold_constants(result))
+    {
+        return false;
+    }
+
+    if (configuration->is_eliminating_dead_code && !cwr_optimizer_eliminate_dead_code(result))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool cwr_optimizer_inline_functions(cwr_parser_result *result)
+{
+    cwr_optimizer_context context = (cwr_optimizer_context){
+        .walker = cwr_walker_create(),
+        .pool = result->nodes_list.pool,
+        .arena = result->arena,
+        .inlinable = calloc(result->functions_count, sizeof(cwr_func_decl_statement *)),
+        .is_checked = calloc(result->functions_count, sizeof(bool)),
+        .functions_count = result->functions_count,
+        .depth = 0};
+
+    bool is_successful = context.walker != NULL && (result->functions_count == 0 || (context.inlinable != NULL && context.is_checked != NULL));
+    for (size_t i = 0; is_successful && i < result->nodes_list.count; i++)
+    {
+        cwr_statement *statement = &result->nodes_list.statements[i];
+        if (statement->type == cwr_statement_func_decl_type)
+        {
+            context.inlinable[statement->func_decl.identifier] = &statement->func_decl;
+        }
+    }
+
+    if (is_successful)
+    {
+        is_successful = cwr_walker_walk_statements(context.walker, result->nodes_list.statements, result->nodes_list.count, NULL, cwr_optimizer_inline_statement, &context);
+    }
+
+    free(context.inlinable);
+    free(context.is_checked);
+    cwr_walker_destroy(context.walker);
+    return is_successful;
+}
+
+bool cwr_optimizer_fold_constants(cwr_parser_result *result)
+{
+    cwr_optimizer_context context = (cwr_optimizer_context){
+        .walker = cwr_walker_create(),
+        .pool = result->nodes_list.pool};
+
+    if (context.walker == NULL)
+    {
+        return false;
+    }
+
+    bool is_successful = cwr_walker_walk_statements(context.walker, result->nodes_list.statements, result->nodes_list.count, NULL, cwr_optimizer_fold_statement, &context);
+    cwr_walker_destroy(context.walker);
+    return is_successful;
+}
+
+bool cwr_optimizer_eliminate_dead_code(cwr_parser_result *result)
+{
+    cwr_optimizer_context context = (cwr_optimizer_context){
+        .walker = cwr_walker_create(),
+        .pool = result->nodes_list.pool,
+        .arena = result->arena};
+
+    if (context.walker == NULL)
+    {
+        return false;
+    }
+
+    bool is_successful = cwr_walker_walk_statements(context.walker, result->nodes_list.statements, result->nodes_list.count, NULL, cwr_optimizer_prune_statement, &context) &&
+                         cwr_optimizer_remove_unreachable(&context, result);
+    cwr_walker_destroy(context.walker);
+    return is_successful;
+}
\ No newline at end of file
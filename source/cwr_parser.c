@@ -1,45 +1,1066 @@
 #include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include <cwr_parser.h>
 #include <cwr_lexer.h>
 #include <cwr_string.h>
+#include <cwr_hash.h>
+#include <cwr_arena.h>
+#include <cwr_walker.h>
+
+typedef struct cwr_parser_function_cache_entry cwr_parser_function_cache_entry;
+
+// Resolved overload, key is "name\0" followed by interned argument type pointers
+typedef struct cwr_parser_function_cache_entry
+{
+    cwr_parser_function_cache_entry *next;
+    size_t name_hash;
+    size_t hash;
+    size_t function;
+    size_t length;
+    char key[];
+} cwr_parser_function_cache_entry;
+
+#define CWR_PARSER_PRECEDENCE_BINARY 1
+#define CWR_PARSER_PRECEDENCE_UNARY 2
+
+typedef enum cwr_parser_operator_kind
+{
+    cwr_parser_operator_binary_kind,
+    cwr_parser_operator_unary_kind,
+    cwr_parser_operator_parenthesis_kind,
+    cwr_parser_operator_index_kind
+} cwr_parser_operator_kind;
+
+// Pending entry of the expression parser, parenthesis and index ones only mark where they were opened
+typedef struct cwr_parser_operator
+{
+    cwr_parser_operator_kind kind;
+    cwr_binary_operator_type type;
+    cwr_location location;
+    bool is_elided;
+} cwr_parser_operator;
+
+typedef struct cwr_parser_precedence
+{
+    int binding;
+    bool is_right_associative;
+} cwr_parser_precedence;
+
+// All binary operators bind equally and group to the right, so '2 * 3 + 4' is '2 * (3 + 4)'
+static const cwr_parser_precedence cwr_parser_precedences[] = {
+    [cwr_binary_operator_none_type] = {0, false},
+    [cwr_binary_operator_plus_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_minus_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_multiplicative_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_division_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_negation_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_not_equals_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_equals_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_reference_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_dereference_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_greater_than_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_less_than_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_greater_equals_than_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+    [cwr_binary_operator_less_equals_than_type] = {CWR_PARSER_PRECEDENCE_BINARY, true},
+};
+
+// Function body skipped while reading declarations
+typedef struct cwr_parser_body
+{
+    // Position of the declaration in parser statements
+    size_t statement;
+    // Tokens from '{' to after the matching '}'
+    size_t start;
+    size_t end;
+    // Functions declared up to this one, later ones are not visible to the body
+    size_t functions;
+    cwr_argument *arguments;
+    size_t count;
+    cwr_func_body_expression body;
+    size_t frame_size;
+    bool is_parsed;
+} cwr_parser_body;
+
+typedef struct cwr_parser_lazy
+{
+    cwr_arena *arena;
+    cwr_expression_pool *pool;
+    cwr_token *tokens;
+    size_t count;
+    cwr_parser_function *functions;
+    cwr_parser_body *bodies;
+    // Position in 'bodies' by function identifier, SIZE_MAX for bodies parsed with the declaration
+    size_t *positions;
+} cwr_parser_lazy;
 
 typedef struct cwr_parser
 {
-    cwr_func_body_expression *root;
-    cwr_token *tokens;
-    size_t count;
-    cwr_statement *statements;
-    size_t capacity;
-    cwr_parser_function *functions;
-    size_t functions_capacity;
-    cwr_parser_variable *variables;
-    size_t variables_capacity;
-    size_t position;
-    cwr_parser_error error;
-    bool is_failed;
-} cwr_parser;
+    cwr_arena *arena;
+    cwr_expression_pool *pool;
+    cwr_func_body_expression *root;
+    cwr_token *tokens;
+    size_t count;
+    cwr_statement *statements;
+    size_t capacity;
+    size_t statements_size;
+    cwr_parser_function *functions;
+    size_t functions_capacity;
+    size_t functions_size;
+    cwr_parser_variable *variables;
+    size_t variables_capacity;
+    size_t variables_size;
+    // Variables of the function being parsed start at 'frame', their slot is the offset from it
+    size_t frame;
+    size_t frame_size;
+    // Set in return bodies and loop steps, a return there only leaves them, so a call it returns is not a tail call
+    bool is_return_local;
+    // Scratch stack of call arguments being parsed
+    cwr_expression_index *arguments;
+    size_t arguments_capacity;
+    size_t arguments_size;
+    // Scratch stacks of the expression parser, shared by nested expressions
+    cwr_expression_index *operands;
+    size_t operands_capacity;
+    size_t operands_size;
+    cwr_parser_operator *operators;
+    size_t operators_capacity;
+    size_t operators_size;
+    cwr_parser_function_cache_entry **function_cache;
+    size_t function_cache_size;
+    size_t function_cache_count;
+    cwr_parser_body *bodies;
+    size_t bodies_capacity;
+    size_t bodies_size;
+    size_t threads;
+    bool is_lazy;
+    size_t position;
+    cwr_parser_error error;
+    bool is_failed;
+} cwr_parser;
+
+// Parses a run of skipped bodies into its own arena and pool, tokens and functions are only read
+typedef struct cwr_parser_worker
+{
+    cwr_parser parser;
+    cwr_parser_body *bodies;
+    size_t count;
+    pthread_t thread;
+    bool is_started;
+} cwr_parser_worker;
+
+static void *cwr_parser_allocate(cwr_parser *parser, size_t size, cwr_location location)
+{
+    void *result = cwr_arena_allocate(parser->arena, size);
+    if (result == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+
+    return result;
+}
+
+static char *cwr_parser_duplicate(cwr_parser *parser, char *source, cwr_location location)
+{
+    char *result = cwr_arena_duplicate(parser->arena, source);
+    if (result == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+
+    return result;
+}
+
+// Lists are grown on the heap while parsed and moved into the arena once complete
+static void *cwr_parser_move_to_arena(cwr_parser *parser, void *source, size_t size, cwr_location location)
+{
+    if (size == 0)
+    {
+        free(source);
+        return NULL;
+    }
+
+    void *result = cwr_arena_copy(parser->arena, source, size);
+    free(source);
+
+    if (result == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+
+    return result;
+}
+
+static cwr_expression_index cwr_parser_add_expression(cwr_parser *parser, cwr_expression expression, const cwr_expression_type_value *type, cwr_location location)
+{
+    cwr_expression_index index = cwr_expression_pool_add(parser->pool, expression, type, location);
+    if (index == CWR_EXPRESSION_INDEX_NONE)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+
+    return index;
+}
+
+static const cwr_expression_type_value *cwr_parser_intern_pointer(cwr_parser *parser, const cwr_expression_type_value *target, cwr_location location)
+{
+    const cwr_expression_type_value *result = cwr_type_pointer(target);
+    if (result == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+
+    return result;
+}
+
+static void cwr_parser_add_expression_name(cwr_parser *parser, cwr_expression_index expression, char *name, cwr_location location)
+{
+    char *copy = cwr_parser_duplicate(parser, name, location);
+    CWR_PARSER_FAILED_AND_RETURN_V(parser);
+
+    if (!cwr_expression_pool_add_name(parser->pool, expression, copy))
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+    }
+}
+
+static bool cwr_parser_push_operand(cwr_parser *parser, cwr_expression_index operand, cwr_location location)
+{
+    if (!CWR_VECTOR_RESERVE(parser->operands, parser->operands_size, parser->operands_capacity, 1))
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+        return false;
+    }
+
+    parser->operands[parser->operands_capacity++] = operand;
+    return true;
+}
+
+static bool cwr_parser_push_operator(cwr_parser *parser, cwr_parser_operator operator)
+{
+    if (!CWR_VECTOR_RESERVE(parser->operators, parser->operators_size, parser->operators_capacity, 1))
+    {
+        cwr_parser_throw_out_of_memory(parser, operator.location);
+        return false;
+    }
+
+    parser->operators[parser->operators_capacity++] = operator;
+    return true;
+}
+
+static int cwr_parser_operator_binding(cwr_parser_operator operator)
+{
+    return operator.kind == cwr_parser_operator_unary_kind ? CWR_PARSER_PRECEDENCE_UNARY : cwr_parser_precedences[operator.type].binding;
+}
+
+// Applies the top unary or binary operator to the operands on top of the stack
+static void cwr_parser_reduce(cwr_parser *parser)
+{
+    cwr_parser_operator operator = parser->operators[--parser->operators_capacity];
+
+    if (operator.kind == cwr_parser_operator_unary_kind)
+    {
+        cwr_expression_index value = parser->operands[parser->operands_capacity - 1];
+        if (operator.is_elided)
+        {
+            return;
+        }
+
+        cwr_binary_operator_type type = operator.type;
+        const cwr_expression_type_value *type_value = cwr_expression_pool_type(parser->pool, value);
+        cwr_binary_kernel_type kernel = cwr_binary_kernel_from_types(type_value->value_type, type_value->value_type);
+        if (type == cwr_binary_operator_multiplicative_type)
+        {
+            type = cwr_binary_operator_dereference_type;
+            type_value = type_value->target_type;
+        }
+        else if (type == cwr_binary_operator_dereference_type)
+        {
+            type_value = cwr_parser_intern_pointer(parser, type_value, operator.location);
+            CWR_PARSER_FAILED_AND_RETURN_V(parser);
+        }
+
+        parser->operands[parser->operands_capacity - 1] = cwr_parser_add_expression(parser,
+                                                                                     (cwr_expression){
+                                                                                         .type = cwr_expression_unary_type,
+                                                                                         .unary = (cwr_unary_expression){
+                                                                                             .type = type,
+                                                                                             .kernel = kernel,
+                                                                                             .child = value}},
+                                                                                     type_value, operator.location);
+        return;
+    }
+
+    cwr_expression_index right = parser->operands[--parser->operands_capacity];
+    cwr_expression_index left = parser->operands[parser->operands_capacity - 1];
+
+    cwr_value_type right_type = cwr_expression_pool_type(parser->pool, right)->value_type;
+    if (right_type != cwr_value_float_type && right_type != cwr_value_integer_type)
+    {
+        cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
+        return;
+    }
+
+    cwr_binary_kernel_type kernel = cwr_binary_kernel_from_types(cwr_expression_pool_type(parser->pool, left)->value_type, right_type);
+    // Comparisons give 0 or 1 whatever the kernel, other operators take the type of their left operand
+    const cwr_expression_type_value *type_value = cwr_binary_operator_is_comparison(operator.type) ? cwr_type_from(cwr_value_integer_type) : cwr_expression_pool_type(parser->pool, left);
+
+    parser->operands[parser->operands_capacity - 1] = cwr_parser_add_expression(parser,
+                                                                                 (cwr_expression){
+                                                                                     .type = cwr_expression_binary_type,
+                                                                                     .binary = (cwr_binary_expression){
+                                                                                         .type = operator.type,
+                                                                                         .kernel = kernel,
+                                                                                         .children = {left, right}}},
+                                                                                 type_value, operator.location);
+}
+
+// Reduces everything above the innermost open parenthesis or index
+static void cwr_parser_reduce_group(cwr_parser *parser, size_t base)
+{
+    while (!parser->is_failed && parser->operators_capacity > base)
+    {
+        cwr_parser_operator_kind kind = parser->operators[parser->operators_capacity - 1].kind;
+        if (kind == cwr_parser_operator_parenthesis_kind || kind == cwr_parser_operator_index_kind)
+        {
+            break;
+        }
+
+        cwr_parser_reduce(parser);
+    }
+}
+
+static bool cwr_parser_has_binary(cwr_parser *parser, size_t base)
+{
+    for (size_t i = base; i < parser->operators_capacity; i++)
+    {
+        if (parser->operators[i].kind == cwr_parser_operator_binary_kind)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Table driven precedence climbing over explicit stacks, so nesting depth is bound by memory and not by the C stack.
+// Unary only expressions (assignment targets) end at the first binary operator outside of parentheses and indices
+static cwr_expression_index cwr_parser_parse_expression(cwr_parser *parser, bool only_unary, bool only_value)
+{
+    size_t operands_base = parser->operands_capacity;
+    size_t operators_base = parser->operators_capacity;
+    size_t depth = 0;
+    bool is_operand = true;
+    bool is_indexed = false;
+    cwr_location operand_location = cwr_parser_current(parser).location;
+
+    while (!parser->is_failed)
+    {
+        cwr_token current = cwr_parser_current(parser);
+
+        if (is_operand)
+        {
+            cwr_binary_operator_type type = cwr_binary_operator_type_from_token(current.type);
+
+            if (type != cwr_binary_operator_none_type)
+            {
+                cwr_parser_skip(parser);
+                cwr_parser_push_operator(parser, (cwr_parser_operator){
+                                                     .kind = cwr_parser_operator_unary_kind,
+                                                     .type = type,
+                                                     .location = current.location,
+                                                     .is_elided = only_value && depth == 0 && type == cwr_binary_operator_multiplicative_type});
+                continue;
+            }
+
+            if (current.type == cwr_token_left_par_type)
+            {
+                cwr_parser_skip(parser);
+                cwr_parser_push_operator(parser, (cwr_parser_operator){
+                                                     .kind = cwr_parser_operator_parenthesis_kind,
+                                                     .type = cwr_binary_operator_none_type,
+                                                     .location = current.location});
+                depth++;
+                continue;
+            }
+
+            cwr_expression_index value = cwr_parser_parse_value(parser);
+            if (parser->is_failed)
+            {
+                break;
+            }
+
+            cwr_parser_push_operand(parser, value, current.location);
+            operand_location = current.location;
+            is_indexed = false;
+            is_operand = false;
+            continue;
+        }
+
+        if (current.type == cwr_token_left_square_type && !is_indexed)
+        {
+            cwr_parser_skip(parser);
+            cwr_parser_push_operator(parser, (cwr_parser_operator){
+                                                 .kind = cwr_parser_operator_index_kind,
+                                                 .type = cwr_binary_operator_none_type,
+                                                 .location = operand_location});
+            depth++;
+            is_operand = true;
+            continue;
+        }
+
+        if (depth > 0 && (current.type == cwr_token_right_par_type || current.type == cwr_token_right_square_type))
+        {
+            cwr_parser_reduce_group(parser, operators_base);
+            if (parser->is_failed)
+            {
+                break;
+            }
+
+            cwr_parser_operator group = parser->operators[parser->operators_capacity - 1];
+            cwr_parser_operator_kind kind = current.type == cwr_token_right_par_type ? cwr_parser_operator_parenthesis_kind : cwr_parser_operator_index_kind;
+            if (group.kind != kind)
+            {
+                break;
+            }
+
+            cwr_parser_skip(parser);
+            parser->operators_capacity--;
+            depth--;
+
+            if (kind == cwr_parser_operator_parenthesis_kind)
+            {
+                operand_location = group.location;
+                is_indexed = false;
+                continue;
+            }
+
+            cwr_expression_index index = parser->operands[--parser->operands_capacity];
+            cwr_expression_index value = parser->operands[parser->operands_capacity - 1];
+            parser->operands[parser->operands_capacity - 1] = cwr_parser_add_expression(parser,
+                                                                                         (cwr_expression){
+                                                                                             .type = cwr_expression_array_element_type,
+                                                                                             .array_element = (cwr_array_element_expression){
+                                                                                                 .children = {value, index}}},
+                                                                                         cwr_type_from(cwr_value_character_type), group.location);
+            operand_location = group.location;
+            is_indexed = true;
+            continue;
+        }
+
+        cwr_binary_operator_type type = cwr_binary_operator_type_from_token(current.type);
+        if (type == cwr_binary_operator_none_type || (only_unary && depth == 0))
+        {
+            break;
+        }
+
+        // Comparisons are two tokens, '=' alone is an assignment and ends the expression
+        bool with_equals = type != cwr_binary_operator_multiplicative_type && type != cwr_binary_operator_division_type && cwr_parser_peek(parser, 1, cwr_token_equals_type);
+        if (with_equals)
+        {
+            switch (type)
+            {
+            case cwr_binary_operator_negation_type:
+                type = cwr_binary_operator_not_equals_type;
+                break;
+            case cwr_binary_operator_greater_than_type:
+                type = cwr_binary_operator_greater_equals_than_type;
+                break;
+            case cwr_binary_operator_less_than_type:
+                type = cwr_binary_operator_less_equals_than_type;
+                break;
+            }
+
+            cwr_parser_skip(parser);
+        }
+        else if (type == cwr_binary_operator_equals_type)
+        {
+            break;
+        }
+
+        cwr_parser_skip(parser);
+
+        cwr_parser_precedence precedence = cwr_parser_precedences[type];
+        while (!parser->is_failed && parser->operators_capacity > operators_base)
+        {
+            cwr_parser_operator top = parser->operators[parser->operators_capacity - 1];
+            if (top.kind == cwr_parser_operator_parenthesis_kind || top.kind == cwr_parser_operator_index_kind)
+            {
+                break;
+            }
+
+            int binding = cwr_parser_operator_binding(top);
+            if (binding < precedence.binding || (binding == precedence.binding && precedence.is_right_associative))
+            {
+                break;
+            }
+
+            cwr_parser_reduce(parser);
+        }
+
+        cwr_parser_push_operator(parser, (cwr_parser_operator){
+                                             .kind = cwr_parser_operator_binary_kind,
+                                             .type = type,
+                                             .location = current.location});
+        is_operand = true;
+    }
+
+    while (!parser->is_failed && parser->operators_capacity > operators_base)
+    {
+        cwr_parser_reduce_group(parser, operators_base);
+        if (parser->is_failed || parser->operators_capacity == operators_base)
+        {
+            break;
+        }
+
+        // Unclosed group, fails on the current token
+        bool is_parenthesis = parser->operators[parser->operators_capacity - 1].kind == cwr_parser_operator_parenthesis_kind;
+        cwr_parser_except(parser, is_parenthesis ? cwr_token_right_par_type : cwr_token_right_square_type);
+    }
+
+    // Every failure within the right operand of a binary operator is an incorrect type, as in the recursive parser
+    if (parser->is_failed && parser->error.error_type != cwr_parser_error_out_of_memory_type && cwr_parser_has_binary(parser, operators_base))
+    {
+        cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
+    }
+
+    cwr_expression_index result = parser->is_failed ? CWR_EXPRESSION_INDEX_NONE : parser->operands[operands_base];
+    parser->operands_capacity = operands_base;
+    parser->operators_capacity = operators_base;
+    return result;
+}
+
+static const cwr_expression_type_value *cwr_parser_parse_multidimensional_array(cwr_parser *parser, const cwr_expression_type_value *type)
+{
+    if (cwr_parser_match(parser, cwr_token_asterisk_type))
+    {
+        type = cwr_parser_intern_pointer(parser, type, cwr_parser_current(parser).location);
+        if (type == NULL)
+        {
+            return NULL;
+        }
+
+        return cwr_parser_parse_multidimensional_array(parser, type);
+    }
+
+    return type;
+}
+
+// Returns 0 if signature is too long to be cached
+static size_t cwr_parser_function_key(cwr_parser *parser, char *name, cwr_expression_index *arguments, size_t count, char *key, size_t size)
+{
+    size_t length = strlen(name) + 1;
+    if (length > size)
+    {
+        return 0;
+    }
+
+    memcpy(key, name, length);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (length + sizeof(cwr_expression_type_value *) > size)
+        {
+            return 0;
+        }
+
+        // Interned, so the pointer stands for the whole type
+        const cwr_expression_type_value *type = cwr_expression_pool_type(parser->pool, arguments[i]);
+        memcpy(&key[length], &type, sizeof(type));
+        length += sizeof(type);
+    }
+
+    return length;
+}
+
+static cwr_parser_function_cache_entry *cwr_parser_function_cache_find(cwr_parser *parser, char *key, size_t length, size_t name_hash, size_t hash)
+{
+    if (parser->function_cache_size == 0)
+    {
+        return NULL;
+    }
+
+    cwr_parser_function_cache_entry *entry = parser->function_cache[name_hash & (parser->function_cache_size - 1)];
+    for (; entry != NULL; entry = entry->next)
+    {
+        if (entry->hash == hash && entry->length == length && memcmp(entry->key, key, length) == 0)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static bool cwr_parser_function_cache_resize(cwr_parser *parser)
+{
+    size_t size = parser->function_cache_size == 0 ? CWR_PARSER_FUNCTION_CACHE_SIZE : parser->function_cache_size * 2;
+    cwr_parser_function_cache_entry **buckets = calloc(size, sizeof(cwr_parser_function_cache_entry *));
+    if (buckets == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < parser->function_cache_size; i++)
+    {
+        cwr_parser_function_cache_entry *entry = parser->function_cache[i];
+        while (entry != NULL)
+        {
+            cwr_parser_function_cache_entry *next = entry->next;
+            size_t index = entry->name_hash & (size - 1);
+
+            entry->next = buckets[index];
+            buckets[index] = entry;
+            entry = next;
+        }
+    }
+
+    free(parser->function_cache);
+    parser->function_cache = buckets;
+    parser->function_cache_size = size;
+    return true;
+}
+
+static bool cwr_parser_function_cache_add(cwr_parser *parser, char *key, size_t length, size_t name_hash, size_t hash, size_t function)
+{
+    if (parser->function_cache_count >= parser->function_cache_size)
+    {
+        if (!cwr_parser_function_cache_resize(parser))
+        {
+            return false;
+        }
+    }
+
+    cwr_parser_function_cache_entry *entry = malloc(sizeof(cwr_parser_function_cache_entry) + length);
+    if (entry == NULL)
+    {
+        return false;
+    }
+
+    size_t index = name_hash & (parser->function_cache_size - 1);
+    entry->next = parser->function_cache[index];
+    entry->name_hash = name_hash;
+    entry->hash = hash;
+    entry->function = function;
+    entry->length = length;
+    memcpy(entry->key, key, length);
+
+    parser->function_cache[index] = entry;
+    parser->function_cache_count++;
+    return true;
+}
+
+// Drops every resolved signature of 'name', overloads with that name changed
+static void cwr_parser_function_cache_invalidate(cwr_parser *parser, char *name)
+{
+    if (parser->function_cache_size == 0)
+    {
+        return;
+    }
+
+    size_t length = strlen(name) + 1;
+    size_t name_hash = cwr_hash_bytes(name, length);
+    cwr_parser_function_cache_entry **link = &parser->function_cache[name_hash & (parser->function_cache_size - 1)];
+
+    while (*link != NULL)
+    {
+        cwr_parser_function_cache_entry *entry = *link;
+        if (entry->name_hash != name_hash || memcmp(entry->key, name, length) != 0)
+        {
+            link = &entry->next;
+            continue;
+        }
+
+        *link = entry->next;
+        parser->function_cache_count--;
+        free(entry);
+    }
+}
+
+static void cwr_parser_function_cache_destroy(cwr_parser *parser)
+{
+    for (size_t i = 0; i < parser->function_cache_size; i++)
+    {
+        cwr_parser_function_cache_entry *entry = parser->function_cache[i];
+        while (entry != NULL)
+        {
+            cwr_parser_function_cache_entry *next = entry->next;
+
+            free(entry);
+            entry = next;
+        }
+    }
+
+    free(parser->function_cache);
+    parser->function_cache = NULL;
+    parser->function_cache_size = 0;
+    parser->function_cache_count = 0;
+}
+
+// Moves past a body from '{' to its matching '}', false when it is never closed
+static bool cwr_parser_skip_body(cwr_parser *parser)
+{
+    size_t depth = 0;
+
+    while (!cwr_parser_ended(parser))
+    {
+        cwr_token_type type = cwr_parser_current(parser).type;
+        cwr_parser_skip(parser);
+
+        if (type == cwr_token_left_curly_type)
+        {
+            depth++;
+        }
+        else if (type == cwr_token_right_curly_type && --depth == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
 
-static cwr_expression_type_value cwr_parser_parse_multidimensional_array(cwr_parser *parser, cwr_expression_type_value type)
+// Bodies that can't be skipped are parsed in place, that reports their errors as before
+static bool cwr_parser_defer_body(cwr_parser *parser, cwr_func_decl_statement *func_decl)
 {
-    if (cwr_parser_match(parser, cwr_token_asterisk_type))
+    if (!cwr_parser_peek(parser, 0, cwr_token_left_curly_type))
     {
-        cwr_expression_type_value *target = malloc(sizeof(cwr_expression_type_value));
-        target->value_type = type.value_type;
-        target->identifier = type.identifier;
-        target->name = type.name;
-        target->target_type = type.target_type;
-        type = (cwr_expression_type_value){
-            .value_type = cwr_value_pointer_type,
-            .name = NULL,
-            .target_type = target};
+        return false;
+    }
 
-        return cwr_parser_parse_multidimensional_array(parser, type);
+    size_t start = parser->position;
+    if (!cwr_parser_skip_body(parser) || !CWR_VECTOR_RESERVE(parser->bodies, parser->bodies_size, parser->bodies_capacity, 1))
+    {
+        parser->position = start;
+        return false;
     }
 
-    return type;
+    parser->bodies[parser->bodies_capacity++] = (cwr_parser_body){
+        .statement = parser->capacity,
+        .start = start,
+        .end = parser->position,
+        .functions = parser->functions_capacity,
+        .arguments = func_decl->arguments,
+        .count = func_decl->count,
+        .body = (cwr_func_body_expression){
+            .root = parser->root,
+            .statements = NULL,
+            .count = 0},
+        .frame_size = 0,
+        .is_parsed = false};
+    return true;
+}
+
+static void cwr_parser_parse_deferred_body(cwr_parser *parser, cwr_parser_body *body)
+{
+    parser->position = body->start;
+    parser->functions_capacity = body->functions;
+    parser->root = body->body.root;
+    parser->variables_capacity = 0;
+    parser->frame = 0;
+    parser->frame_size = 0;
+
+    // Arguments are declared as 'cwr_parser_parse_function_declaration' does
+    for (size_t i = 0; i < body->count; i++)
+    {
+        cwr_argument argument = body->arguments[i];
+        cwr_parser_variable variable = (cwr_parser_variable){
+            .name = argument.name,
+            .identifier = argument.identifier,
+            .root = &body->body,
+            .type = argument.type};
+
+        if (!cwr_parser_add_variable(parser, variable))
+        {
+            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+            return;
+        }
+    }
+
+    cwr_parser_parse_function_body_by_created(parser, &body->body);
+    body->frame_size = parser->frame_size;
+}
+
+static void *cwr_parser_run_worker(void *argument)
+{
+    cwr_parser_worker *worker = argument;
+
+    for (size_t i = 0; i < worker->count && !worker->parser.is_failed; i++)
+    {
+        cwr_parser_parse_deferred_body(&worker->parser, &worker->bodies[i]);
+    }
+
+    return NULL;
+}
+
+static void cwr_parser_worker_create(cwr_parser_worker *worker, cwr_parser *parser, cwr_parser_body *bodies, size_t count)
+{
+    worker->bodies = bodies;
+    worker->count = count;
+    worker->is_started = false;
+
+    cwr_parser *target = &worker->parser;
+    *target = *parser;
+    target->arena = cwr_arena_create();
+    target->pool = cwr_expression_pool_create();
+    target->statements = NULL;
+    target->capacity = 0;
+    target->statements_size = 0;
+    target->variables = NULL;
+    target->variables_capacity = 0;
+    target->variables_size = 0;
+    target->arguments = NULL;
+    target->arguments_capacity = 0;
+    target->arguments_size = 0;
+    target->operands = NULL;
+    target->operands_capacity = 0;
+    target->operands_size = 0;
+    target->operators = NULL;
+    target->operators_capacity = 0;
+    target->operators_size = 0;
+    target->function_cache = NULL;
+    target->function_cache_size = 0;
+    target->function_cache_count = 0;
+    target->bodies = NULL;
+    target->bodies_capacity = 0;
+    target->bodies_size = 0;
+    target->threads = 1;
+    target->is_failed = false;
+
+    if (target->arena == NULL || target->pool == NULL)
+    {
+        cwr_parser_throw_out_of_memory(target, cwr_parser_current(target).location);
+    }
+}
+
+static bool cwr_parser_relocate_statement(cwr_statement *statement, cwr_func_body_expression *body, void *context)
+{
+    cwr_expression_pool_offset *offset = context;
+
+    switch (statement->type)
+    {
+    case cwr_statement_func_call_type:
+        statement->func_call.arguments += offset->indices;
+        break;
+    case cwr_statement_var_decl_type:
+        statement->var_decl.value += offset->expressions;
+        break;
+    case cwr_statement_assign_type:
+        statement->assign.identifier += offset->expressions;
+        statement->assign.value += offset->expressions;
+        break;
+    case cwr_statement_for_loop_type:
+        if (statement->for_loop.with_variable)
+        {
+            statement->for_loop.variable.value += offset->expressions;
+        }
+
+        if (statement->for_loop.with_condition)
+        {
+            statement->for_loop.condition += offset->expressions;
+        }
+
+        break;
+    case cwr_statement_if_type:
+        statement->if_stat.condition += offset->expressions;
+        break;
+    case cwr_statement_return_type:
+        statement->ret.value += offset->expressions;
+        break;
+    }
+
+    return true;
+}
+
+// Appends the pool of the worker to the parser one and hands the parsed bodies to their declarations
+static void cwr_parser_merge_worker(cwr_parser *parser, cwr_parser_worker *worker, cwr_walker *walker)
+{
+    cwr_parser *source = &worker->parser;
+
+    free(source->variables);
+    free(source->arguments);
+    free(source->operands);
+    free(source->operators);
+    cwr_parser_function_cache_destroy(source);
+
+    if (!parser->is_failed && worker->count > 0)
+    {
+        cwr_expression_pool_offset offset;
+        if (!cwr_expression_pool_append(parser->pool, source->pool, &offset))
+        {
+            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+        }
+
+        for (size_t i = 0; i < worker->count && !parser->is_failed; i++)
+        {
+            cwr_parser_body *body = &worker->bodies[i];
+            if (!cwr_walker_walk_statements(walker, body->body.statements, body->body.count, &body->body, cwr_parser_relocate_statement, &offset))
+            {
+                cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+                break;
+            }
+
+            cwr_func_decl_statement *func_decl = &parser->statements[body->statement].func_decl;
+            func_decl->func_body = body->body;
+            func_decl->frame_size = body->frame_size;
+        }
+    }
+
+    if (source->arena != NULL)
+    {
+        cwr_arena_merge(parser->arena, source->arena);
+    }
+
+    cwr_expression_pool_destroy(source->pool);
+}
+
+// Keeps skipped bodies with the result, everything in it lives in the arena
+static cwr_parser_lazy *cwr_parser_create_lazy(cwr_parser *parser, cwr_statement *statements, cwr_parser_function *functions)
+{
+    cwr_location location = cwr_parser_current(parser).location;
+    cwr_parser_lazy *lazy = cwr_parser_allocate(parser, sizeof(cwr_parser_lazy), location);
+    if (parser->is_failed)
+    {
+        return NULL;
+    }
+
+    size_t *positions = cwr_parser_allocate(parser, parser->functions_capacity * sizeof(size_t), location);
+    if (parser->is_failed)
+    {
+        return NULL;
+    }
+
+    cwr_parser_body *bodies = cwr_parser_move_to_arena(parser, parser->bodies, parser->bodies_capacity * sizeof(cwr_parser_body), location);
+    parser->bodies = NULL;
+    if (parser->is_failed)
+    {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < parser->functions_capacity; i++)
+    {
+        positions[i] = SIZE_MAX;
+    }
+
+    for (size_t i = 0; i < parser->bodies_capacity; i++)
+    {
+        positions[statements[bodies[i].statement].func_decl.identifier] = i;
+    }
+
+    *lazy = (cwr_parser_lazy){
+        .arena = parser->arena,
+        .pool = parser->pool,
+        .tokens = parser->tokens,
+        .count = parser->count,
+        .functions = functions,
+        .bodies = bodies,
+        .positions = positions};
+    return lazy;
+}
+
+// Parses skipped bodies in contiguous runs of similar token count, one run per thread
+static void cwr_parser_parse_bodies(cwr_parser *parser)
+{
+    size_t count = parser->bodies_capacity;
+    if (count == 0)
+    {
+        return;
+    }
+
+    size_t threads = count / CWR_PARSER_THREAD_BODIES;
+    if (threads > parser->threads)
+    {
+        threads = parser->threads;
+    }
+
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    cwr_parser_worker *workers = malloc(threads * sizeof(cwr_parser_worker));
+    if (workers == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+        return;
+    }
+
+    size_t tokens = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        tokens += parser->bodies[i].end - parser->bodies[i].start;
+    }
+
+    size_t first = 0;
+    size_t taken = 0;
+    for (size_t i = 0; i < threads; i++)
+    {
+        size_t last = first;
+        size_t target = tokens / threads * (i + 1);
+
+        while (last < count && (taken < target || i == threads - 1))
+        {
+            taken += parser->bodies[last].end - parser->bodies[last].start;
+            last++;
+        }
+
+        cwr_parser_worker_create(&workers[i], parser, &parser->bodies[first], last - first);
+        first = last;
+    }
+
+    for (size_t i = 1; i < threads; i++)
+    {
+        workers[i].is_started = pthread_create(&workers[i].thread, NULL, cwr_parser_run_worker, &workers[i]) == 0;
+    }
+
+    cwr_parser_run_worker(&workers[0]);
+
+    for (size_t i = 1; i < threads; i++)
+    {
+        if (workers[i].is_started)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+        else
+        {
+            cwr_parser_run_worker(&workers[i]);
+        }
+    }
+
+    // Skipped bodies are before a failed declaration, so the first failed body is the first error in the file
+    for (size_t i = 0; i < threads; i++)
+    {
+        if (workers[i].parser.is_failed)
+        {
+            parser->error = workers[i].parser.error;
+            parser->is_failed = true;
+            break;
+        }
+    }
+
+    cwr_walker *walker = NULL;
+    if (!parser->is_failed)
+    {
+        walker = cwr_walker_create();
+        if (walker == NULL)
+        {
+            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+        }
+    }
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        cwr_parser_merge_worker(parser, &workers[i], walker);
+    }
+
+    if (walker != NULL)
+    {
+        cwr_walker_destroy(walker);
+    }
+
+    free(workers);
 }
 
-cwr_parser *cwr_parser_create(cwr_tokens_list tokens_list)
+cwr_parser *cwr_parser_create(cwr_tokens_list tokens_list, cwr_parser_configuration *configuration)
 {
     cwr_parser *parser = malloc(sizeof(cwr_parser));
 
@@ -49,25 +1070,56 @@ cwr_parser *cwr_parser_create(cwr_tokens_list tokens_list)
     }
 
     parser->capacity = 0;
+    parser->statements_size = 0;
     parser->statements = NULL;
     parser->tokens = tokens_list.tokens;
     parser->count = tokens_list.count;
+    parser->threads = configuration->threads;
+    parser->is_lazy = configuration->is_lazy;
     return parser;
 }
 
 cwr_parser_result cwr_parser_parse(cwr_parser *parser)
 {
+    parser->arena = cwr_arena_create();
+    parser->pool = cwr_expression_pool_create();
     parser->root = NULL;
     parser->capacity = 0;
+    parser->statements_size = 0;
     parser->statements = NULL;
     parser->position = 0;
     parser->is_failed = false;
     parser->functions_capacity = 0;
+    parser->functions_size = 0;
     parser->functions = NULL;
     parser->variables_capacity = 0;
+    parser->variables_size = 0;
     parser->variables = NULL;
+    parser->frame = 0;
+    parser->frame_size = 0;
+    parser->is_return_local = false;
+    parser->arguments_capacity = 0;
+    parser->arguments_size = 0;
+    parser->arguments = NULL;
+    parser->operands_capacity = 0;
+    parser->operands_size = 0;
+    parser->operands = NULL;
+    parser->operators_capacity = 0;
+    parser->operators_size = 0;
+    parser->operators = NULL;
+    parser->function_cache = NULL;
+    parser->function_cache_size = 0;
+    parser->function_cache_count = 0;
+    parser->bodies = NULL;
+    parser->bodies_capacity = 0;
+    parser->bodies_size = 0;
+
+    if (parser->arena == NULL || parser->pool == NULL)
+    {
+        cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+    }
 
-    while (!cwr_parser_ended(parser))
+    while (!parser->is_failed && !cwr_parser_ended(parser))
     {
         cwr_statement declaration = cwr_parser_parse_declaration(parser);
         if (parser->is_failed)
@@ -75,21 +1127,106 @@ cwr_parser_result cwr_parser_parse(cwr_parser *parser)
             break;
         }
 
-        cwr_parser_add_statement(parser, declaration);
+        if (!cwr_parser_add_statement(parser, declaration))
+        {
+            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
+            break;
+        }
+    }
+
+    if (!parser->is_lazy)
+    {
+        cwr_parser_parse_bodies(parser);
     }
 
     free(parser->variables);
+    free(parser->arguments);
+    free(parser->operands);
+    free(parser->operators);
+    cwr_parser_function_cache_destroy(parser);
+
+    if (parser->pool != NULL)
+    {
+        cwr_expression_pool_trim(parser->pool);
+    }
+
+    cwr_location location = cwr_parser_current(parser).location;
+    cwr_statement *statements = NULL;
+    cwr_parser_function *functions = NULL;
+
+    if (parser->arena != NULL)
+    {
+        statements = cwr_parser_move_to_arena(parser, parser->statements, parser->capacity * sizeof(cwr_statement), location);
+        functions = cwr_parser_move_to_arena(parser, parser->functions, parser->functions_capacity * sizeof(cwr_parser_function), location);
+    }
+    else
+    {
+        free(parser->statements);
+        free(parser->functions);
+    }
+
+    cwr_parser_lazy *lazy = NULL;
+    if (parser->is_lazy && parser->bodies_capacity > 0 && !parser->is_failed)
+    {
+        lazy = cwr_parser_create_lazy(parser, statements, functions);
+    }
+
+    free(parser->bodies);
+
     return (cwr_parser_result){
+        .arena = parser->arena,
         .nodes_list = (cwr_nodes_list){
-            .statements = parser->statements,
-            .count = parser->capacity,
+            .statements = statements,
+            .count = statements == NULL ? 0 : parser->capacity,
+            .pool = parser->pool,
         },
-        .functions = parser->functions,
-        .functions_count = parser->functions_capacity,
+        .functions = functions,
+        .functions_count = functions == NULL ? 0 : parser->functions_capacity,
+        .lazy = lazy,
         .error = parser->error,
         .is_failed = parser->is_failed};
 }
 
+bool cwr_parser_parse_lazy_body(cwr_parser_lazy *lazy, size_t function, cwr_func_body_expression *body, size_t *frame_size, cwr_parser_error *error)
+{
+    cwr_parser_body *target = &lazy->bodies[lazy->positions[function]];
+
+    if (!target->is_parsed)
+    {
+        // Parses straight into the arena and pool of the result, nothing has to be merged
+        cwr_parser parser = (cwr_parser){
+            .arena = lazy->arena,
+            .pool = lazy->pool,
+            .tokens = lazy->tokens,
+            .count = lazy->count,
+            .functions = lazy->functions,
+            .threads = 1,
+            .is_failed = false};
+
+        target->body.statements = NULL;
+        target->body.count = 0;
+        cwr_parser_parse_deferred_body(&parser, target);
+
+        free(parser.variables);
+        free(parser.arguments);
+        free(parser.operands);
+        free(parser.operators);
+        cwr_parser_function_cache_destroy(&parser);
+
+        if (parser.is_failed)
+        {
+            *error = parser.error;
+            return false;
+        }
+
+        target->is_parsed = true;
+    }
+
+    *body = target->body;
+    *frame_size = target->frame_size;
+    return true;
+}
+
 cwr_statement_type cwr_parser_get_statement(cwr_parser *parser)
 {
     cwr_token current = cwr_parser_current(parser);
@@ -131,46 +1268,48 @@ cwr_statement_type cwr_parser_get_statement(cwr_parser *parser)
 
 bool cwr_parser_add_statement(cwr_parser *parser, cwr_statement node)
 {
-    cwr_statement *buffer = realloc(parser->statements, (parser->capacity + 1) * sizeof(cwr_statement));
-
-    if (buffer == NULL)
+    if (!CWR_VECTOR_RESERVE(parser->statements, parser->statements_size, parser->capacity, 1))
     {
         return false;
     }
 
-    parser->statements = buffer;
     parser->statements[parser->capacity++] = node;
     return true;
 }
 
 bool cwr_parser_add_function(cwr_parser *parser, cwr_parser_function function)
 {
-    cwr_parser_function *buffer = realloc(parser->functions, (parser->functions_capacity + 1) * sizeof(cwr_parser_function));
-
-    if (buffer == NULL)
+    if (!CWR_VECTOR_RESERVE(parser->functions, parser->functions_size, parser->functions_capacity, 1))
     {
         return false;
     }
 
-    parser->functions = buffer;
     parser->functions[parser->functions_capacity++] = function;
+    cwr_parser_function_cache_invalidate(parser, function.name);
     return true;
 }
 
 bool cwr_parser_add_variable(cwr_parser *parser, cwr_parser_variable variable)
 {
-    cwr_parser_variable *buffer = realloc(parser->variables, (parser->variables_capacity + 1) * sizeof(cwr_parser_variable));
-
-    if (buffer == NULL)
+    if (!CWR_VECTOR_RESERVE(parser->variables, parser->variables_size, parser->variables_capacity, 1))
     {
         return false;
     }
 
-    parser->variables = buffer;
     parser->variables[parser->variables_capacity++] = variable;
+    if (parser->variables_capacity - parser->frame > parser->frame_size)
+    {
+        parser->frame_size = parser->variables_capacity - parser->frame;
+    }
+
     return true;
 }
 
+static size_t cwr_parser_next_slot(cwr_parser *parser)
+{
+    return parser->variables_capacity - parser->frame;
+}
+
 void cwr_parser_clear_scope(cwr_parser *parser, cwr_func_body_expression *root)
 {
     for (int i = parser->variables_capacity - 1; i >= 0; i--)
@@ -181,7 +1320,8 @@ void cwr_parser_clear_scope(cwr_parser *parser, cwr_func_body_expression *root)
             continue;
         }
 
-        parser->variables = realloc(parser->variables, --parser->variables_capacity * sizeof(cwr_parser_variable));
+        // Scoped variables are always on top, the buffer is kept for the next scope
+        parser->variables_capacity--;
     }
 }
 
@@ -194,7 +1334,7 @@ cwr_statement cwr_parser_parse_declaration(cwr_parser *parser)
     {
     case cwr_statement_func_decl_type:
     {
-        cwr_expression_type_value type = cwr_parser_parse_type(parser);
+        const cwr_expression_type_value *type = cwr_parser_parse_type(parser);
         CWR_PARSER_FAILED_AND_RETURN(parser, cwr_statement);
 
         cwr_func_decl_statement decl = cwr_parser_parse_function_declaration(parser, type);
@@ -230,7 +1370,6 @@ cwr_statement cwr_parser_parse_statement(cwr_parser *parser)
         cwr_parser_except(parser, cwr_token_semicolon_type);
         if (parser->is_failed)
         {
-            cwr_statement_destroy(statement);
             return (cwr_statement){};
         }
     }
@@ -276,7 +1415,7 @@ cwr_statement cwr_parser_parse_only_statement(cwr_parser *parser)
     }
     case cwr_statement_return_type:
     {
-        cwr_return_statement return_statement = cwr_parser_parse_return(parser, cwr_expression_type_value_create_from_type(cwr_value_void_type));
+        cwr_return_statement return_statement = cwr_parser_parse_return(parser, cwr_type_from(cwr_value_void_type));
         statement = (cwr_statement){
             .type = cwr_statement_return_type,
             .location = location,
@@ -286,7 +1425,7 @@ cwr_statement cwr_parser_parse_only_statement(cwr_parser *parser)
     }
     case cwr_statement_var_decl_type:
     {
-        cwr_expression_type_value type = cwr_parser_parse_type(parser);
+        const cwr_expression_type_value *type = cwr_parser_parse_type(parser);
         CWR_PARSER_FAILED_AND_RETURN(parser, cwr_statement);
 
         cwr_var_decl_statement var_decl = cwr_parser_parse_variable_declaration(parser, type);
@@ -322,28 +1461,18 @@ cwr_statement cwr_parser_parse_only_statement(cwr_parser *parser)
 cwr_assign_statement cwr_parser_parse_assign(cwr_parser *parser)
 {
     bool is_dereference = cwr_parser_current(parser).type == cwr_token_asterisk_type;
-    cwr_expression identifier = cwr_parser_parse_unary(parser, is_dereference);
+    cwr_expression_index identifier = cwr_parser_parse_unary(parser, is_dereference);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_assign_statement);
 
     cwr_parser_except(parser, cwr_token_equals_type);
-    if (parser->is_failed)
-    {
-        cwr_expression_destroy(identifier);
-        return (cwr_assign_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_assign_statement);
 
-    cwr_expression value = cwr_parser_parse_binary(parser);
-    if (parser->is_failed)
-    {
-        cwr_expression_destroy(identifier);
-        return (cwr_assign_statement){};
-    }
+    cwr_expression_index value = cwr_parser_parse_binary(parser);
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_assign_statement);
 
-    if (!cwr_expression_type_value_equals(identifier.value_type, value.value_type))
+    if (!cwr_type_equals(cwr_expression_pool_type(parser->pool, identifier), cwr_expression_pool_type(parser->pool, value)))
     {
-        cwr_expression_destroy(identifier);
-        cwr_expression_destroy(value);
-        cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", identifier.location);
+        cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_expression_pool_location(parser->pool, identifier));
         return (cwr_assign_statement){};
     }
 
@@ -353,11 +1482,10 @@ cwr_assign_statement cwr_parser_parse_assign(cwr_parser *parser)
         .is_dereference = is_dereference};
 }
 
-cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser, cwr_expression_type_value type)
+cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser, const cwr_expression_type_value *type)
 {
-    if (type.value_type == cwr_value_void_type)
+    if (type->value_type == cwr_value_void_type)
     {
-        cwr_expression_type_value_destroy(type);
         cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
         return (cwr_var_decl_statement){};
     }
@@ -365,51 +1493,31 @@ cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser,
     cwr_token name = cwr_parser_except(parser, cwr_token_word_type);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_var_decl_statement);
 
-    char *name_copy = cwr_string_duplicate(name.value);
-    if (name_copy == NULL)
-    {
-        cwr_expression_type_value_destroy(type);
-        cwr_parser_throw_out_of_memory(parser, name.location);
-        return (cwr_var_decl_statement){};
-    }
+    char *name_copy = cwr_parser_duplicate(parser, name.value, name.location);
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_var_decl_statement);
 
     cwr_parser_except(parser, cwr_token_equals_type);
-    if (parser->is_failed)
-    {
-        free(name_copy);
-        cwr_expression_type_value_destroy(type);
-        return (cwr_var_decl_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_var_decl_statement);
 
-    cwr_expression value = cwr_parser_parse_binary(parser);
-    if (parser->is_failed)
-    {
-        free(name_copy);
-        cwr_expression_type_value_destroy(type);
-        return (cwr_var_decl_statement){};
-    }
+    cwr_expression_index value = cwr_parser_parse_binary(parser);
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_var_decl_statement);
 
-    if (value.value_type.value_type == cwr_value_void_type || !cwr_expression_type_value_equals(type, value.value_type))
+    const cwr_expression_type_value *value_type = cwr_expression_pool_type(parser->pool, value);
+    if (value_type->value_type == cwr_value_void_type || !cwr_type_equals(type, value_type))
     {
-        free(name_copy);
-        cwr_expression_destroy(value);
-        cwr_expression_type_value_destroy(type);
         cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
         return (cwr_var_decl_statement){};
     }
 
     cwr_parser_variable variable = (cwr_parser_variable){
         .type = type,
-        .identifier = parser->variables_capacity,
+        .identifier = cwr_parser_next_slot(parser),
         .root = parser->root,
         .name = name_copy,
-        .static_value = NULL};
+        .static_value = CWR_EXPRESSION_INDEX_NONE};
 
     if (!cwr_parser_add_variable(parser, variable))
     {
-        free(name_copy);
-        cwr_expression_destroy(value);
-        cwr_expression_type_value_destroy(type);
         cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
         return (cwr_var_decl_statement){};
     }
@@ -421,26 +1529,16 @@ cwr_var_decl_statement cwr_parser_parse_variable_declaration(cwr_parser *parser,
         .value = value};
 }
 
-cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser, cwr_expression_type_value type)
+cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser, const cwr_expression_type_value *type)
 {
     cwr_token name = cwr_parser_except(parser, cwr_token_word_type);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_decl_statement);
 
-    char *name_copy = cwr_string_duplicate(name.value);
-    if (name_copy == NULL)
-    {
-        cwr_expression_type_value_destroy(type);
-        cwr_parser_throw_out_of_memory(parser, name.location);
-        return (cwr_func_decl_statement){};
-    }
+    char *name_copy = cwr_parser_duplicate(parser, name.value, name.location);
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_decl_statement);
 
     cwr_parser_except(parser, cwr_token_left_par_type);
-    if (parser->is_failed)
-    {
-        free(name_copy);
-        cwr_expression_type_value_destroy(type);
-        return (cwr_func_decl_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_decl_statement);
 
     cwr_location location = cwr_parser_current(parser).location;
 
@@ -457,60 +1555,62 @@ cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser
         .count = 0,
         .with_body = false,
         .return_type = type};
+    size_t arguments_size = 0;
+
+    size_t frame = parser->frame;
+    size_t frame_size = parser->frame_size;
+    parser->frame = parser->variables_capacity;
+    parser->frame_size = 0;
 
     while (!cwr_parser_match(parser, cwr_token_right_par_type))
     {
         if (cwr_parser_ended(parser))
         {
-            cwr_func_decl_destroy(func_decl);
+            free(func_decl.arguments);
             cwr_parser_throw_error(parser, cwr_parser_error_except_token_type, "Except )", location);
             return (cwr_func_decl_statement){};
         }
 
-        cwr_expression_type_value argument_type = cwr_parser_parse_type(parser);
+        const cwr_expression_type_value *argument_type = cwr_parser_parse_type(parser);
         if (parser->is_failed)
         {
-            cwr_func_decl_destroy(func_decl);
+            free(func_decl.arguments);
             return (cwr_func_decl_statement){};
         }
 
         cwr_token argument_name = cwr_parser_except(parser, cwr_token_word_type);
         if (parser->is_failed)
         {
-            cwr_func_decl_destroy(func_decl);
-            cwr_expression_type_value_destroy(argument_type);
+            free(func_decl.arguments);
             return (cwr_func_decl_statement){};
         }
 
-        cwr_argument *buffer = realloc(func_decl.arguments, (func_decl.count + 1) * sizeof(cwr_argument));
-        if (buffer == NULL)
+        if (!CWR_VECTOR_RESERVE(func_decl.arguments, arguments_size, func_decl.count, 1))
         {
-            cwr_func_decl_destroy(func_decl);
-            cwr_expression_type_value_destroy(argument_type);
+            free(func_decl.arguments);
+            cwr_parser_throw_out_of_memory(parser, argument_name.location);
             return (cwr_func_decl_statement){};
         }
 
-        cwr_parser_variable variable = (cwr_parser_variable){
-            .name = argument_name.value,
-            .identifier = parser->variables_capacity,
-            .root = body_pointer,
-            .type = argument_type};
-        if (!cwr_parser_add_variable(parser, variable))
+        char *copy = cwr_parser_duplicate(parser, argument_name.value, argument_name.location);
+        if (parser->is_failed)
         {
-            cwr_func_decl_destroy(func_decl);
-            cwr_expression_type_value_destroy(argument_type);
+            free(func_decl.arguments);
             return (cwr_func_decl_statement){};
         }
 
-        char *copy = cwr_string_duplicate(argument_name.value);
-        if (copy == NULL)
+        cwr_parser_variable variable = (cwr_parser_variable){
+            .name = copy,
+            .identifier = cwr_parser_next_slot(parser),
+            .root = body_pointer,
+            .type = argument_type};
+        if (!cwr_parser_add_variable(parser, variable))
         {
-            cwr_func_decl_destroy(func_decl);
-            cwr_expression_type_value_destroy(argument_type);
+            free(func_decl.arguments);
+            cwr_parser_throw_out_of_memory(parser, argument_name.location);
             return (cwr_func_decl_statement){};
         }
 
-        func_decl.arguments = buffer;
         func_decl.arguments[func_decl.count++] = (cwr_argument){
             .identifier = variable.identifier,
             .name = copy,
@@ -518,6 +1618,9 @@ cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser
         cwr_parser_match(parser, cwr_token_comma_type);
     }
 
+    func_decl.arguments = cwr_parser_move_to_arena(parser, func_decl.arguments, func_decl.count * sizeof(cwr_argument), location);
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_decl_statement);
+
     cwr_parser_function function = (cwr_parser_function){
         .identifier = parser->functions_capacity,
         .name = name_copy,
@@ -526,7 +1629,6 @@ cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser
         .return_type = type};
     if (!cwr_parser_add_function(parser, function))
     {
-        cwr_func_decl_destroy(func_decl);
         cwr_parser_throw_out_of_memory(parser, name.location);
         return (cwr_func_decl_statement){};
     }
@@ -534,11 +1636,16 @@ cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser
     bool with_body = false;
     if (!cwr_parser_match(parser, cwr_token_semicolon_type))
     {
-        cwr_parser_parse_function_body_by_created(parser, body_pointer);
-        if (parser->is_failed)
+        if ((parser->threads > 1 || parser->is_lazy) && cwr_parser_defer_body(parser, &func_decl))
         {
-            cwr_func_decl_destroy(func_decl);
-            return (cwr_func_decl_statement){};
+            // Arguments are declared again by whoever parses the body
+            cwr_parser_clear_scope(parser, body_pointer);
+            func_decl.is_lazy = parser->is_lazy;
+        }
+        else
+        {
+            cwr_parser_parse_function_body_by_created(parser, body_pointer);
+            CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_decl_statement);
         }
 
         with_body = true;
@@ -550,21 +1657,21 @@ cwr_func_decl_statement cwr_parser_parse_function_declaration(cwr_parser *parser
 
     func_decl.func_body = body;
     func_decl.with_body = with_body;
+    func_decl.frame_size = parser->frame_size;
+
+    parser->frame = frame;
+    parser->frame_size = frame_size;
     return func_decl;
 }
 
 cwr_if_statement cwr_parser_parse_if(cwr_parser *parser)
 {
     cwr_parser_match(parser, cwr_token_if_type);
-    cwr_expression condition = cwr_parser_parse_binary(parser);
+    cwr_expression_index condition = cwr_parser_parse_binary(parser);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_if_statement);
 
     cwr_func_body_expression body = cwr_parser_parse_function_body(parser);
-    if (parser->is_failed)
-    {
-        cwr_expression_destroy(condition);
-        return (cwr_if_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_if_statement);
 
     return (cwr_if_statement){
         .condition = condition,
@@ -583,99 +1690,60 @@ cwr_for_loop_statement cwr_parser_parse_for_loop(cwr_parser *parser)
         .with_statement = false,
         .with_body = false};
 
+    // Variables declared in the header are only visible inside the loop
+    size_t scope = parser->variables_capacity;
+
     if (!cwr_parser_match(parser, cwr_token_semicolon_type))
     {
-        cwr_expression_type_value type = cwr_parser_parse_type(parser);
+        const cwr_expression_type_value *type = cwr_parser_parse_type(parser);
         CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
         for_stat.variable = cwr_parser_parse_variable_declaration(parser, type);
-        if (parser->is_failed)
-        {
-            cwr_expression_type_value_destroy(type);
-            return (cwr_for_loop_statement){};
-        }
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
         for_stat.with_variable = true;
 
         cwr_parser_except(parser, cwr_token_semicolon_type);
-        if (parser->is_failed)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            return (cwr_for_loop_statement){};
-        }
-
-        cwr_parser_variable variable = (cwr_parser_variable){
-            .identifier = for_stat.variable.identifier,
-            .name = for_stat.variable.name,
-            .type = for_stat.variable.value_type};
-
-        if (!cwr_parser_add_variable(parser, variable))
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
-            return (cwr_for_loop_statement){};
-        }
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
     }
 
     if (!cwr_parser_match(parser, cwr_token_semicolon_type))
     {
         for_stat.condition = cwr_parser_parse_binary(parser);
-        if (parser->is_failed)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            return (cwr_for_loop_statement){};
-        }
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
         for_stat.with_condition = true;
 
-        if (for_stat.condition.value_type.value_type != cwr_value_integer_type)
+        if (cwr_expression_pool_type(parser->pool, for_stat.condition)->value_type != cwr_value_integer_type)
         {
-            cwr_statement_destroy_for_loop(for_stat);
             return (cwr_for_loop_statement){};
         }
 
         cwr_parser_except(parser, cwr_token_semicolon_type);
-        if (parser->is_failed)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            return (cwr_for_loop_statement){};
-        }
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
     }
 
     if (!cwr_parser_match(parser, cwr_token_right_par_type))
     {
-        for_stat.statement = malloc(sizeof(cwr_statement));
-        if (for_stat.statement == NULL)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            return (cwr_for_loop_statement){};
-        }
+        for_stat.statement = cwr_parser_allocate(parser, sizeof(cwr_statement), cwr_parser_current(parser).location);
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
+        bool is_return_local = parser->is_return_local;
+        parser->is_return_local = true;
         *for_stat.statement = cwr_parser_parse_only_statement(parser);
-        if (parser->is_failed)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            free(for_stat.statement);
-            return (cwr_for_loop_statement){};
-        }
+        parser->is_return_local = is_return_local;
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
         for_stat.with_statement = true;
 
         cwr_parser_except(parser, cwr_token_right_par_type);
-        if (parser->is_failed)
-        {
-            cwr_statement_destroy_for_loop(for_stat);
-            return (cwr_for_loop_statement){};
-        }
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
     }
 
     cwr_func_body_expression body = cwr_parser_parse_function_body(parser);
-    if (parser->is_failed)
-    {
-        cwr_statement_destroy_for_loop(for_stat);
-        return (cwr_for_loop_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_for_loop_statement);
 
+    parser->variables_capacity = scope;
     for_stat.with_body = true;
     for_stat.body = body;
     return for_stat;
@@ -686,74 +1754,68 @@ cwr_func_call_statement cwr_parser_parse_function_call(cwr_parser *parser)
     cwr_token name = cwr_parser_except(parser, cwr_token_word_type);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_call_statement);
 
-    char *name_copy = cwr_string_duplicate(name.value);
-    if (name_copy == NULL)
-    {
-        cwr_parser_throw_out_of_memory(parser, name.location);
-        return (cwr_func_call_statement){};
-    }
-
     cwr_parser_except(parser, cwr_token_left_par_type);
-    if (parser->is_failed)
-    {
-        free(name_copy);
-        return (cwr_func_call_statement){};
-    }
+    CWR_PARSER_FAILED_AND_RETURN(parser, cwr_func_call_statement);
 
-    cwr_func_call_statement func_call = (cwr_func_call_statement){
-        .identifier = 0,
-        .name = name_copy,
-        .arguments = NULL,
-        .count = 0};
+    // Nested calls push their arguments above ours and pop them before we continue
+    size_t base = parser->arguments_capacity;
     cwr_location location = cwr_parser_current(parser).location;
 
     while (!cwr_parser_match(parser, cwr_token_right_par_type))
     {
         if (cwr_parser_ended(parser))
         {
-            cwr_statement_destroy_func_call(func_call);
+            parser->arguments_capacity = base;
             cwr_parser_throw_error(parser, cwr_parser_error_except_token_type, "Except )", location);
             return (cwr_func_call_statement){};
         }
 
-        cwr_expression value = cwr_parser_parse_binary(parser);
+        cwr_expression_index value = cwr_parser_parse_binary(parser);
         if (parser->is_failed)
         {
-            cwr_statement_destroy_func_call(func_call);
+            parser->arguments_capacity = base;
             return (cwr_func_call_statement){};
         }
 
-        cwr_expression *buffer = realloc(func_call.arguments, (func_call.count + 1) * sizeof(cwr_expression));
-        if (buffer == NULL)
+        if (!CWR_VECTOR_RESERVE(parser->arguments, parser->arguments_size, parser->arguments_capacity, 1))
         {
-            cwr_statement_destroy_func_call(func_call);
-            cwr_expression_destroy(value);
+            parser->arguments_capacity = base;
+            cwr_parser_throw_out_of_memory(parser, cwr_expression_pool_location(parser->pool, value));
             return (cwr_func_call_statement){};
         }
 
-        func_call.arguments = buffer;
-        func_call.arguments[func_call.count++] = value;
+        parser->arguments[parser->arguments_capacity++] = value;
         cwr_parser_match(parser, cwr_token_comma_type);
     }
 
+    size_t count = parser->arguments_capacity - base;
+    parser->arguments_capacity = base;
+
     cwr_parser_function target;
-    if (!cwr_parser_get_function(parser, name_copy, func_call.arguments, func_call.count, &target))
+    if (!cwr_parser_get_function(parser, name.value, parser->arguments + base, count, &target))
     {
-        cwr_statement_destroy_func_call(func_call);
         cwr_parser_throw_error(parser, cwr_parser_error_unknown_function_type, "Unknown function", location);
         return (cwr_func_call_statement){};
     }
 
-    func_call.identifier = target.identifier;
-    func_call.return_type = target.return_type;
-    return func_call;
+    uint32_t offset = cwr_expression_pool_add_indices(parser->pool, parser->arguments + base, count);
+    if (offset == CWR_EXPRESSION_INDEX_NONE)
+    {
+        cwr_parser_throw_out_of_memory(parser, location);
+        return (cwr_func_call_statement){};
+    }
+
+    return (cwr_func_call_statement){
+        .identifier = target.identifier,
+        .arguments = offset,
+        .count = count};
 }
 
-cwr_return_statement cwr_parser_parse_return(cwr_parser *parser, cwr_expression_type_value type)
+cwr_return_statement cwr_parser_parse_return(cwr_parser *parser, const cwr_expression_type_value *type)
 {
     cwr_parser_match(parser, cwr_token_return_type);
 
-    cwr_expression value = cwr_parser_parse_binary(parser);
+    cwr_expression_index value = cwr_parser_parse_binary(parser);
     CWR_PARSER_FAILED_AND_RETURN(parser, cwr_return_statement);
 
     cwr_func_body_expression body;
@@ -761,18 +1823,22 @@ cwr_return_statement cwr_parser_parse_return(cwr_parser *parser, cwr_expression_
 
     if (with_body)
     {
+        bool is_return_local = parser->is_return_local;
+        parser->is_return_local = true;
         body = cwr_parser_parse_function_body(parser);
-        if (parser->is_failed)
-        {
-            cwr_expression_destroy(value);
-            return (cwr_return_statement){};
-        }
+        parser->is_return_local = is_return_local;
+        CWR_PARSER_FAILED_AND_RETURN(parser, cwr_return_statement);
     }
 
+    // Nothing runs in the function after the call, so it can take the frame of the caller
+    bool is_tail_call = !with_body && !parser->is_return_local &&
+                        cwr_expression_pool_get(parser->pool, value)->type == cwr_expression_func_call_type;
+
     return (cwr_return_statement){
         .value = value,
         .body = body,
-        .with_body = with_body};
+        .with_body = with_body,
+        .is_tail_call = is_tail_call};
 }
 
 void cwr_parser_parse_function_body_by_created(cwr_parser *parser, cwr_func_body_expression *body)
@@ -780,12 +1846,15 @@ void cwr_parser_parse_function_body_by_created(cwr_parser *parser, cwr_func_body
     cwr_parser_match(parser, cwr_token_left_curly_type);
 
     cwr_location location = cwr_parser_current(parser).location;
+    size_t size = 0;
     parser->root = body;
 
     while (!cwr_parser_match(parser, cwr_token_right_curly_type))
     {
         if (cwr_parser_ended(parser))
         {
+            free(body->statements);
+            body->statements = NULL;
             cwr_parser_throw_error(parser, cwr_parser_error_except_token_type, "Except )", location);
             return;
         }
@@ -793,22 +1862,25 @@ void cwr_parser_parse_function_body_by_created(cwr_parser *parser, cwr_func_body
         cwr_statement statement = cwr_parser_parse_statement(parser);
         if (parser->is_failed)
         {
-            cwr_func_body_expression_destroy(*body);
+            free(body->statements);
+            body->statements = NULL;
             return;
         }
 
-        cwr_statement *buffer = realloc(body->statements, (body->count + 1) * sizeof(cwr_statement));
-        if (buffer == NULL)
+        if (!CWR_VECTOR_RESERVE(body->statements, size, body->count, 1))
         {
-            cwr_func_body_expression_destroy(*body);
-            cwr_statement_destroy(statement);
+            free(body->statements);
+            body->statements = NULL;
+            cwr_parser_throw_out_of_memory(parser, statement.location);
             return;
         }
 
-        body->statements = buffer;
         body->statements[body->count++] = statement;
     }
 
+    body->statements = cwr_parser_move_to_arena(parser, body->statements, body->count * sizeof(cwr_statement), location);
+    CWR_PARSER_FAILED_AND_RETURN_V(parser);
+
     cwr_parser_clear_scope(parser, body);
     parser->root = body->root;
 }
@@ -824,7 +1896,7 @@ cwr_func_body_expression cwr_parser_parse_function_body(cwr_parser *parser)
     return body;
 }
 
-cwr_expression_type_value cwr_parser_parse_type(cwr_parser *parser)
+const cwr_expression_type_value *cwr_parser_parse_type(cwr_parser *parser)
 {
     cwr_token current = cwr_parser_current(parser);
     cwr_parser_skip(parser);
@@ -849,259 +1921,34 @@ cwr_expression_type_value cwr_parser_parse_type(cwr_parser *parser)
         break;
     default:
         cwr_parser_throw_error(parser, cwr_parser_error_except_token_type, "Except type", current.location);
-        return (cwr_expression_type_value){};
+        return NULL;
     }
 
-    cwr_expression_type_value result = (cwr_expression_type_value){
+    const cwr_expression_type_value *result = cwr_type_intern((cwr_expression_type_value){
         .value_type = type,
         .identifier = identifier,
         .name = name,
-        .target_type = NULL};
-    return cwr_parser_parse_multidimensional_array(parser, result);
-}
-
-cwr_expression cwr_parser_parse_binary(cwr_parser *parser)
-{
-    cwr_expression left = cwr_parser_parse_multiplicative(parser);
-
-    while (true)
-    {
-        cwr_binary_operator_type type = cwr_binary_operator_type_from_token(cwr_parser_current(parser).type);
-
-        if (type == cwr_binary_operator_none_type)
-        {
-            break;
-        }
-
-        if (cwr_parser_peek(parser, 1, cwr_token_equals_type))
-        {
-            switch (type)
-            {
-            case cwr_binary_operator_equals_type:
-                type = cwr_binary_operator_equals_type;
-                break;
-            case cwr_binary_operator_negation_type:
-                type = cwr_binary_operator_not_equals_type;
-                break;
-            case cwr_binary_operator_greater_than_type:
-                type = cwr_binary_operator_greater_equals_than_type;
-                break;
-            case cwr_binary_operator_less_than_type:
-                type = cwr_binary_operator_less_equals_than_type;
-                break;
-            }
-
-            cwr_parser_skip(parser);
-        }
-        else
-        {
-            if (type == cwr_binary_operator_equals_type)
-            {
-                break;
-            }
-        }
-
-        cwr_parser_skip(parser);
-        cwr_expression right = cwr_parser_parse_binary(parser);
-
-        if (right.value_type.value_type != cwr_value_float_type && right.value_type.value_type != cwr_value_integer_type)
-        {
-            cwr_expression_destroy(left);
-            cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
-            return (cwr_expression){};
-        }
-
-        cwr_expression *children = malloc(sizeof(cwr_expression) * 2);
-        if (children == NULL)
-        {
-            cwr_expression_destroy(left);
-            cwr_expression_destroy(right);
-            cwr_parser_throw_out_of_memory(parser, left.location);
-            return (cwr_expression){};
-        }
-
-        children[0] = left;
-        children[1] = right;
-        if (parser->is_failed)
-        {
-            free(children);
-            cwr_expression_destroy(left);
-            cwr_expression_destroy(right);
-            return (cwr_expression){};
-        }
-
-        left = (cwr_expression){
-            .type = cwr_expression_binary_type,
-            .value_type = left.value_type,
-            .binary = (cwr_binary_expression){
-                .type = type,
-                .children = children}};
-
-        continue;
-    }
-
-    return left;
-}
-
-cwr_expression cwr_parser_parse_multiplicative(cwr_parser *parser)
-{
-    cwr_expression left = cwr_parser_parse_unary(parser, false);
-
-    while (true)
+        .target_type = NULL});
+    if (result == NULL)
     {
-        cwr_binary_operator_type type = cwr_binary_operator_type_from_token(cwr_parser_current(parser).type);
-
-        if (type != cwr_binary_operator_multiplicative_type && type != cwr_binary_operator_division_type)
-        {
-            break;
-        }
-
-        if (type != cwr_binary_operator_none_type)
-        {
-            cwr_parser_skip(parser);
-
-            cwr_expression right = cwr_parser_parse_binary(parser);
-            if (right.value_type.value_type != cwr_value_float_type && right.value_type.value_type != cwr_value_integer_type)
-            {
-                cwr_expression_destroy(left);
-                cwr_parser_throw_error(parser, cwr_parser_error_incorrect_type_type, "Incorrect type", cwr_parser_current(parser).location);
-                return (cwr_expression){};
-            }
-
-            cwr_expression *children = malloc(sizeof(cwr_expression) * 2);
-            if (children == NULL)
-            {
-                cwr_expression_destroy(left);
-                cwr_expression_destroy(right);
-                cwr_parser_throw_out_of_memory(parser, left.location);
-                return (cwr_expression){};
-            }
-
-            children[0] = left;
-            children[1] = right;
-            if (parser->is_failed)
-            {
-                free(children);
-                cwr_expression_destroy(left);
-                cwr_expression_destroy(right);
-                return (cwr_expression){};
-            }
-
-            left = (cwr_expression){
-                .type = cwr_expression_binary_type,
-                .value_type = left.value_type,
-                .binary = (cwr_binary_expression){
-                    .type = type,
-                    .children = children}};
-
-            continue;
-        }
-
-        break;
+        cwr_parser_throw_out_of_memory(parser, current.location);
+        return NULL;
     }
 
-    return left;
+    return cwr_parser_parse_multidimensional_array(parser, result);
 }
 
-cwr_expression cwr_parser_parse_unary(cwr_parser *parser, bool only_value)
+cwr_expression_index cwr_parser_parse_binary(cwr_parser *parser)
 {
-    cwr_binary_operator_type type = cwr_binary_operator_type_from_token(cwr_parser_current(parser).type);
-
-    if (type != cwr_binary_operator_none_type)
-    {
-        cwr_parser_skip(parser);
-
-        cwr_expression *child = malloc(sizeof(cwr_expression));
-        if (child == NULL)
-        {
-            cwr_parser_throw_out_of_memory(parser, cwr_parser_current(parser).location);
-            return (cwr_expression){};
-        }
-
-        cwr_expression value = cwr_parser_parse_unary(parser, only_value);
-        if (parser->is_failed)
-        {
-            free(child);
-            return (cwr_expression){};
-        }
-
-        cwr_expression_type_value type_value = value.value_type;
-        if (type == cwr_binary_operator_multiplicative_type)
-        {
-            if (only_value)
-            {
-                free(child);
-                return value;
-            }
-
-            type = cwr_binary_operator_dereference_type;
-            type_value = *type_value.target_type;
-        }
-        else if (type == cwr_binary_operator_dereference_type)
-        {
-            type_value = (cwr_expression_type_value){
-                .value_type = cwr_value_pointer_type,
-                .identifier = -1,
-                .name = NULL,
-                .target_type = &type_value,
-            };
-        }
-
-        *child = value;
-        return (cwr_expression){
-            .type = cwr_expression_unary_type,
-            .value_type = type_value,
-            .unary = (cwr_unary_expression){
-                .type = type,
-                .child = child}};
-    }
-
-    return cwr_parser_parse_array_element(parser);
+    return cwr_parser_parse_expression(parser, false, false);
 }
 
-cwr_expression cwr_parser_parse_array_element(cwr_parser *parser)
+cwr_expression_index cwr_parser_parse_unary(cwr_parser *parser, bool only_value)
 {
-    cwr_expression value = cwr_parser_parse_value(parser);
-
-    if (cwr_parser_match(parser, cwr_token_left_square_type))
-    {
-        cwr_expression index = cwr_parser_parse_binary(parser);
-        if (parser->is_failed)
-        {
-            cwr_expression_destroy(value);
-            return (cwr_expression){};
-        }
-
-        cwr_parser_except(parser, cwr_token_right_square_type);
-        if (parser->is_failed)
-        {
-            cwr_expression_destroy(value);
-            cwr_expression_destroy(index);
-            return (cwr_expression){};
-        }
-
-        cwr_expression *children = malloc(2 * sizeof(cwr_expression));
-        if (children == NULL)
-        {
-            cwr_expression_destroy(value);
-            cwr_expression_destroy(index);
-            cwr_parser_throw_out_of_memory(parser, value.location);
-            return (cwr_expression){};
-        }
-
-        children[0] = value;
-        children[1] = index;
-        return (cwr_expression){
-            .type = cwr_expression_array_element_type,
-            .value_type = cwr_expression_type_value_create_from_type(cwr_value_character_type),
-            .array_element = (cwr_array_element_expression){
-                .children = children}};
-    }
-
-    return value;
+    return cwr_parser_parse_expression(parser, true, only_value);
 }
 
-cwr_expression cwr_parser_parse_value(cwr_parser *parser)
+cwr_expression_index cwr_parser_parse_value(cwr_parser *parser)
 {
     cwr_token current = cwr_parser_current(parser);
     cwr_parser_skip(parser);
@@ -1115,32 +1962,36 @@ cwr_expression cwr_parser_parse_value(cwr_parser *parser)
             parser->position--;
 
             cwr_func_call_statement func_call = cwr_parser_parse_function_call(parser);
-            return (cwr_expression){
-                .type = cwr_expression_func_call_type,
-                .value_type = func_call.return_type,
-                .func_call = func_call};
+            CWR_PARSER_FAILED_AND_RETURN_INDEX(parser);
+
+            cwr_expression_index call = cwr_parser_add_expression(parser,
+                                                                  (cwr_expression){
+                                                                      .type = cwr_expression_func_call_type,
+                                                                      .func_call = func_call},
+                                                                  parser->functions[func_call.identifier].return_type, current.location);
+            CWR_PARSER_FAILED_AND_RETURN_INDEX(parser);
+
+            cwr_parser_add_expression_name(parser, call, current.value, current.location);
+            return call;
         }
 
         cwr_parser_variable variable;
         if (!cwr_parser_get_variable(parser, current.value, &variable))
         {
             cwr_parser_throw_error(parser, cwr_parser_error_unknown_variable_type, "Unknown variable", current.location);
-            return (cwr_expression){};
+            return CWR_EXPRESSION_INDEX_NONE;
         }
 
-        char *name = cwr_string_duplicate(current.value);
-        if (name == NULL)
-        {
-            cwr_parser_throw_out_of_memory(parser, current.location);
-            return (cwr_expression){};
-        }
+        cwr_expression_index var = cwr_parser_add_expression(parser,
+                                                             (cwr_expression){
+                                                                 .type = cwr_expression_var_type,
+                                                                 .var = (cwr_var_expression){
+                                                                     .identifier = variable.identifier}},
+                                                             variable.type, current.location);
+        CWR_PARSER_FAILED_AND_RETURN_INDEX(parser);
 
-        return (cwr_expression){
-            .type = cwr_expression_var_type,
-            .value_type = variable.type,
-            .var = (cwr_var_expression){
-                .identifier = variable.identifier,
-                .name = name}};
+        cwr_parser_add_expression_name(parser, var, current.value, current.location);
+        return var;
     }
     case cwr_token_number_type:
     {
@@ -1149,76 +2000,81 @@ cwr_expression cwr_parser_parse_value(cwr_parser *parser)
         // Check if number int or float
         if (value - ((int)value) > 0)
         {
-            return (cwr_expression){
-                .type = cwr_expression_float_type,
-                .value_type = cwr_expression_type_value_create_from_type(cwr_value_float_type),
-                .float_n = (cwr_float_expression){
-                    .value = value}};
+            return cwr_parser_add_expression(parser,
+                                             (cwr_expression){
+                                                 .type = cwr_expression_float_type,
+                                                 .float_n = (cwr_float_expression){
+                                                     .value = value}},
+                                             cwr_type_from(cwr_value_float_type), current.location);
         }
 
-        return (cwr_expression){
-            .type = cwr_expression_integer_type,
-            .value_type = cwr_expression_type_value_create_from_type(cwr_value_integer_type),
-            .integer_n = (cwr_integer_expression){
-                .value = value}};
+        return cwr_parser_add_expression(parser,
+                                         (cwr_expression){
+                                             .type = cwr_expression_integer_type,
+                                             .integer_n = (cwr_integer_expression){
+                                                 .value = value}},
+                                         cwr_type_from(cwr_value_integer_type), current.location);
     }
     case cwr_token_string_type:
     {
-        size_t count = strlen(current.value) + 1;
-        cwr_expression *content = malloc(count * sizeof(cwr_expression) + sizeof(cwr_expression));
+        size_t length = strlen(current.value) + 1;
+        uint32_t offset = cwr_expression_pool_add_string(parser->pool, current.value, length);
 
-        if (content == NULL)
+        if (offset == CWR_EXPRESSION_INDEX_NONE)
         {
             cwr_parser_throw_out_of_memory(parser, current.location);
-            return (cwr_expression){};
+            return CWR_EXPRESSION_INDEX_NONE;
         }
 
-        for (size_t i = 0; i < count; i++)
-        {
-            content[i] = (cwr_expression){
-                .type = cwr_expression_character_type,
-                .character = (cwr_character_expression){
-                    .value = current.value[i]}};
-        }
-        content[count] = (cwr_expression){
-            .type = cwr_expression_character_type,
-            .character = (cwr_character_expression){
-                .value = '\0'}};
-
-        cwr_expression_type_value *array_type = malloc(sizeof(cwr_expression_type_value));
-        *array_type = cwr_expression_type_value_create_from_type(cwr_value_character_type);
-        return (cwr_expression){
-            .type = cwr_expression_array_type,
-            .value_type = cwr_expression_type_value_create_array(array_type),
-            .array = (cwr_array_expression){
-                .type = *array_type,
-                .elements = content,
-                .count = count}};
-    }
-    case cwr_token_character_type:
-        return (cwr_expression){
-            .type = cwr_expression_character_type,
-            .value_type = cwr_expression_type_value_create_from_type(cwr_value_character_type),
-            .character = (cwr_character_expression){
-                .value = current.value[0]}};
-    case cwr_token_left_par_type:
-        cwr_expression binary = cwr_parser_parse_binary(parser);
-        cwr_parser_except(parser, cwr_token_right_par_type);
-        if (parser->is_failed)
+        const cwr_expression_type_value *array_type = cwr_type_array(cwr_type_from(cwr_value_character_type));
+        if (array_type == NULL)
         {
-            cwr_expression_destroy(binary);
-            return (cwr_expression){};
+            cwr_parser_throw_out_of_memory(parser, current.location);
+            return CWR_EXPRESSION_INDEX_NONE;
         }
 
-        return binary;
+        return cwr_parser_add_expression(parser,
+                                         (cwr_expression){
+                                             .type = cwr_expression_string_type,
+                                             .string = (cwr_string_expression){
+                                                 .offset = offset,
+                                                 .length = length}},
+                                         array_type, current.location);
+    }
+    case cwr_token_character_type:
+        return cwr_parser_add_expression(parser,
+                                         (cwr_expression){
+                                             .type = cwr_expression_character_type,
+                                             .character = (cwr_character_expression){
+                                                 .value = current.value[0]}},
+                                         cwr_type_from(cwr_value_character_type), current.location);
     default:
         cwr_parser_throw_error(parser, cwr_parser_error_except_value_type, "Except value", current.location);
-        return (cwr_expression){};
+        return CWR_EXPRESSION_INDEX_NONE;
     }
 }
 
-bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression *argument, size_t count, cwr_parser_function *function)
+bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression_index *argument, size_t count, cwr_parser_function *function)
 {
+    char key[CWR_PARSER_FUNCTION_KEY_SIZE];
+    size_t length = cwr_parser_function_key(parser, name, argument, count, key, sizeof(key));
+    size_t name_hash = 0;
+    size_t hash = 0;
+
+    if (length > 0)
+    {
+        size_t name_length = strlen(name) + 1;
+        name_hash = cwr_hash_bytes(key, name_length);
+        hash = cwr_hash_continue(name_hash, &key[name_length], length - name_length);
+
+        cwr_parser_function_cache_entry *entry = cwr_parser_function_cache_find(parser, key, length, name_hash, hash);
+        if (entry != NULL)
+        {
+            *function = parser->functions[entry->function];
+            return true;
+        }
+    }
+
     for (size_t i = 0; i < parser->functions_capacity; i++)
     {
         cwr_parser_function member = parser->functions[i];
@@ -1236,7 +2092,7 @@ bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression *arg
         bool breaked = false;
         for (size_t i = 0; i < count; i++)
         {
-            if (cwr_expression_type_value_equals(member.arguments[i].type, argument[i].value_type))
+            if (cwr_type_equals(member.arguments[i].type, cwr_expression_pool_type(parser->pool, argument[i])))
             {
                 continue;
             }
@@ -1250,6 +2106,12 @@ bool cwr_parser_get_function(cwr_parser *parser, char *name, cwr_expression *arg
             continue;
         }
 
+        // Cache is only a shortcut, so failing to fill it is not an error
+        if (length > 0)
+        {
+            cwr_parser_function_cache_add(parser, key, length, name_hash, hash, i);
+        }
+
         *function = member;
         return true;
     }
@@ -1352,16 +2214,13 @@ void cwr_parser_throw_error(cwr_parser *parser, cwr_parser_error_type type, char
 
 void cwr_parser_result_destroy(cwr_parser_result parser_result)
 {
-    cwr_nodes_list_destroy(parser_result.nodes_list);
-
-    if (parser_result.global_variables_count > 0)
-    {
-        free(parser_result.global_variables);
-    }
+    // Every statement, type and name lives in the arena, expressions in the pool
+    cwr_arena_destroy(parser_result.arena);
+    cwr_expression_pool_destroy(parser_result.nodes_list.pool);
 
-    if (parser_result.functions_count > 0)
+    if (parser_result.image != NULL)
     {
-        free(parser_result.functions);
+        munmap(parser_result.image, parser_result.image_size);
     }
 
     if (parser_result.is_failed)
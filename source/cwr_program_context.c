@@ -1,15 +1,26 @@
 #include <cwr_program_context.h>
 #include <cwr_scope.h>
+#include <cwr_stack.h>
+#include <cwr_quickening.h>
+#include <cwr_slab.h>
 
 cwr_program_context cwr_program_context_default()
 {
+    cwr_slab *slab = cwr_slab_create();
+
     return (cwr_program_context){
-        .functions = cwr_scope_create(),
-        .variables = cwr_scope_create()};
+        .functions = cwr_scope_create(slab),
+        .stack = cwr_stack_create(slab),
+        .quickening = cwr_quickening_create(),
+        .slab = slab,
+        .pool = NULL,
+        .lazy = NULL};
 }
 
 void cwr_program_context_destroy(cwr_program_context context)
 {
     cwr_scope_destroy(context.functions);
-    cwr_scope_destroy(context.variables);
+    cwr_stack_destroy(context.stack);
+    cwr_quickening_destroy(context.quickening);
+    cwr_slab_destroy(context.slab);
 }
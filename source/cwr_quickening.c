@@ -0,0 +1,37 @@
+#include <string.h>
+#include <cwr_quickening.h>
+#include <cwr_vector.h>
+
+cwr_quickening *cwr_quickening_create()
+{
+    return calloc(1, sizeof(cwr_quickening));
+}
+
+bool cwr_quickening_set(cwr_quickening *quickening, size_t index, cwr_quickened_expression expression)
+{
+    // Nodes added to the pool later start out not run
+    if (index >= quickening->size)
+    {
+        size_t size = quickening->size;
+        if (!CWR_VECTOR_RESERVE(quickening->expressions, quickening->size, size, index + 1 - size))
+        {
+            return false;
+        }
+
+        memset(&quickening->expressions[size], 0, (quickening->size - size) * sizeof(cwr_quickened_expression));
+    }
+
+    quickening->expressions[index] = expression;
+    return true;
+}
+
+void cwr_quickening_destroy(cwr_quickening *quickening)
+{
+    if (quickening == NULL)
+    {
+        return;
+    }
+
+    free(quickening->expressions);
+    free(quickening);
+}
\ No newline at end of file
@@ -7,9 +7,10 @@ typedef struct cwr_scope
     cwr_instance *instances;
     size_t size;
     size_t capacity;
+    cwr_slab *slab;
 } cwr_scope;
 
-cwr_scope *cwr_scope_create()
+cwr_scope *cwr_scope_create(cwr_slab *slab)
 {
     cwr_scope *scope = malloc(sizeof(cwr_scope));
     if (scope == NULL)
@@ -26,47 +27,48 @@ cwr_scope *cwr_scope_create()
 
     scope->size = CWR_SCOPE_DEFAULT_SIZE;
     scope->capacity = 0;
+    scope->slab = slab;
     return scope;
 }
 
 bool cwr_scope_add(cwr_scope *scope, cwr_instance instance)
 {
-    if (scope->capacity >= scope->size)
+    if (!CWR_VECTOR_RESERVE(scope->instances, scope->size, scope->capacity, 1))
     {
-        cwr_instance *instances = realloc(scope->instances, sizeof(cwr_instance) * scope->size * 2);
-        if (instances == NULL)
-        {
-            return false;
-        }
-
-        scope->size *= 2;
-        scope->instances = instances;
+        return false;
     }
 
     scope->instances[scope->capacity++] = instance;
     return true;
 }
 
-cwr_instance *cwr_scope_get(cwr_scope *scope, cwr_func_body_expression *root, size_t identifier)
+bool cwr_scope_set(cwr_scope *scope, size_t position, cwr_instance instance)
 {
-    for (int i = scope->capacity - 1; i >= 0; i--)
+    if (position >= scope->capacity)
     {
-        cwr_instance *instance = &scope->instances[i];
-        if (instance->identifier != identifier)
+        if (!CWR_VECTOR_RESERVE(scope->instances, scope->size, scope->capacity, position + 1 - scope->capacity))
         {
-            continue;
+            return false;
         }
 
-        if (!cwr_instance_can_access(*instance, root))
-        {
-            continue;
-        }
+        // Gaps are left by identifiers without an instance, they have no name so can't be found
+        memset(&scope->instances[scope->capacity], 0, (position + 1 - scope->capacity) * sizeof(cwr_instance));
+        scope->capacity = position + 1;
+    }
 
-        return instance;
+    cwr_instance *target = &scope->instances[position];
+    if (target->type == cwr_instance_variable_type)
+    {
+        cwr_tagged_value_remove_reference(scope->slab, &target->variable.value);
     }
 
-    // That cant happen because of parser checks
-    return NULL;
+    *target = instance;
+    return true;
+}
+
+cwr_instance *cwr_scope_at(cwr_scope *scope, size_t position)
+{
+    return &scope->instances[position];
 }
 
 cwr_instance *cwr_scope_get_by_name(cwr_scope *scope, cwr_func_body_expression *root, char *name)
@@ -74,7 +76,7 @@ cwr_instance *cwr_scope_get_by_name(cwr_scope *scope, cwr_func_body_expression *
     for (int i = scope->capacity - 1; i >= 0; i--)
     {
         cwr_instance *instance = &scope->instances[i];
-        if (strcmp(instance->name, name) != 0)
+        if (instance->name == NULL || strcmp(instance->name, name) != 0)
         {
             continue;
         }
@@ -95,28 +97,9 @@ void cwr_scope_destroy(cwr_scope *scope)
 {
     for (size_t i = 0; i < scope->capacity; i++)
     {
-        cwr_instance_destroy(scope->instances[i]);
+        cwr_instance_destroy(scope->slab, scope->instances[i]);
     }
 
     free(scope->instances);
     free(scope);
-}
-
-void cwr_scope_root_destroy(cwr_scope *scope, cwr_func_body_expression *root)
-{
-    for (int i = scope->capacity - 1; i >= 0; i--)
-    {
-        cwr_instance instance = scope->instances[i];
-        if (instance.root != root)
-        {
-            continue;
-        }
-
-        if (instance.type == cwr_instance_variable_type)
-        {
-            cwr_value_remove_reference(instance.variable.value);
-        }
-
-        scope->capacity--;
-    }
 }
\ No newline at end of file
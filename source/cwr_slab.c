@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <cwr_slab.h>
+
+typedef struct cwr_slab_block cwr_slab_block;
+
+// Header is two words, so chunks carved after it keep the alignment of malloc
+typedef struct cwr_slab_block
+{
+    cwr_slab_block *previous;
+    size_t used;
+    char data[];
+} cwr_slab_block;
+
+typedef struct cwr_slab_chunk cwr_slab_chunk;
+
+// Freed chunks hold the link to the next free one of their class
+typedef struct cwr_slab_chunk
+{
+    cwr_slab_chunk *next;
+} cwr_slab_chunk;
+
+typedef struct cwr_slab
+{
+    cwr_slab_block *block;
+    // Heads of the free lists by size class
+    cwr_slab_chunk *free_chunks[CWR_SLAB_CLASSES];
+    size_t allocated;
+} cwr_slab;
+
+// Sizes of 0 share the smallest class
+static size_t cwr_slab_class(size_t size)
+{
+    return size == 0 ? 0 : (size - 1) / CWR_SLAB_CLASS_SIZE;
+}
+
+cwr_slab *cwr_slab_create()
+{
+    return calloc(1, sizeof(cwr_slab));
+}
+
+void *cwr_slab_allocate(cwr_slab *slab, size_t size)
+{
+    size_t index = cwr_slab_class(size);
+    if (index >= CWR_SLAB_CLASSES)
+    {
+        return malloc(size);
+    }
+
+    cwr_slab_chunk *chunk = slab->free_chunks[index];
+    if (chunk != NULL)
+    {
+        slab->free_chunks[index] = chunk->next;
+        return chunk;
+    }
+
+    // The tail of a block too short for the chunk is left unused
+    size_t chunk_size = (index + 1) * CWR_SLAB_CLASS_SIZE;
+    cwr_slab_block *block = slab->block;
+    if (block == NULL || block->used + chunk_size > CWR_SLAB_BLOCK_SIZE)
+    {
+        block = malloc(sizeof(cwr_slab_block) + CWR_SLAB_BLOCK_SIZE);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+
+        block->previous = slab->block;
+        block->used = 0;
+
+        slab->block = block;
+        slab->allocated += CWR_SLAB_BLOCK_SIZE;
+    }
+
+    void *result = block->data + block->used;
+    block->used += chunk_size;
+    return result;
+}
+
+void cwr_slab_free(cwr_slab *slab, void *pointer, size_t size)
+{
+    if (pointer == NULL)
+    {
+        return;
+    }
+
+    size_t index = cwr_slab_class(size);
+    if (index >= CWR_SLAB_CLASSES)
+    {
+        free(pointer);
+        return;
+    }
+
+    cwr_slab_chunk *chunk = pointer;
+    chunk->next = slab->free_chunks[index];
+    slab->free_chunks[index] = chunk;
+}
+
+size_t cwr_slab_size(cwr_slab *slab)
+{
+    return slab->allocated;
+}
+
+void cwr_slab_destroy(cwr_slab *slab)
+{
+    if (slab == NULL)
+    {
+        return;
+    }
+
+    cwr_slab_block *block = slab->block;
+    while (block != NULL)
+    {
+        cwr_slab_block *previous = block->previous;
+
+        free(block);
+        block = previous;
+    }
+
+    free(slab);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <string.h>
+#include <cwr_stack.h>
+#include <cwr_vector.h>
+
+cwr_stack *cwr_stack_create(cwr_slab *slab)
+{
+    cwr_stack *stack = calloc(1, sizeof(cwr_stack));
+    if (stack == NULL)
+    {
+        return NULL;
+    }
+
+    stack->slab = slab;
+    stack->tail_call = -1;
+    stack->max_depth = SIZE_MAX;
+    return stack;
+}
+
+bool cwr_stack_push(cwr_stack *stack, size_t size, size_t *frame)
+{
+    if (!CWR_VECTOR_RESERVE(stack->slots, stack->size, stack->capacity, size) ||
+        !CWR_VECTOR_RESERVE(stack->frames, stack->frames_size, stack->frames_capacity, 1))
+    {
+        return false;
+    }
+
+    // Slots are still NULL when only empty frames were pushed
+    if (size > 0)
+    {
+        memset(&stack->slots[stack->capacity], 0, size * sizeof(cwr_tagged_value));
+    }
+
+    stack->frames[stack->frames_capacity++] = stack->capacity;
+
+    *frame = stack->capacity;
+    stack->capacity += size;
+    return true;
+}
+
+void cwr_stack_pop(cwr_stack *stack)
+{
+    size_t frame = stack->frames[--stack->frames_capacity];
+    for (size_t i = frame; i < stack->capacity; i++)
+    {
+        cwr_tagged_value_remove_reference(stack->slab, &stack->slots[i]);
+    }
+
+    stack->capacity = frame;
+}
+
+void cwr_stack_replace(cwr_stack *stack)
+{
+    size_t top = stack->frames[--stack->frames_capacity];
+    size_t frame = stack->frames[stack->frames_capacity - 1];
+    for (size_t i = frame; i < top; i++)
+    {
+        cwr_tagged_value_remove_reference(stack->slab, &stack->slots[i]);
+    }
+
+    size_t size = stack->capacity - top;
+    memmove(&stack->slots[frame], &stack->slots[top], size * sizeof(cwr_tagged_value));
+    stack->capacity = frame + size;
+}
+
+void cwr_stack_destroy(cwr_stack *stack)
+{
+    if (stack == NULL)
+    {
+        return;
+    }
+
+    while (stack->frames_capacity > 0)
+    {
+        cwr_stack_pop(stack);
+    }
+
+    free(stack->slots);
+    free(stack->frames);
+    free(stack);
+}
\ No newline at end of file
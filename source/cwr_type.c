@@ -0,0 +1,204 @@
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <cwr_type.h>
+#include <cwr_hash.h>
+#include <cwr_arena.h>
+
+#define CWR_TYPE_SCALARS (cwr_value_void_type + 1)
+
+#define CWR_TYPE_SCALAR(type, value_identifier) \
+    {                                           \
+        .value_type = type,                     \
+        .identifier = value_identifier,         \
+        .name = NULL,                           \
+        .target_type = NULL}
+
+// Composite and named types, open addressing over interned pointers
+typedef struct cwr_type_table
+{
+    pthread_mutex_t lock;
+    cwr_arena *arena;
+    const cwr_expression_type_value **types;
+    size_t types_size;
+    size_t types_capacity;
+} cwr_type_table;
+
+static const cwr_expression_type_value cwr_type_literals[CWR_TYPE_SCALARS] = {
+    CWR_TYPE_SCALAR(cwr_value_character_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_float_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_integer_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_structure_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_array_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_pointer_type, 0),
+    CWR_TYPE_SCALAR(cwr_value_void_type, 0)};
+
+static const cwr_expression_type_value cwr_type_declared[CWR_TYPE_SCALARS] = {
+    CWR_TYPE_SCALAR(cwr_value_character_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_float_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_integer_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_structure_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_array_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_pointer_type, -1),
+    CWR_TYPE_SCALAR(cwr_value_void_type, -1)};
+
+static cwr_type_table cwr_type_table_instance = (cwr_type_table){
+    .lock = PTHREAD_MUTEX_INITIALIZER};
+
+static size_t cwr_type_hash(cwr_expression_type_value type)
+{
+    size_t hash = cwr_hash_bytes(&type.value_type, sizeof(type.value_type));
+    hash = cwr_hash_continue(hash, &type.identifier, sizeof(type.identifier));
+    hash = cwr_hash_continue(hash, &type.target_type, sizeof(type.target_type));
+
+    if (type.name != NULL)
+    {
+        hash = cwr_hash_continue(hash, type.name, strlen(type.name));
+    }
+
+    return hash;
+}
+
+// Targets are interned, so comparing their pointers compares the whole chain
+static bool cwr_type_is_same(const cwr_expression_type_value *interned, cwr_expression_type_value type)
+{
+    if (interned->value_type != type.value_type || interned->identifier != type.identifier || interned->target_type != type.target_type)
+    {
+        return false;
+    }
+
+    if (interned->name == NULL || type.name == NULL)
+    {
+        return interned->name == type.name;
+    }
+
+    return strcmp(interned->name, type.name) == 0;
+}
+
+static bool cwr_type_table_grow(cwr_type_table *table)
+{
+    size_t size = table->types_size == 0 ? CWR_TYPE_TABLE_DEFAULT_SIZE : table->types_size * 2;
+
+    const cwr_expression_type_value **types = calloc(size, sizeof(cwr_expression_type_value *));
+    if (types == NULL)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < table->types_size; i++)
+    {
+        const cwr_expression_type_value *type = table->types[i];
+        if (type == NULL)
+        {
+            continue;
+        }
+
+        size_t position = cwr_type_hash(*type) & (size - 1);
+        while (types[position] != NULL)
+        {
+            position = (position + 1) & (size - 1);
+        }
+
+        types[position] = type;
+    }
+
+    free(table->types);
+    table->types = types;
+    table->types_size = size;
+    return true;
+}
+
+static const cwr_expression_type_value *cwr_type_table_add(cwr_type_table *table, cwr_expression_type_value type)
+{
+    if (table->arena == NULL)
+    {
+        table->arena = cwr_arena_create();
+        if (table->arena == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    if ((table->types_capacity + 1) * 2 > table->types_size && !cwr_type_table_grow(table))
+    {
+        return NULL;
+    }
+
+    size_t position = cwr_type_hash(type) & (table->types_size - 1);
+    while (table->types[position] != NULL)
+    {
+        if (cwr_type_is_same(table->types[position], type))
+        {
+            return table->types[position];
+        }
+
+        position = (position + 1) & (table->types_size - 1);
+    }
+
+    cwr_expression_type_value *interned = cwr_arena_allocate(table->arena, sizeof(cwr_expression_type_value));
+    if (interned == NULL)
+    {
+        return NULL;
+    }
+
+    *interned = type;
+    if (type.name != NULL)
+    {
+        interned->name = cwr_arena_duplicate(table->arena, type.name);
+        if (interned->name == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    table->types[position] = interned;
+    table->types_capacity++;
+    return interned;
+}
+
+const cwr_expression_type_value *cwr_type_intern(cwr_expression_type_value type)
+{
+    if (type.name == NULL && type.target_type == NULL && type.value_type < CWR_TYPE_SCALARS)
+    {
+        if (type.identifier == 0)
+        {
+            return &cwr_type_literals[type.value_type];
+        }
+
+        if (type.identifier == -1)
+        {
+            return &cwr_type_declared[type.value_type];
+        }
+    }
+
+    cwr_type_table *table = &cwr_type_table_instance;
+
+    pthread_mutex_lock(&table->lock);
+    const cwr_expression_type_value *result = cwr_type_table_add(table, type);
+    pthread_mutex_unlock(&table->lock);
+
+    return result;
+}
+
+const cwr_expression_type_value *cwr_type_from(cwr_value_type value_type)
+{
+    return &cwr_type_literals[value_type];
+}
+
+const cwr_expression_type_value *cwr_type_pointer(const cwr_expression_type_value *target)
+{
+    return cwr_type_intern((cwr_expression_type_value){
+        .value_type = cwr_value_pointer_type,
+        .identifier = -1,
+        .name = NULL,
+        .target_type = target});
+}
+
+const cwr_expression_type_value *cwr_type_array(const cwr_expression_type_value *target)
+{
+    return cwr_type_intern((cwr_expression_type_value){
+        .value_type = cwr_value_array_type,
+        .identifier = -1,
+        .name = NULL,
+        .target_type = target});
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <cwr_walker.h>
+#include <cwr_vector.h>
+
+typedef struct cwr_walker_expression_entry
+{
+    cwr_expression_index index;
+    bool is_expanded;
+} cwr_walker_expression_entry;
+
+typedef struct cwr_walker_statement_entry
+{
+    cwr_statement *statement;
+    cwr_func_body_expression *body;
+    bool is_expanded;
+} cwr_walker_statement_entry;
+
+typedef struct cwr_walker
+{
+    cwr_walker_expression_entry *expressions;
+    size_t expressions_size;
+    size_t expressions_capacity;
+    cwr_walker_statement_entry *statements;
+    size_t statements_size;
+    size_t statements_capacity;
+} cwr_walker;
+
+static bool cwr_walker_push_expression(cwr_walker *walker, cwr_expression_index index, bool is_expanded)
+{
+    if (!CWR_VECTOR_RESERVE(walker->expressions, walker->expressions_size, walker->expressions_capacity, 1))
+    {
+        return false;
+    }
+
+    walker->expressions[walker->expressions_capacity++] = (cwr_walker_expression_entry){
+        .index = index,
+        .is_expanded = is_expanded};
+    return true;
+}
+
+static bool cwr_walker_push_statement(cwr_walker *walker, cwr_statement *statement, cwr_func_body_expression *body, bool is_expanded)
+{
+    if (!CWR_VECTOR_RESERVE(walker->statements, walker->statements_size, walker->statements_capacity, 1))
+    {
+        return false;
+    }
+
+    walker->statements[walker->statements_capacity++] = (cwr_walker_statement_entry){
+        .statement = statement,
+        .body = body,
+        .is_expanded = is_expanded};
+    return true;
+}
+
+// Pushed in reverse, so the first statement is on top
+static bool cwr_walker_push_body(cwr_walker *walker, cwr_func_body_expression *body)
+{
+    for (size_t i = body->count; i > 0; i--)
+    {
+        if (!cwr_walker_push_statement(walker, &body->statements[i - 1], body, false))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool cwr_walker_push_children(cwr_walker *walker, cwr_statement *statement)
+{
+    switch (statement->type)
+    {
+    case cwr_statement_func_decl_type:
+        return !statement->func_decl.with_body || cwr_walker_push_body(walker, &statement->func_decl.func_body);
+    case cwr_statement_if_type:
+        return cwr_walker_push_body(walker, &statement->if_stat.body);
+    case cwr_statement_return_type:
+        return !statement->ret.with_body || cwr_walker_push_body(walker, &statement->ret.body);
+    case cwr_statement_for_loop_type:
+        if (statement->for_loop.with_body && !cwr_walker_push_body(walker, &statement->for_loop.body))
+        {
+            return false;
+        }
+
+        return !statement->for_loop.with_statement || cwr_walker_push_statement(walker, statement->for_loop.statement, NULL, false);
+    default:
+        return true;
+    }
+}
+
+cwr_walker *cwr_walker_create()
+{
+    return calloc(1, sizeof(cwr_walker));
+}
+
+bool cwr_walker_walk_expression(cwr_walker *walker, cwr_expression_pool *pool, cwr_expression_index root, cwr_walker_expression_visitor visitor, void *context)
+{
+    size_t base = walker->expressions_capacity;
+    bool result = cwr_walker_push_expression(walker, root, false);
+
+    while (result && walker->expressions_capacity > base)
+    {
+        cwr_walker_expression_entry entry = walker->expressions[--walker->expressions_capacity];
+        if (entry.is_expanded)
+        {
+            result = visitor(pool, entry.index, context);
+            continue;
+        }
+
+        result = cwr_walker_push_expression(walker, entry.index, true);
+
+        // Children are pushed last to first
+        cwr_expression expression = *cwr_expression_pool_get(pool, entry.index);
+        switch (expression.type)
+        {
+        case cwr_expression_binary_type:
+            result = result && cwr_walker_push_expression(walker, expression.binary.children[1], false);
+            result = result && cwr_walker_push_expression(walker, expression.binary.children[0], false);
+            break;
+        case cwr_expression_array_element_type:
+            result = result && cwr_walker_push_expression(walker, expression.array_element.children[1], false);
+            result = result && cwr_walker_push_expression(walker, expression.array_element.children[0], false);
+            break;
+        case cwr_expression_unary_type:
+            result = result && cwr_walker_push_expression(walker, expression.unary.child, false);
+            break;
+        case cwr_expression_func_call_type:
+            for (size_t i = expression.func_call.count; result && i > 0; i--)
+            {
+                result = cwr_walker_push_expression(walker, cwr_expression_pool_argument(pool, expression.func_call.arguments, i - 1), false);
+            }
+
+            break;
+        default:
+            break;
+        }
+    }
+
+    walker->expressions_capacity = base;
+    return result;
+}
+
+bool cwr_walker_walk_statements(cwr_walker *walker, cwr_statement *statements, size_t count, cwr_func_body_expression *body, cwr_walker_statement_visitor visitor, void *context)
+{
+    size_t base = walker->statements_capacity;
+    bool result = true;
+
+    for (size_t i = count; result && i > 0; i--)
+    {
+        result = cwr_walker_push_statement(walker, &statements[i - 1], body, false);
+    }
+
+    while (result && walker->statements_capacity > base)
+    {
+        cwr_walker_statement_entry entry = walker->statements[--walker->statements_capacity];
+        if (entry.is_expanded)
+        {
+            result = visitor(entry.statement, entry.body, context);
+            continue;
+        }
+
+        result = cwr_walker_push_statement(walker, entry.statement, entry.body, true) && cwr_walker_push_children(walker, entry.statement);
+    }
+
+    walker->statements_capacity = base;
+    return result;
+}
+
+bool cwr_walker_walk_statement_expressions(cwr_walker *walker, cwr_expression_pool *pool, cwr_statement *statement, cwr_walker_expression_visitor visitor, void *context)
+{
+    switch (statement->type)
+    {
+    case cwr_statement_var_decl_type:
+        return cwr_walker_walk_expression(walker, pool, statement->var_decl.value, visitor, context);
+    case cwr_statement_assign_type:
+        return cwr_walker_walk_expression(walker, pool, statement->assign.identifier, visitor, context) &&
+               cwr_walker_walk_expression(walker, pool, statement->assign.value, visitor, context);
+    case cwr_statement_func_call_type:
+        for (size_t i = 0; i < statement->func_call.count; i++)
+        {
+            if (!cwr_walker_walk_expression(walker, pool, cwr_expression_pool_argument(pool, statement->func_call.arguments, i), visitor, context))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    case cwr_statement_for_loop_type:
+        if (statement->for_loop.with_variable && !cwr_walker_walk_expression(walker, pool, statement->for_loop.variable.value, visitor, context))
+        {
+            return false;
+        }
+
+        return !statement->for_loop.with_condition || cwr_walker_walk_expression(walker, pool, statement->for_loop.condition, visitor, context);
+    case cwr_statement_if_type:
+        return cwr_walker_walk_expression(walker, pool, statement->if_stat.condition, visitor, context);
+    case cwr_statement_return_type:
+        return cwr_walker_walk_expression(walker, pool, statement->ret.value, visitor, context);
+    default:
+        return true;
+    }
+}
+
+void cwr_walker_destroy(cwr_walker *walker)
+{
+    if (walker == NULL)
+    {
+        return;
+    }
+
+    free(walker->expressions);
+    free(walker->statements);
+    free(walker);
+}
\ No newline at end of file
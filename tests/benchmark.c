@@ -0,0 +1,310 @@
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <cwr_interpreter.h>
+#include <cwr_optimizer.h>
+#include <cwr_cache.h>
+#include "cwr_test.h"
+
+// Figures quoted by the history, built like the tests with -O2 and run as 'benchmark <case>'
+#define BENCHMARK_RUNS 5
+
+static size_t benchmark_mallocs = 0;
+static size_t benchmark_reallocs = 0;
+
+#ifdef __GLIBC__
+// Counts every allocation of the program, the parser threads included
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) {
+    __atomic_fetch_add(&benchmark_mallocs, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&benchmark_mallocs, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    __atomic_fetch_add(&benchmark_reallocs, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(pointer, size);
+}
+#endif
+
+static double benchmark_now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+}
+
+// 'head', then 'count' times 'body' with '%d' replaced by the repetition, then 'tail'
+static char* benchmark_source(const char* head, const char* body, size_t count, const char* tail) {
+    size_t length = strlen(head) + strlen(tail) + 1;
+    for (size_t i = 0; i < count; i++) {
+        length += snprintf(NULL, 0, body, (int)i);
+    }
+
+    char* source = malloc(length);
+    char* end = stpcpy(source, head);
+    for (size_t i = 0; i < count; i++) {
+        end += sprintf(end, body, (int)i);
+    }
+
+    strcpy(end, tail);
+    return source;
+}
+
+typedef struct benchmark_tokens {
+    cwr_lexer* lexer;
+    cwr_preprocessor* preprocessor;
+    cwr_tokens_list tokens_list;
+} benchmark_tokens;
+
+static benchmark_tokens benchmark_tokenize(char* source) {
+    benchmark_tokens tokens = {0};
+    cwr_lexer_configuration configuration = cwr_lexer_configuration_default();
+    tokens.lexer = cwr_lexer_create("console", source, &configuration);
+    tokens.preprocessor = cwr_preprocessor_create(cwr_lexer_tokenize(tokens.lexer));
+    tokens.tokens_list = cwr_preprocessor_run(tokens.preprocessor).tokens_list;
+    return tokens;
+}
+
+static void benchmark_tokens_destroy(benchmark_tokens tokens) {
+    cwr_tokens_list_destroy(tokens.tokens_list);
+    cwr_lexer_destroy(tokens.lexer);
+    cwr_preprocessor_destroy(tokens.preprocessor);
+}
+
+// Best time of the runs parsing 'tokens', allocations are those of the last run
+static double benchmark_parse(benchmark_tokens tokens, cwr_parser_configuration configuration) {
+    double best = 0;
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        benchmark_mallocs = 0;
+        benchmark_reallocs = 0;
+        double start = benchmark_now();
+        cwr_parser* parser = cwr_parser_create(tokens.tokens_list, &configuration);
+        cwr_parser_result result = cwr_parser_parse(parser);
+        double time = benchmark_now() - start;
+        CWR_TEST_CHECK(!result.is_failed);
+
+        cwr_parser_result_destroy(result);
+        cwr_parser_destroy(parser);
+        best = run == 0 || time < best ? time : best;
+    }
+
+    return best;
+}
+
+// [user-030] A main of 100000 calls grows the parser's vectors geometrically
+static void benchmark_parse_calls() {
+    char* source = benchmark_source("void f(int a) { } int main() { ", "f(%d); ", 100000, "return 0; }");
+    benchmark_tokens tokens = benchmark_tokenize(source);
+
+    double time = benchmark_parse(tokens, cwr_parser_configuration_default());
+    size_t reallocs = benchmark_reallocs;
+    printf("parse_calls: %zu reallocs, %.1f ms\n", reallocs, time);
+
+    benchmark_tokens_destroy(tokens);
+    free(source);
+}
+
+// [user-037] 30000 functions parsed on one thread and on several, CPU time counts every thread
+static void benchmark_parse_threads() {
+    char* source = cwr_test_functions_source(30000, NULL);
+    benchmark_tokens tokens = benchmark_tokenize(source);
+
+    size_t thread_counts[] = {1, 2, 4};
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        cwr_parser_configuration configuration = cwr_parser_configuration_default();
+        configuration.threads = thread_counts[i];
+
+        clock_t start = clock();
+        double time = benchmark_parse(tokens, configuration);
+        double cpu = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / BENCHMARK_RUNS;
+        printf("parse_threads: %zu threads, best %.1f ms, %.1f ms of CPU per run\n", thread_counts[i], time, cpu);
+    }
+
+    benchmark_tokens_destroy(tokens);
+    free(source);
+}
+
+// [user-039] 3000 functions loaded from the cache and built from their source
+static void benchmark_cache_load() {
+    char directory[] = "/tmp/cwr_benchmark_XXXXXX";
+    if (mkdtemp(directory) == NULL) {
+        CWR_TEST_CHECK(false);
+        return;
+    }
+
+    cwr_cache* cache = cwr_cache_create(directory);
+    char* source = cwr_test_functions_source(3000, NULL);
+    size_t key = cwr_cache_key("console", source, strlen(source));
+
+    double build = 0;
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        double start = benchmark_now();
+        cwr_test_program program = cwr_test_parse(source, cwr_parser_configuration_default());
+        cwr_optimizer_configuration configuration = cwr_optimizer_configuration_default();
+        cwr_optimizer_optimize(&program.result, &configuration);
+        double time = benchmark_now() - start;
+
+        CWR_TEST_CHECK(!program.result.is_failed);
+        if (run == 0) {
+            CWR_TEST_CHECK(cwr_cache_store(cache, key, &program.result));
+        }
+
+        cwr_test_program_destroy(program);
+        build = run == 0 || time < build ? time : build;
+    }
+
+    double load = 0;
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        cwr_parser_result result;
+        double start = benchmark_now();
+        bool is_loaded = cwr_cache_load(cache, key, &result);
+        double time = benchmark_now() - start;
+
+        CWR_TEST_CHECK(is_loaded);
+        if (is_loaded) {
+            cwr_parser_result_destroy(result);
+        }
+
+        load = run == 0 || time < load ? time : load;
+    }
+
+    printf("cache_load: %.1f ms to load, %.1f ms to lex, parse and optimize\n", load, build);
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%016zx%s", directory, key, CWR_CACHE_EXTENSION);
+    unlink(path);
+    rmdir(directory);
+    cwr_cache_destroy(cache);
+    free(source);
+}
+
+// Best time of the runs lexing, parsing, optimizing and running 'source' on 'engine'
+static double benchmark_run(char* source, cwr_interpreter_engine_type engine) {
+    double best = 0;
+    for (int run = 0; run < BENCHMARK_RUNS; run++) {
+        double start = benchmark_now();
+        cwr_test_program program = cwr_test_parse(source, cwr_parser_configuration_default());
+        CWR_TEST_CHECK(!program.result.is_failed);
+        cwr_optimizer_configuration optimizer_configuration = cwr_optimizer_configuration_default();
+        cwr_optimizer_optimize(&program.result, &optimizer_configuration);
+
+        cwr_interpreter_configuration configuration = cwr_interpreter_configuration_default();
+        configuration.engine = engine;
+        cwr_interpreter* interpreter = cwr_intepreter_create(program.result, &configuration);
+        cwr_interpreter_error error = {.is_failed = false};
+        cwr_interpreter_result result = cwr_intepreter_interpret(interpreter, &error);
+        if (!error.is_failed) {
+            cwr_value* value = cwr_interpreter_evaluate_entry_point(result, &error);
+            cwr_value_instance_destroy(result.context.slab, value);
+        }
+
+        double time = benchmark_now() - start;
+        CWR_TEST_CHECK(!error.is_failed);
+
+        cwr_interpreter_result_destroy(result);
+        cwr_intepreter_destroy(interpreter);
+        cwr_test_program_destroy(program);
+        best = run == 0 || time < best ? time : best;
+    }
+
+    return best;
+}
+
+static void benchmark_engines(const char* name, char* source) {
+    double tree = benchmark_run(source, cwr_interpreter_engine_tree_type);
+    double bytecode = benchmark_run(source, cwr_interpreter_engine_bytecode_type);
+    printf("%s: tree %.1f ms, bytecode %.1f ms, %.1fx\n", name, tree, bytecode, tree / bytecode);
+}
+
+// [user-041] A numeric loop and a recursive call tree on both engines, parsing included
+static void benchmark_engines_loop() {
+    benchmark_engines("engines_loop",
+        "int main() {\n"
+        "    int sum = 0;\n"
+        "    float acc = 0.5;\n"
+        "    for (int j = 0; j < 3000000; j = j + 1) {\n"
+        "        sum = sum + j * 2 - j;\n"
+        "        if (sum > 1000000) { sum = sum - 1000000; }\n"
+        "        acc = acc * 0.5 + 1;\n"
+        "    }\n"
+        "    return sum;\n"
+        "}\n");
+}
+
+static void benchmark_engines_fib() {
+    benchmark_engines("engines_fib",
+        "int fib(int n) { if (n < 2) { return 1; } return fib(n - 1) + fib(n - 2); }\n"
+        "int main() { return fib(25); }\n");
+}
+
+// Allocations while main runs, parsing and compiling excluded
+static size_t benchmark_run_allocations(char* source, cwr_interpreter_engine_type engine) {
+    cwr_test_program program = cwr_test_parse(source, cwr_parser_configuration_default());
+    CWR_TEST_CHECK(!program.result.is_failed);
+
+    cwr_interpreter_configuration configuration = cwr_interpreter_configuration_default();
+    configuration.engine = engine;
+    cwr_interpreter* interpreter = cwr_intepreter_create(program.result, &configuration);
+    cwr_interpreter_error error = {.is_failed = false};
+    cwr_interpreter_result result = cwr_intepreter_interpret(interpreter, &error);
+
+    benchmark_mallocs = 0;
+    if (!error.is_failed) {
+        cwr_value* value = cwr_interpreter_evaluate_entry_point(result, &error);
+        cwr_value_instance_destroy(result.context.slab, value);
+    }
+
+    size_t mallocs = benchmark_mallocs;
+    CWR_TEST_CHECK(!error.is_failed);
+
+    cwr_interpreter_result_destroy(result);
+    cwr_intepreter_destroy(interpreter);
+    cwr_test_program_destroy(program);
+    return mallocs;
+}
+
+// [user-048] Script calls make no heap allocation, so fib(25) allocates as much as fib(20)
+static void benchmark_call_allocations() {
+    char* fib20 = "int fib(int n) { if (n < 2) { return 1; } return fib(n - 1) + fib(n - 2); }\n"
+                  "int main() { return fib(20); }\n";
+    char* fib25 = "int fib(int n) { if (n < 2) { return 1; } return fib(n - 1) + fib(n - 2); }\n"
+                  "int main() { return fib(25); }\n";
+
+    printf("call_allocations: tree fib(20) %zu, fib(25) %zu mallocs\n",
+           benchmark_run_allocations(fib20, cwr_interpreter_engine_tree_type),
+           benchmark_run_allocations(fib25, cwr_interpreter_engine_tree_type));
+    printf("call_allocations: bytecode fib(20) %zu, fib(25) %zu mallocs\n",
+           benchmark_run_allocations(fib20, cwr_interpreter_engine_bytecode_type),
+           benchmark_run_allocations(fib25, cwr_interpreter_engine_bytecode_type));
+}
+
+typedef struct benchmark_case {
+    const char* name;
+    void (*run)();
+} benchmark_case;
+
+static const benchmark_case cases[] = {
+    {"parse_calls", benchmark_parse_calls},
+    {"parse_threads", benchmark_parse_threads},
+    {"cache_load", benchmark_cache_load},
+    {"engines_loop", benchmark_engines_loop},
+    {"engines_fib", benchmark_engines_fib},
+    {"call_allocations", benchmark_call_allocations},
+};
+
+int main(int count, char** arguments) {
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (count < 2 || strcmp(arguments[1], cases[i].name) == 0) {
+            cases[i].run();
+        }
+    }
+
+    return cwr_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef CWR_TEST_H
+#define CWR_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include <cwr_parser.h>
+#include <cwr_preprocessor.h>
+#include <cwr_lexer.h>
+
+// Every test is a program of its own, built like tests/main.c from all of source/, and exits with its failed checks count
+static int cwr_test_failures = 0;
+
+#define CWR_TEST_CHECK(condition)                                                           \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+            cwr_test_failures++;                                                            \
+        }                                                                                   \
+    } while (0)
+
+typedef struct cwr_test_program {
+    cwr_lexer* lexer;
+    cwr_preprocessor* preprocessor;
+    cwr_parser* parser;
+    cwr_tokens_list tokens_list;
+    cwr_parser_result result;
+} cwr_test_program;
+
+// Runs the lexer, preprocessor and parser over 'source' as tests/main.c does, a failed parse is in the result
+static cwr_test_program cwr_test_parse(char* source, cwr_parser_configuration configuration) {
+    cwr_test_program program = {0};
+    cwr_lexer_configuration lexer_configuration = cwr_lexer_configuration_default();
+    program.lexer = cwr_lexer_create("console", source, &lexer_configuration);
+
+    program.preprocessor = cwr_preprocessor_create(cwr_lexer_tokenize(program.lexer));
+    cwr_preprocessor_result pr_result = cwr_preprocessor_run(program.preprocessor);
+    program.tokens_list = pr_result.tokens_list;
+    if (pr_result.is_failed) {
+        program.result.is_failed = true;
+        return program;
+    }
+
+    program.parser = cwr_parser_create(program.tokens_list, &configuration);
+    program.result = cwr_parser_parse(program.parser);
+    return program;
+}
+
+// 'count' functions of five kinds with loops, branches, strings and calls to earlier functions,
+// 'error' is placed in a body in the middle
+static char* cwr_test_functions_source(size_t count, const char* error) {
+    char* source;
+    size_t length;
+    FILE* stream = open_memstream(&source, &length);
+    fprintf(stream, "#include <stdio.h>\n");
+
+    for (size_t i = 0; i < count; i++) {
+        size_t earlier = i / 2 - i / 2 % 5;
+        switch (i % 5) {
+        case 0:
+            fprintf(stream, "int f%zu(int a, int b) { int s = a + b * %zu; for (int j = 0; j < 3; j = j + 1) { s = s + j; if (s > 10) { int t = s - 1; s = t; } } return s; }\n", i, i);
+            break;
+        case 1:
+            if (i > 5) {
+                fprintf(stream, "int f%zu(int a) { int r = f%zu(a, %zu) + f%zu(a - 1); return r + (2 * (a - 1)); }\n", i, earlier, i, i - 3);
+            } else {
+                fprintf(stream, "int f%zu(int a) { int r = f%zu(a, %zu); return r + (2 * (a - 1)); }\n", i, earlier, i);
+            }
+            break;
+        case 2:
+            fprintf(stream, "float f%zu(float x) { float y = x * 2.5; if (y > 1) { return y; } return -y; }\n", i);
+            break;
+        case 3:
+            fprintf(stream, "int f%zu(int n) { %s if (n < 2) { return n; } return f%zu(n - 1) + 1; }\n", i, i / 5 == count / 10 && error ? error : "", i);
+            break;
+        default:
+            fprintf(stream, "char f%zu() { char* s = \"str%zu\"; return s[1]; }\n", i, i);
+            break;
+        }
+    }
+
+    fprintf(stream, "int main() { int x = 3; printf(f1(x)); printf(\"done\"); return 0; }\n");
+    fclose(stream);
+    return source;
+}
+
+static void cwr_test_program_destroy(cwr_test_program program) {
+    if (program.parser) {
+        cwr_parser_result_destroy(program.result);
+        cwr_parser_destroy(program.parser);
+    }
+
+    cwr_tokens_list_destroy(program.tokens_list);
+    cwr_lexer_destroy(program.lexer);
+    cwr_preprocessor_destroy(program.preprocessor);
+}
+
+#endif // CWR_TEST_H
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <cwr_interpreter.h>
+#include <cwr_optimizer.h>
+#include "cwr_test.h"
+
+typedef struct engine_run {
+    char* source;
+    cwr_interpreter_engine_type engine;
+    // Printed by the script, kept only when asked for
+    bool is_capturing;
+    char* output;
+    bool is_failed;
+    cwr_interpreter_error_type error_type;
+    int value;
+} engine_run;
+
+// Points stdout at a temporary file until 'engine_capture_end' reads it back
+static int engine_capture_begin(FILE** capture) {
+    fflush(stdout);
+    *capture = tmpfile();
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(*capture), STDOUT_FILENO);
+    return saved;
+}
+
+static char* engine_capture_end(FILE* capture, int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    long size = ftell(capture);
+    char* output = malloc(size + 1);
+    fseek(capture, 0, SEEK_SET);
+    output[fread(output, 1, size, capture)] = '\0';
+    fclose(capture);
+    return output;
+}
+
+// Parses, optimizes and runs the source as tests/main.c does, keeping the integer returned by main
+static void* engine_run_source(void* argument) {
+    engine_run* run = argument;
+    cwr_test_program program = cwr_test_parse(run->source, cwr_parser_configuration_default());
+    CWR_TEST_CHECK(!program.result.is_failed);
+    if (program.result.is_failed) {
+        run->is_failed = true;
+        cwr_test_program_destroy(program);
+        return NULL;
+    }
+
+    cwr_optimizer_configuration optimizer_configuration = cwr_optimizer_configuration_default();
+    cwr_optimizer_optimize(&program.result, &optimizer_configuration);
+
+    FILE* capture = NULL;
+    int saved = run->is_capturing ? engine_capture_begin(&capture) : -1;
+
+    cwr_interpreter_configuration configuration = cwr_interpreter_configuration_default();
+    configuration.engine = run->engine;
+    cwr_interpreter* interpreter = cwr_intepreter_create(program.result, &configuration);
+    cwr_interpreter_error error = {.is_failed = false};
+    cwr_interpreter_result result = cwr_intepreter_interpret(interpreter, &error);
+
+    if (!error.is_failed) {
+        cwr_value* value = cwr_interpreter_evaluate_entry_point(result, &error);
+        if (!error.is_failed && value) {
+            run->value = value->integer_n;
+            cwr_value_instance_destroy(result.context.slab, value);
+        }
+    }
+
+    if (run->is_capturing) {
+        run->output = engine_capture_end(capture, saved);
+    }
+
+    run->is_failed = error.is_failed;
+    run->error_type = error.type;
+    cwr_interpreter_result_destroy(result);
+    cwr_intepreter_destroy(interpreter);
+    cwr_test_program_destroy(program);
+    return NULL;
+}
+
+// Runs on a thread of 'stack_size' native stack bytes, so nesting on it per node or call shows up as a crash
+static engine_run engine_run_thread(engine_run run, size_t stack_size) {
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, stack_size);
+
+    pthread_t thread;
+    pthread_create(&thread, &attributes, engine_run_source, &run);
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attributes);
+    return run;
+}
+
+static engine_run engine_run_small(char* source, cwr_interpreter_engine_type engine) {
+    return engine_run_thread((engine_run){.source = source, .engine = engine}, 256 * 1024);
+}
+
+// Both engines print the same, fail the same way and return the same value
+static void check_same_run(char* source, size_t stack_size) {
+    engine_run tree = engine_run_thread((engine_run){.source = source, .engine = cwr_interpreter_engine_tree_type, .is_capturing = true}, stack_size);
+    engine_run bytecode = engine_run_thread((engine_run){.source = source, .engine = cwr_interpreter_engine_bytecode_type, .is_capturing = true}, stack_size);
+
+    // Every script prints, so an empty output is a capture that failed
+    CWR_TEST_CHECK(tree.output && tree.output[0] != '\0');
+    CWR_TEST_CHECK(tree.output && bytecode.output && strcmp(tree.output, bytecode.output) == 0);
+    CWR_TEST_CHECK(tree.is_failed == bytecode.is_failed);
+    CWR_TEST_CHECK(tree.is_failed ? tree.error_type == bytecode.error_type : tree.value == bytecode.value);
+    free(tree.output);
+    free(bytecode.output);
+}
+
+// "int main() { int y = 1; int x = <head><y><separator>...<y>; return x; }" with 'count' operands
+static char* engine_chain(const char* head, const char* separator, size_t count) {
+    const char* prefix = "int main() { int y = 1; int x = ";
+    const char* suffix = "; return x; }";
+    char* source = malloc(strlen(prefix) + count * (strlen(head) + strlen(separator) + 1) + strlen(suffix) + 1);
+
+    char* end = stpcpy(source, prefix);
+    for (size_t i = 0; i < count; i++) {
+        end = stpcpy(end, head);
+        end = stpcpy(end, "y");
+        if (i + 1 < count) {
+            end = stpcpy(end, separator);
+        }
+    }
+
+    strcpy(end, suffix);
+    return source;
+}
+
+// The tree walker nests per operand, so it gives the value or a stack overflow error but never crashes
+static void check_tree_run(char* source, int value) {
+    engine_run run = engine_run_small(source, cwr_interpreter_engine_tree_type);
+    CWR_TEST_CHECK(run.is_failed ? run.error_type == cwr_interpreter_error_stack_overflow_type : run.value == value);
+}
+
+static void test_deep_chains() {
+    char* sum = engine_chain("", " + ", 200000);
+    engine_run run = engine_run_small(sum, cwr_interpreter_engine_bytecode_type);
+    CWR_TEST_CHECK(!run.is_failed && run.value == 200000);
+    check_tree_run(sum, 200000);
+    free(sum);
+
+    char* short_sum = engine_chain("", " + ", 100);
+    run = engine_run_small(short_sum, cwr_interpreter_engine_tree_type);
+    CWR_TEST_CHECK(!run.is_failed && run.value == 100);
+    free(short_sum);
+
+    // An even count of negations gives 'y' back
+    char* negations = malloc(200000 + 1);
+    memset(negations, '-', 200000);
+    negations[200000] = '\0';
+    char* negation = engine_chain(negations, "", 1);
+    run = engine_run_small(negation, cwr_interpreter_engine_bytecode_type);
+    CWR_TEST_CHECK(!run.is_failed && run.value == 1);
+    check_tree_run(negation, 1);
+    free(negation);
+    free(negations);
+}
+
+// Scripts of both engines are run from the repository root
+static void test_shipped_script() {
+    FILE* file = fopen("tests/script.cwr", "rb");
+    CWR_TEST_CHECK(file != NULL);
+    if (file == NULL) {
+        return;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* source = malloc(size + 1);
+    source[fread(source, 1, size, file)] = '\0';
+    fclose(file);
+
+    check_same_run(source, 8 * 1024 * 1024);
+    free(source);
+}
+
+static void test_same_results() {
+    check_same_run(
+        "#include <stdio.h>\n"
+        "char pick(char* p, int i) { return p[i]; }\n"
+        "float avg(float a, int b) { return (a + b) / 2; }\n"
+        "int twice(int x) { return x * 2 : { if (x > 1) { return 5; } printf(\"small\"); }; }\n"
+        "int main() {\n"
+        "    char* s = \"abc\"; printf(s); printf(pick(s, 2));\n"
+        "    char* t = \"xyz\"; printf(t[1]); printf(t[0] + 1);\n"
+        "    int x = 3; printf(x);\n"
+        "    printf(avg(1, 2)); printf(avg(1.5, 2)); printf(7 / 2 * 2); printf(-2.5 < 0); printf(!x);\n"
+        "    printf(twice(1)); printf(twice(3));\n"
+        "    if (0.5) { printf(\"half\"); }\n"
+        "    for (int i = 0; i < 3; i = i + 1) { int k = i * 10; printf(k); }\n"
+        "    return x + 1;\n"
+        "}\n", 8 * 1024 * 1024);
+
+    // Output before a runtime error is the same too
+    check_same_run(
+        "#include <stdio.h>\n"
+        "int main() { int z = 0; printf(\"before\"); printf(3 / z); printf(\"unreached\"); return 0; }\n", 8 * 1024 * 1024);
+    check_same_run(
+        "#include <stdio.h>\n"
+        "int main() { char* s = \"ab\"; printf(s[0]); printf(s[5]); return 0; }\n", 8 * 1024 * 1024);
+}
+
+// Arguments are evaluated into the callee's frame, calls within them push frames above it
+static void test_call_arguments() {
+    char* source =
+        "#include <stdio.h>\n"
+        "int add(int a, int b) { return a + b; }\n"
+        "int twice(int x) { return add(x, x); }\n"
+        "int depth(int n) { if (n < 1) { return 0; } return depth(n - 1) + 1; }\n"
+        "int pick(int a, int b, int c) { return (a * 100) + (b * 10) + c; }\n"
+        "int main() { printf(add(depth(50), twice(depth(20)))); return pick(add(1, twice(1)), twice(add(1, 1)) - 2, add(pick(0, 0, 1), 0)); }\n";
+
+    cwr_interpreter_engine_type engines[] = {cwr_interpreter_engine_tree_type, cwr_interpreter_engine_bytecode_type};
+    for (size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        engine_run run = engine_run_thread((engine_run){.source = source, .engine = engines[i], .is_capturing = true}, 256 * 1024);
+        CWR_TEST_CHECK(!run.is_failed && run.value == 321);
+        CWR_TEST_CHECK(run.output && strcmp(run.output, "90.000000\n") == 0);
+        free(run.output);
+    }
+}
+
+// Recursion of both engines, a tail call runs in the frame of its caller so it needs no native stack
+static void test_deep_recursion() {
+    check_same_run(
+        "#include <stdio.h>\n"
+        "int depth(int n) { if (n < 1) { return 0; } return depth(n - 1) + 1; }\n"
+        "int main() { printf(depth(1000)); return depth(100); }\n", 8 * 1024 * 1024);
+    check_same_run(
+        "#include <stdio.h>\n"
+        "int count(int n, int s) { if (n < 1) { return s; } return count(n - 1, s + 1); }\n"
+        "int main() { printf(count(1000000, 0)); return 0; }\n", 512 * 1024);
+
+    // Frames of the bytecode engine are on the heap only
+    char* deep = "int depth(int n) { if (n < 1) { return 0; } return depth(n - 1) + 1; }\n"
+                 "int main() { return depth(200000); }\n";
+    engine_run run = engine_run_small(deep, cwr_interpreter_engine_bytecode_type);
+    CWR_TEST_CHECK(!run.is_failed && run.value == 200000);
+    check_tree_run(deep, 200000);
+}
+
+int main() {
+    test_shipped_script();
+    test_same_results();
+    test_call_arguments();
+    test_deep_recursion();
+    test_deep_chains();
+    return cwr_test_failures;
+}
\ No newline at end of file
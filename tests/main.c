@@ -1,9 +1,48 @@
 #include <stdio.h>
 #include <cwr_interpreter.h>
 #include <cwr_parser.h>
+#include <cwr_optimizer.h>
+#include <cwr_cache.h>
+#include <cwr_hash.h>
 #include <cwr_preprocessor.h>
 #include <cwr_lexer.h>
 
+static void run(cwr_parser_result statements) {
+    // Bytecode engine unless the tree walker is asked for
+    cwr_interpreter_configuration configuration = cwr_interpreter_configuration_default();
+    char* engine = getenv("CWR_ENGINE");
+    if (engine && strcmp(engine, "tree") == 0) {
+        configuration.engine = cwr_interpreter_engine_tree_type;
+    }
+
+    char* max_depth = getenv("CWR_MAX_DEPTH");
+    if (max_depth) {
+        configuration.max_depth = strtoull(max_depth, NULL, 10);
+    }
+
+    cwr_interpreter* interpreter = cwr_intepreter_create(statements, &configuration);
+    cwr_interpreter_error error = (cwr_interpreter_error) {
+        .is_failed = false
+    };
+    cwr_interpreter_result result = cwr_intepreter_interpret(interpreter, &error);
+
+    if (error.is_failed) {
+        printf("Interpreter error");
+    }
+    else {  
+        cwr_value* value = cwr_interpreter_evaluate_entry_point(result, &error);
+        if (error.is_failed) {
+            printf("Entry point error");
+        }
+        else { 
+            cwr_value_instance_destroy(result.context.slab, value);
+        }
+    }
+
+    cwr_interpreter_result_destroy(result);
+    cwr_intepreter_destroy(interpreter);
+}
+
 int main() {
     char* source;
     FILE* target = fopen("script.cwr", "rb");
@@ -43,6 +82,28 @@ int main() {
 
     fclose(target);
 
+    // Compiled programs are kept only when a cache directory is given
+    cwr_optimizer_configuration optimizer_configuration = cwr_optimizer_configuration_default();
+    cwr_cache* cache = NULL;
+    size_t key = 0;
+    char* cache_directory = getenv("CWR_CACHE_DIRECTORY");
+
+    if (cache_directory) {
+        cache = cwr_cache_create(cache_directory);
+        key = cwr_cache_key("console", source, strlen(source));
+        key = cwr_hash_continue(key, &optimizer_configuration, sizeof(optimizer_configuration));
+    }
+
+    cwr_parser_result statements;
+    if (cache && cwr_cache_load(cache, key, &statements)) {
+        free(source);
+        cwr_cache_destroy(cache);
+
+        run(statements);
+        cwr_parser_result_destroy(statements);
+        return 0;
+    }
+
     cwr_lexer_configuration configuration = cwr_lexer_configuration_default();
     cwr_lexer* lexer = cwr_lexer_create("console", source, &configuration);
     cwr_tokens_list tokens_list = cwr_lexer_tokenize(lexer);
@@ -57,6 +118,7 @@ int main() {
 
         cwr_tokens_list_destroy(tokens_list);
         cwr_lexer_destroy(lexer);
+        cwr_cache_destroy(cache);
         return -1;
     }
 
@@ -66,8 +128,9 @@ int main() {
         printf(tokens_list.tokens[i].value);
     }
 
-    cwr_parser* parser = cwr_parser_create(tokens_list);
-    cwr_parser_result statements = cwr_parser_parse(parser);
+    cwr_parser_configuration parser_configuration = cwr_parser_configuration_default();
+    cwr_parser* parser = cwr_parser_create(tokens_list, &parser_configuration);
+    statements = cwr_parser_parse(parser);
 
     if (statements.is_failed) {
         printf("Parser error");
@@ -79,35 +142,24 @@ int main() {
         
         cwr_parser_result_destroy(statements);
         cwr_parser_destroy(parser);
+        cwr_cache_destroy(cache);
         return -1;
     }
 
-    cwr_interpreter* interpreter = cwr_intepreter_create(statements);
-    cwr_interpreter_error error = (cwr_interpreter_error) {
-        .is_failed = false
-    };
-    cwr_interpreter_result result = cwr_intepreter_interpret(interpreter, &error);
+    cwr_optimizer_optimize(&statements, &optimizer_configuration);
 
-    if (error.is_failed) {
-        printf("Interpreter error");
-    }
-    else {  
-        cwr_value* value = cwr_interpreter_evaluate_entry_point(result, &error);
-        if (error.is_failed) {
-            printf("Entry point error");
-        }
-        else { 
-            cwr_value_instance_destroy(value);
-        }
+    if (cache) {
+        cwr_cache_store(cache, key, &statements);
+        cwr_cache_destroy(cache);
     }
 
-    cwr_interpreter_result_destroy(result);
+    run(statements);
+
     cwr_tokens_list_destroy(tokens_list);
     cwr_parser_result_destroy(statements);
 
     cwr_lexer_destroy(lexer);
     cwr_preprocessor_destroy(preprocessor);
     cwr_parser_destroy(parser);
-    cwr_intepreter_destroy(interpreter);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include "cwr_test.h"
+
+static const size_t thread_counts[] = {2, 4, 7, 64};
+
+typedef struct parallel_trees {
+    const cwr_expression_pool* left;
+    const cwr_expression_pool* right;
+} parallel_trees;
+
+static bool same_name(const char* left, const char* right) {
+    return left == right || (left && right && strcmp(left, right) == 0);
+}
+
+// Pools of both trees may lay their expressions out differently, so they are compared by what they hold
+static bool same_expression(parallel_trees trees, cwr_expression_index left_index, cwr_expression_index right_index) {
+    if (left_index == CWR_EXPRESSION_INDEX_NONE || right_index == CWR_EXPRESSION_INDEX_NONE) {
+        return left_index == right_index;
+    }
+
+    const cwr_expression* left = cwr_expression_pool_get(trees.left, left_index);
+    const cwr_expression* right = cwr_expression_pool_get(trees.right, right_index);
+    if (left->type != right->type ||
+        cwr_expression_pool_type(trees.left, left_index) != cwr_expression_pool_type(trees.right, right_index) ||
+        cwr_expression_pool_location(trees.left, left_index).position != cwr_expression_pool_location(trees.right, right_index).position ||
+        !same_name(cwr_expression_pool_name(trees.left, left_index), cwr_expression_pool_name(trees.right, right_index))) {
+        return false;
+    }
+
+    switch (left->type) {
+    case cwr_expression_var_type:
+        return left->var.identifier == right->var.identifier;
+    case cwr_expression_float_type:
+        return memcmp(&left->float_n.value, &right->float_n.value, sizeof(float)) == 0;
+    case cwr_expression_integer_type:
+        return left->integer_n.value == right->integer_n.value;
+    case cwr_expression_character_type:
+        return left->character.value == right->character.value;
+    case cwr_expression_string_type:
+        return left->string.length == right->string.length &&
+            memcmp(cwr_expression_pool_string(trees.left, left->string), cwr_expression_pool_string(trees.right, right->string), left->string.length) == 0;
+    case cwr_expression_func_call_type:
+        if (left->func_call.identifier != right->func_call.identifier || left->func_call.count != right->func_call.count) {
+            return false;
+        }
+
+        for (size_t i = 0; i < left->func_call.count; i++) {
+            if (!same_expression(trees,
+                    cwr_expression_pool_argument(trees.left, left->func_call.arguments, i),
+                    cwr_expression_pool_argument(trees.right, right->func_call.arguments, i))) {
+                return false;
+            }
+        }
+
+        return true;
+    case cwr_expression_unary_type:
+        return left->unary.type == right->unary.type && left->unary.kernel == right->unary.kernel &&
+            same_expression(trees, left->unary.child, right->unary.child);
+    case cwr_expression_binary_type:
+        return left->binary.type == right->binary.type && left->binary.kernel == right->binary.kernel &&
+            same_expression(trees, left->binary.children[0], right->binary.children[0]) &&
+            same_expression(trees, left->binary.children[1], right->binary.children[1]);
+    case cwr_expression_array_element_type:
+        return same_expression(trees, left->array_element.children[0], right->array_element.children[0]) &&
+            same_expression(trees, left->array_element.children[1], right->array_element.children[1]);
+    }
+
+    return false;
+}
+
+static bool same_call(parallel_trees trees, cwr_func_call_statement left, cwr_func_call_statement right) {
+    if (left.identifier != right.identifier || left.count != right.count) {
+        return false;
+    }
+
+    for (size_t i = 0; i < left.count; i++) {
+        if (!same_expression(trees, cwr_expression_pool_argument(trees.left, left.arguments, i), cwr_expression_pool_argument(trees.right, right.arguments, i))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool same_var_decl(parallel_trees trees, cwr_var_decl_statement left, cwr_var_decl_statement right) {
+    return left.identifier == right.identifier && same_name(left.name, right.name) &&
+        left.value_type == right.value_type && same_expression(trees, left.value, right.value);
+}
+
+static bool same_statement(parallel_trees trees, const cwr_statement* left, const cwr_statement* right);
+
+static bool same_body(parallel_trees trees, cwr_func_body_expression left, cwr_func_body_expression right) {
+    if (left.count != right.count) {
+        return false;
+    }
+
+    for (size_t i = 0; i < left.count; i++) {
+        if (!same_statement(trees, &left.statements[i], &right.statements[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool same_statement(parallel_trees trees, const cwr_statement* left, const cwr_statement* right) {
+    if (left->type != right->type || left->location.position != right->location.position || left->is_block != right->is_block) {
+        return false;
+    }
+
+    switch (left->type) {
+    case cwr_statement_func_decl_type: {
+        const cwr_func_decl_statement* a = &left->func_decl;
+        const cwr_func_decl_statement* b = &right->func_decl;
+        if (a->identifier != b->identifier || !same_name(a->name, b->name) || a->count != b->count ||
+            a->with_body != b->with_body || a->return_type != b->return_type ||
+            a->frame_size != b->frame_size || a->is_lazy != b->is_lazy) {
+            return false;
+        }
+
+        for (size_t i = 0; i < a->count; i++) {
+            if (a->arguments[i].identifier != b->arguments[i].identifier ||
+                !same_name(a->arguments[i].name, b->arguments[i].name) || a->arguments[i].type != b->arguments[i].type) {
+                return false;
+            }
+        }
+
+        return same_body(trees, a->func_body, b->func_body);
+    }
+    case cwr_statement_func_call_type:
+        return same_call(trees, left->func_call, right->func_call);
+    case cwr_statement_var_decl_type:
+        return same_var_decl(trees, left->var_decl, right->var_decl);
+    case cwr_statement_assign_type:
+        return left->assign.is_dereference == right->assign.is_dereference &&
+            same_expression(trees, left->assign.identifier, right->assign.identifier) &&
+            same_expression(trees, left->assign.value, right->assign.value);
+    case cwr_statement_for_loop_type: {
+        const cwr_for_loop_statement* a = &left->for_loop;
+        const cwr_for_loop_statement* b = &right->for_loop;
+        return a->with_variable == b->with_variable && a->with_condition == b->with_condition &&
+            a->with_statement == b->with_statement && a->with_body == b->with_body &&
+            (!a->with_variable || same_var_decl(trees, a->variable, b->variable)) &&
+            (!a->with_condition || same_expression(trees, a->condition, b->condition)) &&
+            (!a->with_statement || same_statement(trees, a->statement, b->statement)) &&
+            (!a->with_body || same_body(trees, a->body, b->body));
+    }
+    case cwr_statement_if_type:
+        return same_expression(trees, left->if_stat.condition, right->if_stat.condition) &&
+            same_body(trees, left->if_stat.body, right->if_stat.body);
+    case cwr_statement_return_type:
+        return left->ret.with_body == right->ret.with_body && left->ret.is_tail_call == right->ret.is_tail_call &&
+            (left->ret.with_body ? same_body(trees, left->ret.body, right->ret.body) : same_expression(trees, left->ret.value, right->ret.value));
+    default:
+        return true;
+    }
+}
+
+static bool same_result(cwr_parser_result left, cwr_parser_result right) {
+    parallel_trees trees = {.left = left.nodes_list.pool, .right = right.nodes_list.pool};
+    if (left.nodes_list.count != right.nodes_list.count || left.functions_count != right.functions_count ||
+        left.global_variables_count != right.global_variables_count) {
+        return false;
+    }
+
+    for (size_t i = 0; i < left.nodes_list.count; i++) {
+        if (!same_statement(trees, &left.nodes_list.statements[i], &right.nodes_list.statements[i])) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < left.functions_count; i++) {
+        if (left.functions[i].identifier != right.functions[i].identifier || !same_name(left.functions[i].name, right.functions[i].name) ||
+            left.functions[i].count != right.functions[i].count || left.functions[i].return_type != right.functions[i].return_type) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < left.global_variables_count; i++) {
+        if (left.global_variables[i].identifier != right.global_variables[i].identifier ||
+            !same_name(left.global_variables[i].name, right.global_variables[i].name) ||
+            left.global_variables[i].type != right.global_variables[i].type ||
+            !same_expression(trees, left.global_variables[i].static_value, right.global_variables[i].static_value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static cwr_test_program parallel_parse(char* source, size_t threads) {
+    cwr_parser_configuration configuration = cwr_parser_configuration_default();
+    configuration.threads = threads;
+    return cwr_test_parse(source, configuration);
+}
+
+static void test_same_tree() {
+    char* source = cwr_test_functions_source(3000, NULL);
+    cwr_test_program expected = parallel_parse(source, 1);
+    CWR_TEST_CHECK(!expected.result.is_failed);
+
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        cwr_test_program program = parallel_parse(source, thread_counts[i]);
+        CWR_TEST_CHECK(!program.result.is_failed);
+        CWR_TEST_CHECK(same_result(expected.result, program.result));
+        cwr_test_program_destroy(program);
+    }
+
+    // One more statement in one body is told apart
+    char* changed_source = cwr_test_functions_source(3000, "n = n + 1;");
+    cwr_test_program changed = parallel_parse(changed_source, 4);
+    CWR_TEST_CHECK(!changed.result.is_failed);
+    CWR_TEST_CHECK(!same_result(expected.result, changed.result));
+    cwr_test_program_destroy(changed);
+    free(changed_source);
+
+    cwr_test_program_destroy(expected);
+    free(source);
+}
+
+// An error in a body is the one the single thread parse reports, whichever thread finds it
+static void test_same_error() {
+    char* source = cwr_test_functions_source(3000, "int u = zz;");
+    cwr_test_program expected = parallel_parse(source, 1);
+    CWR_TEST_CHECK(expected.result.is_failed);
+
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        cwr_test_program program = parallel_parse(source, thread_counts[i]);
+        CWR_TEST_CHECK(program.result.is_failed);
+        CWR_TEST_CHECK(program.result.error.error_type == expected.result.error.error_type);
+        CWR_TEST_CHECK(strcmp(program.result.error.message, expected.result.error.message) == 0);
+        CWR_TEST_CHECK(program.result.error.location.position == expected.result.error.location.position);
+        cwr_test_program_destroy(program);
+    }
+
+    cwr_test_program_destroy(expected);
+    free(source);
+}
+
+int main() {
+    test_same_tree();
+    test_same_error();
+    return cwr_test_failures;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include "cwr_test.h"
+
+typedef struct parser_error_case {
+    char* source;
+    cwr_parser_error_type type;
+    char* message;
+    size_t position;
+} parser_error_case;
+
+// Errors and positions of the recursive parser, a right operand of a binary operator reports any failure as an incorrect type
+static const parser_error_case error_cases[] = {
+    {"int main() { int x = 1; int y = x + zz; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 39},
+    {"int main() { int x = 1; int y = x + -zz; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 40},
+    {"int main() { int x = 1; int y = x + !zz; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 40},
+    {"int main() { int x = 1; int y = x + x[zz]; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 41},
+    {"int g(int a) { return a; } int main() { int x = 1; int y = x + g(1, 2); return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 71},
+    {"int main() { int x = 1; int y = x + ; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 45},
+    {"int main() { int x = 1; int y = x + (1; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 39},
+    {"int main() { int x = 1; int y = x + h(1); return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 41},
+    {"int main() { int x = 1; int y = x + \"s\"; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 40},
+    {"int main() { int x = 1; int y = x + 1 +; return 0; }", cwr_parser_error_incorrect_type_type, "Incorrect type", 48},
+    {"int main() { int x = 1; int y = -zz; return 0; }", cwr_parser_error_unknown_variable_type, "Unknown variable", 36},
+    {"int main() { int x = 1; int y = x[zz]; return 0; }", cwr_parser_error_unknown_variable_type, "Unknown variable", 37},
+    {"int main() { int x = 1; int y = zz + x; return 0; }", cwr_parser_error_unknown_variable_type, "Unknown variable", 35},
+};
+
+static void test_errors() {
+    for (size_t i = 0; i < sizeof(error_cases) / sizeof(error_cases[0]); i++) {
+        parser_error_case error_case = error_cases[i];
+        cwr_test_program program = cwr_test_parse(error_case.source, cwr_parser_configuration_default());
+
+        CWR_TEST_CHECK(program.result.is_failed);
+        if (program.result.is_failed) {
+            CWR_TEST_CHECK(program.result.error.error_type == error_case.type);
+            CWR_TEST_CHECK(strcmp(program.result.error.message, error_case.message) == 0);
+            CWR_TEST_CHECK(program.result.error.location.position == error_case.position);
+        }
+
+        cwr_test_program_destroy(program);
+    }
+}
+
+// Nesting lives on the parser's heap stacks, so it is bound by memory and not by the C stack
+static void test_deep_nesting() {
+    size_t depth = 200000;
+    const char* head = "int main() { int x = ";
+    const char* tail = "; return x; }";
+    char* source = malloc(strlen(head) + 2 * depth + 2 + strlen(tail));
+
+    char* end = stpcpy(source, head);
+    memset(end, '(', depth);
+    end += depth;
+    *end++ = '1';
+    memset(end, ')', depth);
+    end += depth;
+    strcpy(end, tail);
+
+    cwr_test_program program = cwr_test_parse(source, cwr_parser_configuration_default());
+    CWR_TEST_CHECK(!program.result.is_failed);
+    cwr_test_program_destroy(program);
+    free(source);
+}
+
+// Children, names and types are kept out of line, so an expression stays two words long
+static void test_expression_size() {
+    CWR_TEST_CHECK(sizeof(cwr_expression) == 16);
+}
+
+int main() {
+    test_errors();
+    test_deep_nesting();
+    test_expression_size();
+    return cwr_test_failures;
+}
\ No newline at end of file
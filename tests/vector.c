@@ -0,0 +1,100 @@
+#include <stdlib.h>
+#include <cwr_vector.h>
+#include "cwr_test.h"
+
+static void test_growth() {
+    int* buffer = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 1));
+    CWR_TEST_CHECK(size == CWR_VECTOR_DEFAULT_SIZE);
+
+    // Doubles only once the used elements no longer fit, keeping them
+    size_t reallocations = 0;
+    for (int i = 0; i < 100000; i++) {
+        size_t previous = size;
+        CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 1));
+        CWR_TEST_CHECK(size == previous || size == previous * 2);
+        reallocations += size != previous;
+        buffer[capacity++] = i;
+    }
+
+    CWR_TEST_CHECK(size == 131072);
+    CWR_TEST_CHECK(reallocations == 14);
+    for (int i = 0; i < 100000; i++) {
+        CWR_TEST_CHECK(buffer[i] == i);
+    }
+
+    // A large request jumps straight to the first fitting power of two
+    CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 500000));
+    CWR_TEST_CHECK(size == 1048576);
+
+    CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 0));
+    CWR_TEST_CHECK(size == 1048576);
+    free(buffer);
+}
+
+static void test_trim() {
+    int* buffer = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    // Nothing used keeps the buffer as it is
+    CWR_VECTOR_TRIM(buffer, size, capacity);
+    CWR_TEST_CHECK(buffer == NULL && size == 0);
+
+    CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 20));
+    for (int i = 0; i < 20; i++) {
+        buffer[capacity++] = i;
+    }
+
+    CWR_VECTOR_TRIM(buffer, size, capacity);
+    CWR_TEST_CHECK(size == 20);
+    for (int i = 0; i < 20; i++) {
+        CWR_TEST_CHECK(buffer[i] == i);
+    }
+
+    CWR_VECTOR_TRIM(buffer, size, capacity);
+    CWR_TEST_CHECK(size == 20);
+
+    // Growing again after a trim doubles from the trimmed size
+    CWR_TEST_CHECK(CWR_VECTOR_RESERVE(buffer, size, capacity, 1));
+    CWR_TEST_CHECK(size == 40);
+    free(buffer);
+}
+
+// The expression pool grows while parsing and is trimmed to what is used once the result is made
+static void test_parsed_pool() {
+    size_t calls = 10000;
+    const char* head = "void f(int a) { } int main() { ";
+    const char* call = "f(1); ";
+    const char* tail = "return 0; }";
+    char* source = malloc(strlen(head) + calls * strlen(call) + strlen(tail) + 1);
+
+    char* end = stpcpy(source, head);
+    for (size_t i = 0; i < calls; i++) {
+        end = stpcpy(end, call);
+    }
+
+    strcpy(end, tail);
+
+    cwr_test_program program = cwr_test_parse(source, cwr_parser_configuration_default());
+    CWR_TEST_CHECK(!program.result.is_failed);
+    if (!program.result.is_failed) {
+        cwr_expression_pool* pool = program.result.nodes_list.pool;
+        CWR_TEST_CHECK(pool->count >= calls);
+        CWR_TEST_CHECK(pool->capacity == pool->count);
+        CWR_TEST_CHECK(pool->indices_capacity == pool->indices_count);
+    }
+
+    cwr_test_program_destroy(program);
+    free(source);
+}
+
+int main() {
+    test_growth();
+    test_trim();
+    test_parsed_pool();
+    return cwr_test_failures;
+}
\ No newline at end of file